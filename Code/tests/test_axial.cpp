@@ -0,0 +1,129 @@
+// vc_axial.hpp and vc_radial.hpp against hand-computed cases and the scalar
+// models.
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_axial.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Planar strip with a wall too thin to spread: the wall rise is q / h under
+// the source and zero beyond it, so every field has a closed form. Half the
+// plate (L = vc_length / 2, width W) carries Q_in / 2; the source covers
+// x < a = evap_length / 2. Per watt of Q_in, with evaporation q = 1 / (2 a W)
+// under the source and condensation s = 1 / (2 L W) everywhere, the return
+// flow per unit width is
+//
+//   F(x) / W = (q - s) x / h_fg              for x < a
+//              (q a - s x) / h_fg            beyond
+//
+// and the center demand is the integral of F / W times the flow resistances.
+void checkThinWallStrip() {
+    vc::DesignInputs<double> d;
+    d.t_evap_wall = 1e-9;
+    d.Q_in = 40;
+    vc::DesignBatch<double> in;
+    in.push_back(d);
+    vc::OutputBatch<double> out;
+    vc::evaluateBatch(in, out);
+    vc::AxialOptions opt;
+    opt.cells = 70;   // 0.5 mm cells: the source edge x = 10 mm is a face
+    const vc::AxialBatchResult res = vc::solveAxialBatch(in, out, opt);
+
+    const vc::FluidProperties fluid;
+    const vc::ModelOutputs<double> o = out.get(0);
+    const double L = d.vc_length / 2;
+    const double a = d.evap_length / 2;
+    const double W = d.vc_width;
+    const double q = 1 / (2 * a * W);   // [W/m^2 per W]
+    const double s = 1 / (2 * L * W);
+    const double h = 1 / (d.t_evap_wall / (2 * d.k_shell) + o.t_evap_wick / o.k_wick_evap);
+
+    // Return flow per unit width, F(x) / W [kg/s-m per W]; integrals of F / W over each zone
+    const double under = (q - s) * a * a / 2 / fluid.h_fg;
+    const double beyond = (q * a * (L - a) - s * (L * L - a * a) / 2) / fluid.h_fg;
+    const double R_evap = fluid.mu_l / (fluid.rho_l * o.K_evap * o.t_evap_wick);
+    const double R_both = fluid.mu_l / (fluid.rho_l * (o.K_evap * o.t_evap_wick + o.K_cond * o.t_cond_wick));
+    const double R_v = 48 * fluid.mu_v / (fluid.rho_v * d.t_vapor * o.d_h_vapor * o.d_h_vapor);
+    const double liquid = under * R_evap + beyond * R_both;   // [Pa per W]
+    const double vapor = (under + beyond) * R_v;
+
+    VC_CHECK_NEAR(res.theta_peak[0], d.Q_in * q / h, 1e-6 * d.Q_in * q / h);
+    VC_CHECK_NEAR(res.demand_peak[0], d.Q_in * (liquid + vapor), 1e-3 * d.Q_in * (liquid + vapor));
+    VC_CHECK_NEAR(res.Q_max[0], o.dP_cap / (liquid + vapor), 1e-3 * o.dP_cap / (liquid + vapor));
+    VC_CHECK(res.dryout_x[0] == 0);
+
+    // Mass flux: q / h_fg under the source (first cell), -s / h_fg at the edge
+    VC_CHECK_NEAR(res.mass_flux[res.at(0, 0)], d.Q_in * (q - s) / fluid.h_fg, 1e-6 * d.Q_in * q / fluid.h_fg);
+    VC_CHECK_NEAR(res.mass_flux[res.at(opt.cells - 1, 0)], -d.Q_in * s / fluid.h_fg, 1e-6 * d.Q_in * q / fluid.h_fg);
+}
+
+// Radial lanes with evaporation under the source against the closed form of
+// vc_radial.hpp, and the WallFin default above it.
+void checkRadialClosedForm() {
+    vc::DesignInputs<double> d;
+    d.phi_deg = 30;
+    vc::DesignBatch<double> in;
+    in.push_back(d);
+    vc::OutputBatch<double> out;
+    vc::evaluateBatch(in, out);
+    const std::vector<vc::FlowGeometry> disk{vc::FlowGeometry::Radial};
+    vc::AxialOptions opt;
+    opt.cells = 256;
+    opt.evaporation = vc::AxialEvaporation::UnderSource;
+    const vc::AxialBatchResult res = vc::solveAxialBatch(in, out, disk, opt);
+    const vc::ModelOutputs<double> closed = vc::evaluateRadialModel(d);
+
+    VC_CHECK_NEAR(res.Q_max[0], closed.Q_max, 2e-3 * closed.Q_max);
+    VC_CHECK_NEAR(res.demand_peak[0], closed.dP_total, 2e-3 * closed.dP_total);
+    VC_CHECK_NEAR(res.R_evap_spreading[0], closed.R_evap_spreading, 1e-3 * std::fabs(closed.R_evap_spreading));
+
+    opt.evaporation = vc::AxialEvaporation::WallFin;
+    const vc::AxialBatchResult fin = vc::solveAxialBatch(in, out, disk, opt);
+    VC_CHECK(fin.Q_max[0] > 4 * closed.Q_max);
+    VC_CHECK_NEAR(fin.R_evap_spreading[0], res.R_evap_spreading[0], 1e-12);
+
+    // Spreading lowers the resistance, and vanishes with the in-plane conduction
+    VC_CHECK(closed.R_evap_spreading < 0);
+    VC_CHECK_NEAR(vc::radialSpreadingResistance(1e-9, 2500, 0.01, 0.04), 0.0, 1e-4 / (2500 * M_PI * 1e-4));
+}
+
+// Mixed-geometry batch against the scalar models, lane by lane: planar runs,
+// packs with both kinds, and a remainder shorter than kBatchLanes.
+void checkMixedGeometryBatch() {
+    vc::DesignBatch<double> in;
+    std::vector<vc::FlowGeometry> geometry;
+    const std::size_t n = 5 * vc::kBatchLanes + 3;
+    for (std::size_t i = 0; i < n; ++i) {
+        vc::DesignInputs<double> d;
+        d.Q_in = 20 + 7.0 * i;
+        d.phi_deg = -30 + 4.0 * i;
+        d.evap_length *= 0.5 + 0.1 * i;
+        d.d_w_evap *= 0.8 + 0.02 * i;
+        in.push_back(d);
+        const bool radial = (i >= 2 * vc::kBatchLanes && i % 3 == 0) || i == n - 2;
+        geometry.push_back(radial ? vc::FlowGeometry::Radial : vc::FlowGeometry::Planar);
+    }
+    vc::OutputBatch<double> out;
+    vc::evaluateBatch(in, geometry, out);
+    for (std::size_t i = 0; i < n; ++i) {
+        const vc::ModelOutputs<double> scalar = geometry[i] == vc::FlowGeometry::Radial
+                                                    ? vc::evaluateRadialModel(in.get(i))
+                                                    : vc::evaluateModel(in.get(i));
+#define VC_CHECK_LANE(name) VC_CHECK_NEAR(out.name[i], scalar.name, 1e-14 * std::fabs(scalar.name));
+        VC_OUTPUT_FIELDS(VC_CHECK_LANE)
+#undef VC_CHECK_LANE
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkThinWallStrip();
+    checkRadialClosedForm();
+    checkMixedGeometryBatch();
+    return vc_test::report("test_axial");
+}
@@ -0,0 +1,33 @@
+// vc_batch.hpp: the column-wise double kernel against the scalar model, lane
+// by lane, including a remainder shorter than kBatchLanes.
+
+#include <cmath>
+#include <cstddef>
+
+#include "vc_batch.hpp"
+#include "vc_test.hpp"
+
+int main() {
+    vc::DesignBatch<double> in;
+    const std::size_t n = 4 * vc::kBatchLanes + 3;
+    for (std::size_t i = 0; i < n; ++i) {
+        vc::DesignInputs<double> d;
+        d.Q_in = 20 + 7.0 * i;
+        d.phi_deg = -45 + 5.0 * i;
+        d.d_w_evap *= 0.8 + 0.02 * i;
+        d.t_vapor *= 0.5 + 0.05 * i;
+        d.k_shell = 200 + 10.0 * i;
+        d.num_layers_cond = 1 + i % 6;
+        in.push_back(d);
+    }
+    vc::OutputBatch<double> out;
+    out.resize(n);
+    vc::evaluateBatchRange(in, out, 1, n);   // Unaligned start
+    for (std::size_t i = 1; i < n; ++i) {
+        const vc::ModelOutputs<double> scalar = vc::evaluateModel(in.get(i));
+#define VC_CHECK_LANE(name) VC_CHECK_NEAR(out.name[i], scalar.name, 1e-14 * std::fabs(scalar.name));
+        VC_OUTPUT_FIELDS(VC_CHECK_LANE)
+#undef VC_CHECK_LANE
+    }
+    return vc_test::report("test_batch");
+}
@@ -0,0 +1,114 @@
+// vc_bayes.hpp: the ensemble sampler against a posterior known in closed
+// form, and the streamed predictive band against its exact quantiles.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_bayes.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// R_total_ideal without R_phase_change, for a 1 W load.
+double resistanceWithoutPhaseChange(vc::DesignInputs<double> d) {
+    d.R_phase_change = 0;
+    d.experimental_correction_factor = 1;
+    d.Q_in = 1;
+    return vc::evaluateModel(d).R_total_corrected;
+}
+
+// delta_T = Q (f R_i + f R_pc) is linear in a = f and b = f R_pc:
+// delta_T = Q (a R_i + b). With noise-free plateaus at f = 1.35, R_pc = 0.03
+// and flat priors, the posterior of (a, b) is the least-squares Gaussian,
+// mean (1.35, 0.0405) and covariance sigma^2 (X^T X)^-1 with rows
+// X = (Q R_i, Q). The posterior is narrow, so the prior Jacobian 1 / f
+// between (a, b) and (f, R_pc) does not move it. delta_T does not depend on
+// the Kozeny-Carman constant, so that marginal stays uniform on its prior.
+void checkKnownPosterior() {
+    const double f = 1.35;
+    const double R_pc = 0.03;
+    std::vector<vc::TestRun> runs;
+    double xx = 0;
+    double xy = 0;
+    double yy = 0;
+    for (int i = 0; i < 6; ++i) {
+        vc::TestRun run;
+        run.design.k_shell = 150 + 50.0 * i;
+        run.design.evap_length *= 0.5 + 0.15 * i;
+        const double R_i = resistanceWithoutPhaseChange(run.design);
+        for (double Q : {20.0, 60.0, 120.0}) {
+            run.Q_in.push_back(Q);
+            run.delta_T.push_back(Q * (f * R_i + f * R_pc));
+            xx += Q * R_i * Q * R_i;
+            xy += Q * R_i * Q;
+            yy += Q * Q;
+        }
+        runs.push_back(run);
+    }
+    vc::BayesianOptions opt;
+    opt.sigma_delta_T = 0.5;
+    opt.burn_in = 500;
+    opt.iterations = 3000;
+    opt.seed = 11;
+    const double var = opt.sigma_delta_T * opt.sigma_delta_T;
+    const double det = xx * yy - xy * xy;
+    const double sd_a = std::sqrt(var * yy / det);
+
+    // Target design: predictive delta_T = Q (a R_t + b), a linear function of (a, b)
+    vc::DesignInputs<double> target;
+    target.Q_in = 150;
+    const double R_t = resistanceWithoutPhaseChange(target);
+    const double pred_mean = target.Q_in * f * (R_t + R_pc);
+    const double pred_sd = target.Q_in * std::sqrt(var * (R_t * R_t * yy - 2 * R_t * xy + xx) / det);
+
+    vc::PredictiveBand band;
+    const vc::BayesianResult res = vc::sampleCalibrationPosterior(
+        runs, opt, vc::FluidProperties{}, &target, [&](const vc::PredictiveSample& s) { band.add(s.delta_T); });
+
+    VC_CHECK(res.acceptance_rate > 0.2 && res.acceptance_rate < 0.8);
+    VC_CHECK_NEAR(res.mean[vc::BayesianParameters::CorrectionFactor], f, 0.1 * sd_a);
+    VC_CHECK_NEAR(res.std_dev[vc::BayesianParameters::CorrectionFactor], sd_a, 0.1 * sd_a);
+
+    // 95% credible interval of the factor: f -/+ 1.96 sd
+    vc::PredictiveBand factor;
+    for (const vc::PosteriorSample& s : res.samples) {
+        factor.add(s.theta[vc::BayesianParameters::CorrectionFactor]);
+    }
+    VC_CHECK_NEAR(factor.quantile(0.025), f - 1.96 * sd_a, 0.15 * sd_a);
+    VC_CHECK_NEAR(factor.quantile(0.975), f + 1.96 * sd_a, 0.15 * sd_a);
+
+    // Unidentified Kozeny-Carman constant: uniform on [50, 300]
+    VC_CHECK_NEAR(res.mean[vc::BayesianParameters::KozenyCarman], 175, 10);
+    VC_CHECK_NEAR(res.std_dev[vc::BayesianParameters::KozenyCarman], 250 / std::sqrt(12.0), 6);
+
+    // Posterior-predictive band at the target
+    VC_CHECK(band.size() == res.samples.size());
+    VC_CHECK_NEAR(band.quantile(0.5), pred_mean, 0.1 * pred_sd);
+    VC_CHECK_NEAR(band.quantile(0.025), pred_mean - 1.96 * pred_sd, 0.15 * pred_sd);
+    VC_CHECK_NEAR(band.quantile(0.975), pred_mean + 1.96 * pred_sd, 0.15 * pred_sd);
+}
+
+// The band's quantiles track the exact order statistics of a large stream.
+void checkBandQuantiles() {
+    vc::PredictiveBand band;
+    VC_CHECK(std::isnan(band.quantile(0.5)));
+    const std::size_t n = 200000;
+    for (std::size_t i = 0; i < n; ++i) {
+        band.add(static_cast<double>((i * 7919) % n));   // A permutation of 0 .. n - 1
+    }
+    const vc::PredictiveBand& view = band;
+    VC_CHECK(view.size() == n);
+    for (double p : {0.01, 0.1, 0.5, 0.9, 0.99}) {
+        VC_CHECK_NEAR(view.quantile(p), p * (n - 1), 0.002 * n);
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkKnownPosterior();
+    checkBandQuantiles();
+    return vc_test::report("test_bayes");
+}
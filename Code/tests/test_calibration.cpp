@@ -0,0 +1,100 @@
+// vc_calibration.hpp: recovery of known parameters from synthetic runs, the
+// pooled and per-run default masks, and the pooled fit across thread counts.
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_calibration.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Exact delta_T plateaus of `count` different designs at factor 1.35 and
+// R_phase_change 0.03 K/W.
+std::vector<vc::TestRun> syntheticRuns(std::size_t count) {
+    vc::CalibrationParameters truth;
+    truth[vc::CalibrationParameters::CorrectionFactor] = 1.35;
+    truth[vc::CalibrationParameters::PhaseChange] = 0.03;
+    std::vector<vc::TestRun> runs;
+    for (std::size_t i = 0; i < count; ++i) {
+        vc::TestRun run;
+        run.design.k_shell = 200 + 20.0 * (i % 9);
+        run.design.evap_length *= 0.6 + 0.1 * (i % 7);
+        run.design.evap_width *= 0.6 + 0.1 * (i % 5);
+        run.design.num_layers_evap = 1 + i % 4;
+        run.design.t_evap_wall *= 0.5 + 0.25 * (i % 3);
+        vc::DesignInputs<double> d = run.design;
+        truth.apply(d);
+        for (double Q : {20.0, 60.0, 120.0, 200.0}) {
+            d.Q_in = Q;
+            run.Q_in.push_back(Q);
+            run.delta_T.push_back(vc::evaluateModel(d).delta_T);
+        }
+        runs.push_back(run);
+    }
+    return runs;
+}
+
+void checkPooledRecovery() {
+    const std::vector<vc::TestRun> runs = syntheticRuns(12);
+    vc::CalibrationOptions opt;
+    opt.max_iterations = 200;
+    // Default options fit mask 3: the correction factor and R_phase_change
+    const vc::CalibrationResult fit = vc::calibratePooled(runs, opt);
+    VC_CHECK(fit.converged);
+    VC_CHECK_NEAR(fit.params[vc::CalibrationParameters::CorrectionFactor], 1.35, 1e-7);
+    VC_CHECK_NEAR(fit.params[vc::CalibrationParameters::PhaseChange], 0.03, 1e-8);
+    VC_CHECK_NEAR(fit.params[vc::CalibrationParameters::WickMultiplier], 1.0, 0.0);
+    VC_CHECK(fit.rms_residual < 1e-8);
+
+    opt.fit_mask = 3;
+    const vc::CalibrationResult explicit_mask = vc::calibratePooled(runs, opt);
+    VC_CHECK(explicit_mask.params.value == fit.params.value);
+
+    // The factor alone cannot absorb R_phase_change across designs
+    opt.fit_mask = 1u << vc::CalibrationParameters::CorrectionFactor;
+    VC_CHECK(vc::calibratePooled(runs, opt).rms_residual > 1e-3);
+}
+
+// Per run, the default fits the factor alone; it matches each run's plateaus.
+void checkPerRunDefault() {
+    const std::vector<vc::TestRun> runs = syntheticRuns(5);
+    const std::vector<vc::CalibrationResult> fits = vc::calibrateRuns(runs);
+    for (std::size_t r = 0; r < runs.size(); ++r) {
+        VC_CHECK(fits[r].converged);
+        VC_CHECK(fits[r].rms_residual < 1e-8);
+        VC_CHECK(fits[r].params[vc::CalibrationParameters::PhaseChange] == 0.01);
+        VC_CHECK(fits[r].std_error[vc::CalibrationParameters::PhaseChange] == 0);
+    }
+}
+
+// Enough runs for several blocks: identical parameters for 1 and N workers.
+void checkThreadCountIndependence() {
+    std::vector<vc::TestRun> runs = syntheticRuns(300);
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        for (double& t : runs[i].delta_T) {
+            t *= 1 + 1e-3 * std::sin(1.7 * i + t);   // Noise, so the sums round differently by order
+        }
+    }
+    vc::setWorkerCount(1);
+    const vc::CalibrationResult one = vc::calibratePooled(runs);
+    for (unsigned workers : {2u, 3u, 5u}) {
+        vc::setWorkerCount(workers);
+        const vc::CalibrationResult many = vc::calibratePooled(runs);
+        VC_CHECK(many.params.value == one.params.value);
+        VC_CHECK(many.std_error == one.std_error);
+        VC_CHECK(many.rms_residual == one.rms_residual);
+        VC_CHECK(many.iterations == one.iterations);
+    }
+    vc::setWorkerCount(0);
+}
+
+}  // namespace
+
+int main() {
+    checkPooledRecovery();
+    checkPerRunDefault();
+    checkThreadCountIndependence();
+    return vc_test::report("test_calibration");
+}
@@ -0,0 +1,73 @@
+// vc_csv_stream.hpp: quoted fields, a header requested twice, rows split
+// across chunks, fields with trailing text left NaN, and plateaus from a
+// synthetic two-step log.
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "vc_csv_stream.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+void writeFile(const std::string& path, const std::string& text) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    std::fwrite(text.data(), 1, text.size(), f);
+    std::fclose(f);
+}
+
+void checkFields(const std::string& path) {
+    writeFile(path, "\"time_s\", \"power_W\",TC1,TC2\r\n"
+                    "\"0.5\",\"10\", 40.25 ,\" 30\"\r\n"
+                    "1.5,,x,31\n"
+                    "2.5,12.5abc,\"1.0 K\",-3e1\n");
+    std::vector<std::vector<double>> rows;
+    vc::CsvStreamReader reader(path, 7);   // Smaller than a line: every row is carried across chunks
+    reader.forEachRow({"TC1", "time_s", "TC1", "power_W", "TC2"},
+                      [&](const std::vector<double>& v) { rows.push_back(v); });
+    VC_CHECK(rows.size() == 3);
+    if (rows.size() == 3) {
+        VC_CHECK(rows[0] == (std::vector<double>{40.25, 0.5, 40.25, 10, 30}));
+        VC_CHECK(std::isnan(rows[1][0]) && std::isnan(rows[1][2]) && std::isnan(rows[1][3]));
+        VC_CHECK(rows[1][1] == 1.5 && rows[1][4] == 31);
+        // A numeric prefix is not a number
+        VC_CHECK(std::isnan(rows[2][0]) && std::isnan(rows[2][2]) && std::isnan(rows[2][3]));
+        VC_CHECK(rows[2][1] == 2.5 && rows[2][4] == -30);
+    }
+}
+
+// Two 10-minute power steps at 1 Hz, the hot channel 5 K then 8 K above the
+// reference, which is listed as both hot and cold.
+void checkPlateaus(const std::string& path) {
+    std::string text = "time_s,power_W,TC_hot,TC_ref\n";
+    char line[96];
+    for (int t = 0; t < 1200; ++t) {
+        const bool second = t >= 600;
+        std::snprintf(line, sizeof(line), "%d,\"%g\",\"%g\",%g\n", t, second ? 40.0 : 20.0, second ? 33.0 : 30.0,
+                      25.0);
+        text += line;
+    }
+    writeFile(path, text);
+    vc::ThermocoupleColumns cols;
+    cols.hot = {"TC_hot", "TC_ref"};
+    cols.cold = {"TC_ref"};
+    const std::vector<vc::SteadyPlateau> p = vc::extractSteadyPlateaus(path, cols);
+    VC_CHECK(p.size() == 2);
+    if (p.size() == 2) {
+        VC_CHECK(p[0].Q_in == 20 && p[1].Q_in == 40);
+        VC_CHECK_NEAR(p[0].delta_T, 2.5, 1e-12);   // (30 + 25) / 2 - 25
+        VC_CHECK_NEAR(p[1].delta_T, 4.0, 1e-12);
+    }
+}
+
+}  // namespace
+
+int main() {
+    const std::string path = "test_csv_stream.csv";
+    checkFields(path);
+    checkPlateaus(path);
+    std::remove(path.c_str());
+    return vc_test::report("test_csv_stream");
+}
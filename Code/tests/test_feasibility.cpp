@@ -0,0 +1,68 @@
+// vc_feasibility.hpp: every traced boundary point lies on dP_cap == dP_total
+// (within the finest cell's interpolation error), the 2D trace spans the whole
+// box, and both traces cost far fewer model calls than the uniform grid.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "vc_feasibility.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Worst |dP_cap - dP_total| / dP_cap over the traced points, re-evaluated.
+double worstMismatch(const vc::FeasibilityBoundaryOptions& opt, const vc::FeasibilityBoundary& b) {
+    double worst = 0;
+    for (const std::array<double, 3>& p : b.points) {
+        vc::DesignInputs<double> d;
+        for (std::size_t a = 0; a < opt.axes.size(); ++a) {
+            d.*vc::designField(opt.axes[a].name) = p[a];
+        }
+        const vc::ModelOutputs<double> o = vc::evaluateModel(d);
+        worst = std::max(worst, std::fabs(o.dP_cap - o.dP_total) / o.dP_cap);
+    }
+    return worst;
+}
+
+// Q_max falls from ~5600 W to ~750 W across the mesh range, so the limit is one
+// curve from the left edge to the right.
+void checkPlane() {
+    vc::FeasibilityBoundaryOptions opt;
+    opt.axes = {{"mesh_number_evap_wpi", 100, 300}, {"Q_in", 500, 6000}};
+    const vc::FeasibilityBoundary b = vc::refineCapillaryBoundary(vc::DesignInputs<double>{}, opt);
+    VC_CHECK(b.dims == 2);
+    VC_CHECK(b.points.size() % 2 == 0 && b.boundary_cells > 0);
+    VC_CHECK(worstMismatch(opt, b) < 1e-3);
+    double lo = 1e300;
+    double hi = -1e300;
+    for (const std::array<double, 3>& p : b.points) {
+        lo = std::min(lo, p[0]);
+        hi = std::max(hi, p[0]);
+    }
+    VC_CHECK(lo == 100 && hi == 300);
+    VC_CHECK(b.uniform_grid_calls == 257 * 257);
+    VC_CHECK(b.model_calls * 10 < b.uniform_grid_calls);
+}
+
+void checkVolume() {
+    vc::FeasibilityBoundaryOptions opt;
+    opt.axes = {{"mesh_number_evap_wpi", 100, 300}, {"Q_in", 500, 6000}, {"d_w_evap", 40e-6, 60e-6}};
+    opt.coarse_cells = 4;
+    opt.max_level = 4;
+    const vc::FeasibilityBoundary b = vc::refineCapillaryBoundary(vc::DesignInputs<double>{}, opt);
+    VC_CHECK(b.dims == 3);
+    VC_CHECK(b.points.size() % 3 == 0 && b.boundary_cells > 0);
+    VC_CHECK(worstMismatch(opt, b) < 1e-2);
+    VC_CHECK(b.uniform_grid_calls == 65 * 65 * 65);
+    VC_CHECK(b.model_calls * 5 < b.uniform_grid_calls);
+}
+
+}  // namespace
+
+int main() {
+    checkPlane();
+    checkVolume();
+    return vc_test::report("test_feasibility");
+}
@@ -0,0 +1,139 @@
+// vc_interval.hpp: outward rounding, enclosure soundness on sampled points,
+// the packed batch against the scalar interval model, and whole-valued
+// midpoints and splits of integer inputs.
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+
+#include "vc_interval.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+bool sameDouble(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || (a == b && std::signbit(a) == std::signbit(b));
+}
+
+void checkRounding() {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double values[] = {0.0, -0.0, 1.0, -1.0, 0.1, -3e300,
+                             std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::denorm_min(),
+                             std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(),
+                             std::numeric_limits<double>::min(), inf, -inf, std::nan("")};
+    for (const double x : values) {
+        VC_CHECK(sameDouble(vc::roundDown(x), std::nextafter(x, -inf)));
+        VC_CHECK(sameDouble(vc::roundUp(x), std::nextafter(x, inf)));
+    }
+}
+
+vc::DesignInputs<vc::Interval> toleranceBox() {
+    vc::DesignInputs<vc::Interval> box = vc::pointBox(vc::DesignInputs<double>{});
+    box.Q_in = {50, 150};
+    box.phi_deg = {-30, 60};
+    box.d_w_evap = {0.9 * 0.000051, 1.1 * 0.000051};
+    box.t_vapor = {0.8 * box.t_vapor.lo, 1.2 * box.t_vapor.hi};
+    box.k_shell = {300, 400};
+    box.evap_length = {0.9 * box.evap_length.lo, 1.1 * box.evap_length.hi};
+    box.num_layers_evap = {2, 6};
+    box.mesh_number_cond_wpi = {60, 100};
+    return box;
+}
+
+// Random points of the box (integer inputs at whole values) evaluated by the
+// double model all lie inside the interval enclosures, for the box and for
+// both halves of a bisection.
+void checkEnclosureSoundness() {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> unit(0, 1);
+    vc::DesignInputs<vc::Interval> halves[2];
+    const vc::DesignInputs<vc::Interval> box = toleranceBox();
+    vc::bisectBox(box, halves[0], halves[1]);
+    for (const vc::DesignInputs<vc::Interval>& b : {box, halves[0], halves[1]}) {
+        const vc::ModelOutputs<vc::Interval> enclosure = vc::evaluateModel(b);
+        for (int s = 0; s < 2000; ++s) {
+            vc::DesignInputs<double> d;
+#define VC_SAMPLE_FIELD(name, value) d.name = b.name.lo + unit(rng) * b.name.width();
+            VC_DESIGN_FIELDS(VC_SAMPLE_FIELD)
+#undef VC_SAMPLE_FIELD
+#define VC_SAMPLE_INTEGER_FIELD(name) d.name = std::floor(b.name.lo + unit(rng) * (b.name.width() + 1));
+            VC_INTEGER_DESIGN_FIELDS(VC_SAMPLE_INTEGER_FIELD)
+#undef VC_SAMPLE_INTEGER_FIELD
+            const vc::ModelOutputs<double> o = vc::evaluateModel(d);
+#define VC_CHECK_ENCLOSED(name) VC_CHECK(enclosure.name.contains(o.name));
+            VC_OUTPUT_FIELDS(VC_CHECK_ENCLOSED)
+#undef VC_CHECK_ENCLOSED
+        }
+    }
+}
+
+// Packed interval batch, with a remainder shorter than kBatchLanes, against
+// the scalar interval model box by box.
+void checkBatchMatchesScalar() {
+    vc::DesignBatch<vc::Interval> in;
+    const std::size_t n = 3 * vc::kBatchLanes + 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        vc::DesignInputs<vc::Interval> b = toleranceBox();
+        b.Q_in = {20.0 + i, 40.0 + 3 * i};
+        b.phi_deg = {-90 + 10.0 * i, -80 + 15.0 * i};
+        if (i == 5) {
+            b.t_vapor = {-1e-4, 1e-4};   // Divides by an interval containing zero
+        }
+        in.push_back(b);
+    }
+    vc::OutputBatch<vc::Interval> out;
+    vc::evaluateBatch(in, out);
+    for (std::size_t i = 0; i < n; ++i) {
+        const vc::ModelOutputs<vc::Interval> scalar = vc::evaluateModel(in.get(i));
+#define VC_CHECK_BOX(name) \
+        VC_CHECK(sameDouble(out.name[i].lo, scalar.name.lo) && sameDouble(out.name[i].hi, scalar.name.hi));
+        VC_OUTPUT_FIELDS(VC_CHECK_BOX)
+#undef VC_CHECK_BOX
+    }
+}
+
+// Integer inputs: whole midpoints and splits between whole values.
+void checkIntegerInputs() {
+    vc::DesignInputs<vc::Interval> box = vc::pointBox(vc::DesignInputs<double>{});
+    box.num_layers_evap = {2, 5};
+    const vc::DesignInputs<double> m = vc::boxMidpoint(box);
+    VC_CHECK(m.num_layers_evap == 4);
+
+    vc::DesignInputs<vc::Interval> left;
+    vc::DesignInputs<vc::Interval> right;
+    vc::bisectBox(box, left, right);
+    VC_CHECK(left.num_layers_evap.lo == 2 && left.num_layers_evap.hi == 3);
+    VC_CHECK(right.num_layers_evap.lo == 4 && right.num_layers_evap.hi == 5);
+    vc::DesignInputs<vc::Interval> a;
+    vc::DesignInputs<vc::Interval> b;
+    vc::bisectBox(left, a, b);
+    VC_CHECK(a.num_layers_evap.hi == 2 && b.num_layers_evap.lo == 3);
+
+    // A single whole value is not split again, even when relatively wider
+    box.num_layers_evap = {3, 3};
+    box.mesh_number_cond_wpi = {80, 80.5};
+    box.d_w_cond = {0.00015, 0.000151};
+    vc::bisectBox(box, left, right);
+    VC_CHECK(left.mesh_number_cond_wpi.hi == 80.5 && right.mesh_number_cond_wpi.lo == 80);
+    VC_CHECK(left.d_w_cond.hi < 0.000151 && right.d_w_cond.lo > 0.00015);
+    VC_CHECK(vc::boxMidpoint(box).mesh_number_cond_wpi == 80);
+
+    // Counterexamples of a failed certification have whole layer and mesh counts
+    vc::CertificationRequirement req;
+    req.Q_max_min = 1e9;
+    const vc::CertificationReport report = vc::certifyBox(toleranceBox(), req);
+    VC_CHECK(report.result == vc::CertificationResult::Violated);
+    VC_CHECK(report.counterexample.num_layers_evap == std::round(report.counterexample.num_layers_evap));
+    VC_CHECK(report.counterexample.mesh_number_cond_wpi == std::round(report.counterexample.mesh_number_cond_wpi));
+}
+
+}  // namespace
+
+int main() {
+    checkRounding();
+    checkEnclosureSoundness();
+    checkBatchMatchesScalar();
+    checkIntegerInputs();
+    return vc_test::report("test_interval");
+}
@@ -0,0 +1,178 @@
+// vc_kdtree.hpp: k nearest neighbors against brute force (random points and
+// a lattice full of exact ties), in memory, from the mapped file, batched,
+// and over the feasible rows of a sweep.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vc_kdtree.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+const std::vector<std::string> kAxes{"Q_in", "t_vapor", "d_w_evap"};
+
+// Closest first, ties by ID, with the tree's float coordinates and distance.
+std::vector<vc::Neighbor> bruteForce(const std::vector<float>& coords, const std::vector<std::uint64_t>& ids,
+                                     const std::vector<double>& q, std::size_t k) {
+    const std::size_t dims = q.size();
+    std::vector<vc::Neighbor> all;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        double d2 = 0;
+        for (std::size_t a = 0; a < dims; ++a) {
+            const double diff = q[a] - coords[i * dims + a];
+            d2 += diff * diff;
+        }
+        all.push_back({ids[i], d2});
+    }
+    std::sort(all.begin(), all.end(), [](const vc::Neighbor& a, const vc::Neighbor& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+    });
+    all.resize(k);
+    for (vc::Neighbor& n : all) {
+        n.distance = std::isinf(n.distance) ? n.distance : std::sqrt(n.distance);
+    }
+    return all;
+}
+
+bool same(const std::vector<vc::Neighbor>& a, const std::vector<vc::Neighbor>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id || a[i].distance != b[i].distance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vc::DesignInputs<double> designAt(const std::vector<double>& q) {
+    vc::DesignInputs<double> d;
+    for (std::size_t a = 0; a < kAxes.size(); ++a) {
+        d.*vc::designField(kAxes[a]) = q[a];
+    }
+    return d;
+}
+
+// Unit axes, so the normalized query is the design value itself.
+void checkPoints(const std::vector<float>& coords, const std::vector<std::uint64_t>& ids, std::mt19937_64& g,
+                 const char* label) {
+    const vc::KdTreeAxes axes{kAxes, {0, 0, 0}, {1, 1, 1}};
+    const vc::KdTree tree = vc::KdTree::build(axes, coords, ids, 8);
+    const std::string path = "test_kdtree.idx";
+    tree.save(path);
+    const vc::KdTree mapped(path);
+    VC_CHECK(mapped.size() == tree.size() && mapped.depth() == tree.depth() && mapped.axes().names == kAxes);
+
+    std::uniform_real_distribution<double> u(-0.1, 1.1);
+    vc::DesignBatch<double> batch;
+    std::vector<std::vector<double>> queries;
+    const std::size_t k = 9;
+    int mismatches = 0;
+    for (int t = 0; t < 300; ++t) {
+        std::vector<double> q{u(g), u(g), u(g)};
+        if (t % 3 == 0) {
+            const std::size_t p = static_cast<std::size_t>(t) % ids.size();
+            q = {coords[p * 3], coords[p * 3 + 1], coords[p * 3 + 2]};   // On a point
+        }
+        queries.push_back(q);
+        batch.push_back(designAt(q));
+        for (std::size_t kk : {std::size_t{1}, k, ids.size() + 3}) {
+            const std::vector<vc::Neighbor> expect = bruteForce(coords, ids, q, kk);
+            mismatches += !same(tree.nearest(designAt(q), kk), expect);
+            mismatches += !same(mapped.nearest(designAt(q), kk), expect);
+        }
+    }
+    if (mismatches != 0) {
+        std::printf("%s: %d mismatched queries\n", label, mismatches);
+    }
+    VC_CHECK(mismatches == 0);
+
+    std::vector<vc::Neighbor> out;
+    mapped.nearestBatch(batch, k, out);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const std::vector<vc::Neighbor> row(out.begin() + i * k, out.begin() + (i + 1) * k);
+        VC_CHECK(same(row, bruteForce(coords, ids, queries[i], k)));
+    }
+    std::remove(path.c_str());
+}
+
+// Feasible-design index over a sweep: only rows with dP_cap >= dP_total, on
+// axes normalized by the sweep's range.
+void checkFeasibleIndex() {
+    vc::DesignCodebook book;
+    book.setLevels("Q_in", {100, 400, 800, 1200, 1600, 2000, 2400, 2800, 3200});
+    book.setLevels("t_vapor", {0.0005, 0.001, 0.0015, 0.002, 0.0025});
+    book.setLevels("d_w_evap", {30e-6, 40e-6, 51e-6, 65e-6, 80e-6, 100e-6});
+    const std::string sweep = "test_kdtree.sweep";
+    vc::writeSweep(book, 0, book.catalogSize(), sweep, vc::FluidProperties{}, 32);
+    const vc::SweepFile file(sweep);
+    const vc::KdTree tree = vc::buildFeasibleDesignIndex(file, kAxes, 4);
+
+    std::vector<std::uint64_t> ids;
+    std::vector<float> coords;
+    const vc::KdTreeAxes& axes = tree.axes();
+    for (std::uint64_t r = 0; r < file.rows(); ++r) {
+        const vc::ModelOutputs<double> o = file.outputs(r);
+        if (o.dP_cap >= o.dP_total) {
+            ids.push_back(r);
+            for (std::size_t a = 0; a < kAxes.size(); ++a) {
+                coords.push_back(static_cast<float>(axes.normalize(a, file.value(r, file.columnIndex(kAxes[a])))));
+            }
+        }
+    }
+    VC_CHECK(tree.size() == ids.size() && ids.size() > 0 && ids.size() < file.rows());
+    VC_CHECK(axes.lo[0] == 100 && axes.hi[0] == 3200);
+
+    vc::DesignInputs<double> d;
+    d.Q_in = 3000;
+    d.t_vapor = 0.0007;
+    d.d_w_evap = 35e-6;
+    std::vector<double> q;
+    for (std::size_t a = 0; a < kAxes.size(); ++a) {
+        q.push_back(axes.normalize(a, d.*vc::designField(kAxes[a])));
+    }
+    VC_CHECK(same(tree.nearest(d, 6), bruteForce(coords, ids, q, 6)));
+    std::remove(sweep.c_str());
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937_64 g(17);
+
+    std::uniform_real_distribution<float> u(0, 1);
+    std::vector<float> coords(3 * 5000);
+    std::vector<std::uint64_t> ids(5000);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = 10 * i + 3;
+        for (int a = 0; a < 3; ++a) {
+            coords[3 * i + a] = u(g);
+        }
+    }
+    checkPoints(coords, ids, g, "random");
+
+    // 5^3 lattice, each point twice: neighbors tie on distance everywhere
+    coords.clear();
+    ids.clear();
+    for (int copy = 0; copy < 2; ++copy) {
+        for (int x = 0; x < 5; ++x) {
+            for (int y = 0; y < 5; ++y) {
+                for (int z = 0; z < 5; ++z) {
+                    coords.insert(coords.end(), {0.25f * x, 0.25f * y, 0.25f * z});
+                    ids.push_back(ids.size() * 7 % 1000);
+                }
+            }
+        }
+    }
+    checkPoints(coords, ids, g, "lattice");
+
+    checkFeasibleIndex();
+    return vc_test::report("test_kdtree");
+}
@@ -0,0 +1,75 @@
+// vc_pce.hpp: a fitted surrogate's mean and variance against 2^16 scrambled
+// Sobol evaluations of the model, and its Sobol indices against
+// sobolSensitivity on the same inputs.
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "vc_pce.hpp"
+#include "vc_sensitivity.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+const std::vector<vc::UncertainInput> kInputs{
+    vc::uncertainInput("d_w_evap", vc::InputDistribution::normal(51e-6, 5e-6)),
+    vc::uncertainInput("mesh_number_evap_wpi", vc::InputDistribution::uniform(190, 210)),
+    vc::uncertainInput("t_vapor", vc::InputDistribution::triangular(1.5e-3, 1.9e-3, 2.3e-3)),
+    vc::uncertainInput("k_shell", vc::InputDistribution::uniform(200, 400)),
+    vc::uncertainInput("kozeny_carman_constant", vc::InputDistribution::logNormal(122, 0.1))};
+
+struct Moments {
+    double mean = 0;
+    double variance = 0;
+};
+
+// Two-pass moments of one output over n scrambled Sobol points.
+Moments quasiMonteCarlo(const std::string& output, std::size_t n) {
+    const vc::SobolSequence sequence(static_cast<int>(kInputs.size()), vc::Scrambling::Owen, 77);
+    vc::DesignBatch<double> in;
+    vc::OutputBatch<double> out;
+    vc::sampleDesignBatch(sequence, 0, n, vc::DesignInputs<double>{}, kInputs, in);
+    vc::evaluateBatch(in, out);
+    const std::vector<double>& y = out.*vc::outputColumn<double>(output);
+    Moments m;
+    for (double v : y) {
+        m.mean += v / n;
+    }
+    for (double v : y) {
+        m.variance += (v - m.mean) * (v - m.mean) / (n - 1);
+    }
+    return m;
+}
+
+void checkAgainstSampling() {
+    const vc::PolynomialChaos pce = vc::fitPolynomialChaos(vc::DesignInputs<double>{}, kInputs);
+    vc::SensitivityOptions sens;
+    sens.base_samples = 1 << 14;
+    sens.bootstrap = 0;
+    sens.scrambling = vc::Scrambling::Owen;
+    const vc::SensitivityResult sobol = vc::sobolSensitivity(vc::DesignInputs<double>{}, kInputs, sens);
+    VC_CHECK(pce.outputCount() == 2 && sobol.outputs.size() == 2);
+
+    for (std::size_t k = 0; k < pce.outputCount(); ++k) {
+        const Moments qmc = quasiMonteCarlo(pce.outputName(k), 1 << 16);
+        VC_CHECK_NEAR(pce.mean(k), qmc.mean, 1e-4 * std::fabs(qmc.mean));
+        VC_CHECK_NEAR(pce.variance(k), qmc.variance, 0.005 * qmc.variance);
+        VC_CHECK(pce.looError(k) < 1e-3);
+
+        const vc::OutputSensitivity& s = sobol.outputs[k];
+        VC_CHECK(s.output == pce.outputName(k));
+        for (std::size_t i = 0; i < kInputs.size(); ++i) {
+            VC_CHECK_NEAR(pce.firstOrderIndex(k, i), s.first_order[i].value, 0.005);
+            VC_CHECK_NEAR(pce.totalIndex(k, i), s.total[i].value, 0.005);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkAgainstSampling();
+    return vc_test::report("test_pce");
+}
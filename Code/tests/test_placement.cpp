@@ -0,0 +1,98 @@
+// vc_placement.hpp: one die on a symmetric plate ends up centered, summed unit
+// responses match a fresh spectral solve of the same layout, and optimized
+// layouts keep every die on the plate and clear of the others.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_placement.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+void checkSingleDieCentered() {
+    const vc::DesignInputs<double> plate;   // 70 x 70 mm
+    vc::PlacementOptions opt;
+    opt.restarts = 4;
+    opt.iterations = 2000;
+    const vc::PlacementResult res = vc::optimizeDiePlacement(plate, {vc::Die{}}, opt);
+    VC_CHECK(res.layout.size() == 1);
+    // The 10 mm die is centered with its corner at 30 mm, on the 2.5 mm lattice
+    VC_CHECK_NEAR(res.layout[0].x0, 0.030, 1e-12);
+    VC_CHECK_NEAR(res.layout[0].y0, 0.030, 1e-12);
+    VC_CHECK(res.layouts_evaluated > 1);
+}
+
+// Three dies of two footprints at fixed candidates: the problem's superposed
+// wall field against SpectralSpreadingSolver on the rasterized layout.
+void checkSuperposition() {
+    const std::vector<vc::Die> dies{{0.010, 0.010, 60}, {0.015, 0.008, 35}, {0.010, 0.010, 20}};
+    vc::PlacementOptions opt;
+    opt.nx = opt.ny = 32;
+    vc::DesignInputs<double> design;
+    const vc::DiePlacementProblem problem(design, dies, opt);
+    const std::vector<std::size_t> pos{0, 7 * problem.candidateColumns(1) + 12, problem.candidateCount(2) - 1};
+    std::vector<double> theta(problem.cells(), 0.0);
+    std::vector<double> pressure(problem.cells(), 0.0);
+    std::vector<vc::HeatSource> layout;
+    for (std::size_t k = 0; k < dies.size(); ++k) {
+        problem.accumulate(k, pos[k], 1, theta, pressure);
+        layout.push_back(problem.source(k, pos[k]));
+    }
+    design.Q_in = 115;
+    const vc::SpectralSpreadingSolver wall(design, vc::evaluateModel(design), opt.nx, opt.ny);
+    std::vector<double> fresh;
+    wall.solve(layout, fresh);
+    const double peak = *std::max_element(fresh.begin(), fresh.end());
+    for (std::size_t k = 0; k < fresh.size(); ++k) {
+        VC_CHECK_NEAR(theta[k], fresh[k], 1e-10 * peak);
+    }
+    vc::PlacementResult scored;
+    problem.score(theta, pressure, &scored);
+    VC_CHECK_NEAR(scored.theta_peak, peak, 1e-10 * peak);
+
+    // Moving a die is subtract-then-add; it lands on the fresh field of the new layout
+    problem.accumulate(1, pos[1], -1, theta, pressure);
+    problem.accumulate(1, 3, 1, theta, pressure);
+    layout[1] = problem.source(1, 3);
+    wall.solve(layout, fresh);
+    for (std::size_t k = 0; k < fresh.size(); ++k) {
+        VC_CHECK_NEAR(theta[k], fresh[k], 1e-10 * peak);
+    }
+}
+
+void checkNoOverlap() {
+    const vc::DesignInputs<double> plate;
+    const std::vector<vc::Die> dies{{0.015, 0.015, 40}, {0.015, 0.015, 40}, {0.020, 0.010, 30}, {0.010, 0.010, 60}};
+    vc::PlacementOptions opt;
+    opt.nx = opt.ny = 32;
+    opt.clearance = 0.002;
+    opt.restarts = 4;
+    opt.iterations = 1500;
+    const vc::PlacementResult res = vc::optimizeDiePlacement(plate, dies, opt);
+    VC_CHECK(res.layout.size() == dies.size());
+    for (std::size_t a = 0; a < res.layout.size(); ++a) {
+        const vc::HeatSource& p = res.layout[a];
+        VC_CHECK(p.x0 >= 0 && p.x0 + p.length <= plate.vc_length + 1e-12);
+        VC_CHECK(p.y0 >= 0 && p.y0 + p.width <= plate.vc_width + 1e-12);
+        VC_CHECK(p.power == dies[a].power && p.length == dies[a].length && p.width == dies[a].width);
+        for (std::size_t b = 0; b < a; ++b) {
+            const vc::HeatSource& q = res.layout[b];
+            const double g = opt.clearance - 1e-12;
+            VC_CHECK(p.x0 + p.length + g <= q.x0 || q.x0 + q.length + g <= p.x0 || p.y0 + p.width + g <= q.y0 ||
+                     q.y0 + q.width + g <= p.y0);
+        }
+    }
+    VC_CHECK(std::isfinite(res.objective) && res.theta_peak > 0);
+}
+
+}  // namespace
+
+int main() {
+    checkSingleDieCentered();
+    checkSuperposition();
+    checkNoOverlap();
+    return vc_test::report("test_placement");
+}
@@ -0,0 +1,103 @@
+// vc_pore_scale.hpp: lattice Boltzmann permeability against plane Poiseuille
+// flow, and WickTable keys that include the layer offsets.
+
+#include <vector>
+
+#include "vc_pore_scale.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Mean of nu u(z) / F over voxel centers z = 0.5, 1.5, ... of a box of nz
+// voxels, for a profile u(z) F / nu = shape(z). The TRT scheme with Lambda =
+// 3/16 reproduces the parabola exactly at the nodes, so K matches this sum;
+// the continuum integral differs from it by the midpoint-rule term (1/24
+// voxel^2 for these profiles).
+template <class Shape>
+double nodalPermeability(int nz, Shape shape) {
+    double sum = 0;
+    for (int z = 0; z < nz; ++z) {
+        sum += shape(z + 0.5);
+    }
+    return sum / nz;
+}
+
+// Open box on the wall: no slip at z = 0, free slip at z = H = nz, so
+// nu u / F = (2 H z - z^2) / 2 and K -> H^2 / 3. With the top layer solid the
+// channel has no slip on both sides of height h = nz - 1: nu u / F = z (h - z) / 2.
+void checkPoiseuille() {
+    vc::detail::ScreenVoxels v;
+    v.nx = 2;
+    v.ny = 2;
+    v.nz = 16;
+    v.dx = 1;
+    v.clearance.assign(static_cast<std::size_t>(v.nx) * v.ny * v.nz, 1.0);
+    vc::PoreScaleOptions opt;
+    opt.tolerance = 1e-10;
+    opt.max_steps = 200000;
+    int steps = 0;
+    bool converged = false;
+
+    for (double tau : {0.8, 1.0, 1.5}) {
+        opt.tau = tau;
+        const double K = vc::detail::latticePermeability(v, opt, false, steps, converged);
+        VC_CHECK(converged);
+        const double H = v.nz;
+        VC_CHECK_NEAR(K, nodalPermeability(v.nz, [&](double z) { return (2 * H * z - z * z) / 2; }), 1e-6 * K);
+        VC_CHECK_NEAR(K, H * H / 3, 1e-3 * K);
+    }
+
+    opt.tau = 1.0;
+    for (int y = 0; y < v.ny; ++y) {
+        for (int x = 0; x < v.nx; ++x) {
+            v.clearance[v.index(x, y, v.nz - 1)] = -1;
+        }
+    }
+    const double h = v.nz - 1;
+    const double K = vc::detail::latticePermeability(v, opt, false, steps, converged);
+    VC_CHECK(converged);
+    VC_CHECK_NEAR(K, nodalPermeability(v.nz, [&](double z) { return z < h ? z * (h - z) / 2 : 0.0; }), 1e-6 * K);
+    VC_CHECK_NEAR(K, h / v.nz * h * h / 12, 3e-3 * K);
+}
+
+// Stacks that differ only in their layer offset are separate entries.
+void checkOffsetKeys() {
+    vc::PoreScaleOptions opt;
+    opt.voxels_per_wire = 2;
+    opt.tolerance = 1e-5;
+    vc::ScreenStack aligned;
+    aligned.layers = 2;
+    vc::ScreenStack shifted = aligned;
+    shifted.offset_x = 0.5;
+
+    vc::WickTable table;
+    table.characterize({aligned, shifted, aligned}, opt);
+    VC_CHECK(table.size() == 2);
+    const vc::WickTableEntry* a = table.find(aligned);
+    const vc::WickTableEntry* b = table.find(shifted);
+    VC_CHECK(a && b && a != b);
+    VC_CHECK(b && b->stack.offset_x == 0.5);
+    VC_CHECK(a && b && a->result.K != b->result.K);
+
+    vc::PoreScaleResult measured = a ? a->result : vc::PoreScaleResult{};
+    measured.K *= 2;
+    table.insert(aligned, measured);
+    VC_CHECK(table.size() == 2);
+    VC_CHECK(b && table.find(shifted)->result.K == b->result.K);
+
+    // evaluateModel picks the entry for the offsets it is given
+    vc::DesignInputs<double> in;
+    in.num_layers_evap = 2;
+    vc::WickLayerOffsets offsets;
+    offsets.evap_x = 0.5;
+    VC_CHECK(b && vc::evaluateModel(in, table, offsets).K_evap == b->result.K);
+    VC_CHECK(vc::evaluateModel(in, table).K_evap == measured.K);
+}
+
+}  // namespace
+
+int main() {
+    checkPoiseuille();
+    checkOffsetKeys();
+    return vc_test::report("test_pore_scale");
+}
@@ -0,0 +1,66 @@
+// vc_qmc.hpp: Sobol block generation against point-by-point stepping and
+// seek, and the 2^32-point end of the sequence.
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "vc_qmc.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+template <class F>
+bool throwsOutOfRange(F f) {
+    try {
+        f();
+    } catch (const std::out_of_range&) {
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+int main() {
+    const int dims = 5;
+    const std::size_t n = 300;
+    vc::SobolSequence block(dims, vc::Scrambling::Owen, 7);
+    vc::SobolSequence step = block;
+    std::vector<double> cols(dims * n);
+    block.fillBlock(n, cols.data(), n);
+    std::vector<double> x(dims);
+    for (std::size_t i = 0; i < n; ++i) {
+        step.next(x.data());
+        for (int d = 0; d < dims; ++d) {
+            VC_CHECK(cols[d * n + i] == x[d]);
+        }
+    }
+    vc::SobolSequence seek = block;
+    seek.seek(n - 1);
+    seek.next(x.data());
+    for (int d = 0; d < dims; ++d) {
+        VC_CHECK(cols[d * n + n - 1] == x[d]);
+    }
+
+    // The last point exists; nothing past it does
+    const std::uint64_t last = vc::SobolSequence::kMaxPoints - 1;
+    vc::SobolSequence end(dims);
+    end.seek(last - 2);
+    end.fillBlock(3, cols.data(), 3);
+    VC_CHECK(end.index() == vc::SobolSequence::kMaxPoints);
+    end.seek(last);
+    end.next(x.data());
+    VC_CHECK(x[0] == 1.5 / 4294967296.0);   // Gray code 2^31: only the last direction number
+    VC_CHECK(throwsOutOfRange([&] { end.next(x.data()); }));
+    VC_CHECK(throwsOutOfRange([&] { end.seek(vc::SobolSequence::kMaxPoints); }));
+    end.seek(last);
+    VC_CHECK(throwsOutOfRange([&] { end.fillBlock(2, cols.data(), 2); }));
+    VC_CHECK(throwsOutOfRange([&] { vc::checkSequenceRange(end, last, 2, "test"); }));
+    vc::checkSequenceRange(end, last, 1, "test");
+
+    const vc::HaltonSequence halton(dims);
+    VC_CHECK(halton.maxPoints() > (std::uint64_t{1} << 50));
+    VC_CHECK(throwsOutOfRange([&] { vc::checkSequenceRange(halton, ~std::uint64_t{0} - 1, 4, "test"); }));
+    return vc_test::report("test_qmc");
+}
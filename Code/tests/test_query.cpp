@@ -0,0 +1,116 @@
+// vc_query.hpp: queries over a written sweep file against a brute-force scan
+// of the same rows, with zone-map skips, whole-chunk matches, a partial last
+// chunk and NaN rows.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_query.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+bool holds(double x, vc::CompareOp op, double v) {
+    if (std::isnan(x)) {
+        return false;
+    }
+    switch (op) {
+        case vc::CompareOp::Less:         return x < v;
+        case vc::CompareOp::LessEqual:    return x <= v;
+        case vc::CompareOp::Greater:      return x > v;
+        case vc::CompareOp::GreaterEqual: return x >= v;
+        case vc::CompareOp::Equal:        return x == v;
+        case vc::CompareOp::NotEqual:     return x != v;
+    }
+    return false;
+}
+
+std::vector<std::uint64_t> bruteForce(const vc::SweepFile& file, const std::vector<vc::Predicate>& predicates) {
+    std::vector<std::uint64_t> rows;
+    for (std::uint64_t r = 0; r < file.rows(); ++r) {
+        bool all = true;
+        for (const vc::Predicate& p : predicates) {
+            all = all && holds(file.value(r, file.columnIndex(p.column)), p.op, p.value);
+        }
+        if (all) {
+            rows.push_back(r);
+        }
+    }
+    return rows;
+}
+
+bool parseFails(const std::string& text) {
+    try {
+        vc::parseQuery(text);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+int main() {
+    // 1200 designs in 64-row chunks (the last holds 48); num_layers_cond
+    // varies slowest, so its zone maps separate chunks. A NaN heat load gives
+    // NaN outputs in a tenth of the rows.
+    vc::DesignCodebook book;
+    book.setLevels("Q_in", {50, 75, 100, 125, 150, 175, 200, 250, 300, std::numeric_limits<double>::quiet_NaN()});
+    book.setLevels("t_vapor", {0.0010, 0.0015, 0.0020, 0.0025});
+    book.setLevels("num_layers_evap", {2, 3, 4, 5, 6});
+    book.setLevels("num_layers_cond", {1, 2, 3, 4, 5, 6});
+    const std::string path = "test_query.sweep";
+    VC_CHECK(vc::writeSweep(book, 0, book.catalogSize(), path, vc::FluidProperties{}, 64) == 1200);
+    const vc::SweepFile file(path);
+    VC_CHECK(file.rows() == 1200 && file.chunkCount() == 19 && file.rowsInChunk(18) == 48);
+
+    const char* queries[] = {
+        "Q_max > 1750 && num_layers_cond <= 2",
+        "num_layers_cond == 4",
+        "delta_T >= 164",
+        "Q_in >= 125 and t_vapor < 0.002, R_total_corrected <= 1.2",
+        "k_shell == 380",
+        "k_shell = 380 && dP_total < 178",
+        "Q_in > 1e9",
+        "Q_in != 100",
+        "index >= 100, index < 130",
+    };
+    for (const char* q : queries) {
+        const std::vector<vc::Predicate> predicates = vc::parseQuery(q);
+        const std::vector<std::uint64_t> expect = bruteForce(file, predicates);
+        const vc::QueryResult res = vc::runQuery(file, predicates);
+        if (res.rows != expect) {
+            std::printf("query \"%s\": %zu rows, brute force %zu\n", q, res.rows.size(), expect.size());
+        }
+        VC_CHECK(res.rows == expect);
+        VC_CHECK(res.stats.rows_matched == expect.size());
+        VC_CHECK(vc::countQuery(file, predicates).rows_matched == expect.size());
+        VC_CHECK(res.stats.chunks == 19 && res.stats.chunks_skipped + res.stats.chunks_scanned <= 19);
+    }
+
+    // Zone maps: a slow column skips chunks, a constant one needs no scan
+    VC_CHECK(vc::countQuery(file, vc::parseQuery("num_layers_cond == 4")).chunks_skipped >= 12);
+    const vc::QueryStats all = vc::countQuery(file, vc::parseQuery("k_shell == 380"));
+    VC_CHECK(all.chunks_scanned == 0 && all.rows_matched == 1200);
+    VC_CHECK(vc::countQuery(file, vc::parseQuery("Q_in > 1e9")).chunks_skipped == 19);
+
+    VC_CHECK(parseFails("Q_max >"));
+    VC_CHECK(parseFails("> 3"));
+    VC_CHECK(parseFails("Q_max ~ 3"));
+    VC_CHECK(parseFails("Q_max > 3 || Q_in < 2"));
+    bool unknown = false;
+    try {
+        vc::runQuery(file, "no_such_column > 1");
+    } catch (const std::invalid_argument&) {
+        unknown = true;
+    }
+    VC_CHECK(unknown);
+
+    std::remove(path.c_str());
+    return vc_test::report("test_query");
+}
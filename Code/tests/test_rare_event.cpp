@@ -0,0 +1,98 @@
+// vc_rare_event.hpp: subset simulation against crude Monte Carlo at
+// P ~ 7e-4 and 1.4e-4, its coefficient of variation against the scatter over
+// seeds, and the unconverged result when max_levels runs out.
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "vc_rare_event.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Load scattered around a mean well below the nominal Q_max (~2300 W).
+std::vector<vc::UncertainInput> tolerances(double Q_mean) {
+    return {vc::uncertainInput("Q_in", vc::InputDistribution::normal(Q_mean, 100)),
+            vc::uncertainInput("d_w_evap", vc::InputDistribution::normal(51e-6, 3e-6)),
+            vc::uncertainInput("t_vapor", vc::InputDistribution::normal(1.92e-3, 0.15e-3)),
+            vc::uncertainInput("kozeny_carman_constant", vc::InputDistribution::logNormal(122, 0.15))};
+}
+
+// Crude Monte Carlo through the same standard-normal mapping; fraction with g <= 0.
+double crudeMonteCarlo(const std::vector<vc::UncertainInput>& inputs, std::size_t N, unsigned long long seed) {
+    std::vector<double> z(N * inputs.size());
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> normal;
+    for (double& v : z) {
+        v = normal(rng);
+    }
+    vc::DesignBatch<double> lanes;
+    vc::OutputBatch<double> out;
+    std::vector<double> g;
+    vc::detail::standardNormalToBatch(z, N, vc::DesignInputs<double>{}, inputs, lanes);
+    vc::evaluateBatch(lanes, out);
+    vc::detail::failureMargin(lanes, out, g);
+    double hits = 0;
+    for (double v : g) {
+        hits += v <= 0;
+    }
+    return hits / N;
+}
+
+void checkAgainstMonteCarlo(double Q_mean, std::size_t mc_samples) {
+    const std::vector<vc::UncertainInput> inputs = tolerances(Q_mean);
+    const double p_mc = crudeMonteCarlo(inputs, mc_samples, 7);
+    const double sd_mc = std::sqrt(p_mc / mc_samples);
+
+    const int seeds = 12;
+    double mean = 0;
+    double mean_sq = 0;
+    double cov = 0;
+    for (int s = 1; s <= seeds; ++s) {
+        vc::SubsetSimulationOptions opt;
+        opt.seed = s;
+        const vc::SubsetSimulationResult r = vc::subsetSimulation(vc::DesignInputs<double>{}, inputs, opt);
+        VC_CHECK(r.converged);
+        VC_CHECK(r.probability > 0 && r.probability <= r.probability_bound);
+        VC_CHECK(r.model_calls < mc_samples / 100);
+        mean += r.probability / seeds;
+        mean_sq += r.probability * r.probability / seeds;
+        cov += r.cov / seeds;
+    }
+    const double spread = std::sqrt((mean_sq - mean * mean) * seeds / (seeds - 1));
+    // Unbiased within the combined standard error of both estimates
+    VC_CHECK_NEAR(mean, p_mc, 3 * std::sqrt(sd_mc * sd_mc + spread * spread / seeds));
+    // The reported CoV matches the scatter over seeds (loosely: 12 seeds)
+    VC_CHECK(spread / mean > 0.5 * cov && spread / mean < 2 * cov);
+}
+
+// Too few levels for P ~ 1e-23: flagged, not a silent 0.
+void checkExhausted() {
+    const std::vector<vc::UncertainInput> inputs = tolerances(150);
+    vc::SubsetSimulationOptions opt;
+    opt.max_levels = 3;
+    const vc::SubsetSimulationResult r = vc::subsetSimulation(vc::DesignInputs<double>{}, inputs, opt);
+    VC_CHECK(!r.converged);
+    VC_CHECK(r.levels.size() == 4);
+    VC_CHECK(r.probability == 0);
+    VC_CHECK(std::isinf(r.cov));
+    VC_CHECK_NEAR(r.probability_bound, 1e-4, 1e-12);
+
+    // Out of levels above a reachable event: the bound still covers it
+    const std::vector<vc::UncertainInput> likely = tolerances(1250);
+    opt.max_levels = 2;
+    const vc::SubsetSimulationResult s = vc::subsetSimulation(vc::DesignInputs<double>{}, likely, opt);
+    VC_CHECK(!s.converged);
+    VC_CHECK(s.probability_bound >= crudeMonteCarlo(likely, 1 << 20, 7));
+}
+
+}  // namespace
+
+int main() {
+    checkAgainstMonteCarlo(1350, std::size_t{1} << 20);
+    checkAgainstMonteCarlo(1250, std::size_t{1} << 21);
+    checkExhausted();
+    return vc_test::report("test_rare_event");
+}
@@ -0,0 +1,141 @@
+// vc_reduce.hpp: sweepTopK and sweepPareto against a full sort and an O(n^2)
+// skyline of the same catalog range, on a catalog where every objective value
+// repeats (R_total_corrected and Q_max do not depend on Q_in); the reducers
+// fed the same designs in shuffled order; and 1 to 7 workers giving the same
+// designs.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "vc_reduce.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+struct Scored {
+    std::uint64_t index;
+    double r;   // R_total_corrected, minimized
+    double q;   // -Q_max, so lower is better
+};
+
+bool byR(const Scored& a, const Scored& b) {
+    return a.r < b.r || (a.r == b.r && a.index < b.index);
+}
+
+vc::DesignCodebook catalog() {
+    vc::DesignCodebook book;
+    book.setLevels("Q_in", {50, 100, 150});   // Leaves both objectives unchanged
+    book.setLevels("k_shell", {200, 300, 380, 400});
+    book.setLevels("mesh_number_evap_wpi", {100, 150, 200, 250, 300});
+    book.setLevels("t_vapor", {1.2e-3, 1.92e-3, 2.5e-3});
+    book.setLevels("num_layers_evap", {2, 3, 5, 7, 9});
+    return book;
+}
+
+std::vector<Scored> bruteForceScores(const vc::DesignCodebook& book, std::uint64_t begin, std::uint64_t end) {
+    std::vector<Scored> all;
+    for (std::uint64_t i = begin; i < end; ++i) {
+        const vc::ModelOutputs<double> o = vc::evaluateModel(book.decode(book.designAt(i)));
+        all.push_back({i, o.R_total_corrected, -o.Q_max});
+    }
+    return all;
+}
+
+std::vector<std::uint64_t> indices(const std::vector<vc::RankedDesign>& designs) {
+    std::vector<std::uint64_t> v;
+    for (const vc::RankedDesign& d : designs) {
+        v.push_back(d.index);
+    }
+    return v;
+}
+
+void checkAgainstBruteForce(unsigned workers) {
+    vc::setWorkerCount(workers);
+    const vc::DesignCodebook book = catalog();
+    const std::uint64_t begin = 37;
+    const std::uint64_t end = book.catalogSize() - 11;
+    std::vector<Scored> all = bruteForceScores(book, begin, end);
+
+    // Top-K: sort by (score, index)
+    const std::size_t k = 25;
+    std::vector<Scored> by_r = all;
+    std::sort(by_r.begin(), by_r.end(), byR);
+    const std::vector<vc::RankedDesign> top =
+        vc::sweepTopK(book, begin, end, vc::Objective::minimize("R_total_corrected"), k);
+    VC_CHECK(top.size() == k);
+    for (std::size_t i = 0; i < std::min(k, top.size()); ++i) {
+        VC_CHECK(top[i].index == by_r[i].index);
+        VC_CHECK(top[i].outputs.R_total_corrected == by_r[i].r);
+        VC_CHECK(top[i].design.Q_in == book.decode(book.designAt(by_r[i].index)).Q_in);
+    }
+    // The tie really is exercised: the K-th score repeats past the cut
+    VC_CHECK(by_r[k - 1].r == by_r[k].r || by_r[k - 2].r == by_r[k - 1].r);
+
+    // Skyline: keep i unless some j is no worse in both and better in one, or
+    // equal in both with a lower index
+    std::vector<Scored> front;
+    for (const Scored& a : all) {
+        bool dominated = false;
+        for (const Scored& b : all) {
+            const bool no_worse = b.r <= a.r && b.q <= a.q;
+            const bool strictly = b.r < a.r || b.q < a.q;
+            dominated = dominated || (no_worse && (strictly || b.index < a.index));
+        }
+        if (!dominated) {
+            front.push_back(a);
+        }
+    }
+    std::sort(front.begin(), front.end(), byR);
+    const std::vector<vc::RankedDesign> pareto = vc::sweepPareto(
+        book, begin, end, {vc::Objective::minimize("R_total_corrected"), vc::Objective::maximize("Q_max")});
+    VC_CHECK(front.size() > 2);
+    VC_CHECK(pareto.size() == front.size());
+    for (std::size_t i = 0; i < std::min(front.size(), pareto.size()); ++i) {
+        VC_CHECK(pareto[i].index == front[i].index);
+    }
+
+    // A sweep hands each reducer its designs in index order; shuffled, the
+    // tie-breaks on index have to do the work
+    std::vector<vc::RankedDesign> shuffled;
+    for (std::uint64_t i = begin; i < end; ++i) {
+        const vc::DesignInputs<double> d = book.decode(book.designAt(i));
+        shuffled.push_back({i, d, vc::evaluateModel(d)});
+    }
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(workers));
+    vc::TopK top_shuffled(vc::Objective::minimize("R_total_corrected"), k);
+    vc::ParetoSet pareto_shuffled({vc::Objective::minimize("R_total_corrected"), vc::Objective::maximize("Q_max")});
+    for (const vc::RankedDesign& d : shuffled) {
+        top_shuffled.add(d);
+        pareto_shuffled.add(d);
+    }
+    VC_CHECK(indices(top_shuffled.sorted()) == indices(top));
+    VC_CHECK(indices(pareto_shuffled.sorted()) == indices(pareto));
+}
+
+void checkWorkerCountIndependent() {
+    const vc::DesignCodebook book = catalog();
+    const vc::Objective objective = vc::Objective::maximize("Q_max");
+    const std::vector<vc::Objective> objectives{vc::Objective::minimize("R_total_corrected"),
+                                                vc::Objective::maximize("Q_max")};
+    vc::setWorkerCount(1);
+    const std::vector<std::uint64_t> top1 = indices(vc::sweepTopK(book, 0, book.catalogSize(), objective, 40));
+    const std::vector<std::uint64_t> front1 = indices(vc::sweepPareto(book, 0, book.catalogSize(), objectives));
+    for (unsigned workers : {2u, 4u, 7u}) {
+        vc::setWorkerCount(workers);
+        VC_CHECK(indices(vc::sweepTopK(book, 0, book.catalogSize(), objective, 40)) == top1);
+        VC_CHECK(indices(vc::sweepPareto(book, 0, book.catalogSize(), objectives)) == front1);
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkAgainstBruteForce(1);
+    checkAgainstBruteForce(4);
+    checkWorkerCountIndependent();
+    vc::setWorkerCount(0);
+    return vc_test::report("test_reduce");
+}
@@ -0,0 +1,84 @@
+// vc_sensitivity.hpp: an input the outputs do not read gets S = ST = 0, the
+// indices bracket the variance (sum S <= 1 <= sum ST), and the result and its
+// bootstrap intervals are identical for 1 to 7 workers.
+
+#include <cstddef>
+#include <vector>
+
+#include "vc_sensitivity.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// filling_ratio only sets the liquid charge; Q_max and R_total_corrected ignore it.
+const std::vector<vc::UncertainInput> kInputs{
+    vc::uncertainInput("d_w_evap", vc::InputDistribution::normal(51e-6, 5e-6)),
+    vc::uncertainInput("mesh_number_evap_wpi", vc::InputDistribution::uniform(190, 210)),
+    vc::uncertainInput("filling_ratio", vc::InputDistribution::uniform(0.2, 0.4)),
+    vc::uncertainInput("t_vapor", vc::InputDistribution::triangular(1.5e-3, 1.9e-3, 2.3e-3)),
+    vc::uncertainInput("k_shell", vc::InputDistribution::uniform(200, 400))};
+const std::size_t kUnused = 2;
+
+vc::SensitivityOptions options() {
+    vc::SensitivityOptions opt;
+    opt.base_samples = 1 << 13;
+    opt.bootstrap = 200;
+    opt.scrambling = vc::Scrambling::Owen;
+    opt.seed = 3;
+    return opt;
+}
+
+void checkIndices() {
+    const vc::SensitivityResult res = vc::sobolSensitivity(vc::DesignInputs<double>{}, kInputs, options());
+    VC_CHECK(res.model_calls == (std::size_t{1} << 13) * (kInputs.size() + 2));
+    for (const vc::OutputSensitivity& os : res.outputs) {
+        VC_CHECK(os.rows_used == std::size_t{1} << 13);
+        VC_CHECK(os.variance > 0);
+        // f_ABi == f_A exactly when input i is not read
+        VC_CHECK(os.first_order[kUnused].value == 0 && os.total[kUnused].value == 0);
+        VC_CHECK(os.first_order[kUnused].lo == 0 && os.first_order[kUnused].hi == 0);
+        double sum_S = 0;
+        double sum_ST = 0;
+        for (std::size_t i = 0; i < kInputs.size(); ++i) {
+            sum_S += os.first_order[i].value;
+            sum_ST += os.total[i].value;
+            VC_CHECK(os.total[i].value >= os.first_order[i].value - 0.02);
+            VC_CHECK(os.first_order[i].lo <= os.first_order[i].value && os.first_order[i].value <= os.first_order[i].hi);
+        }
+        VC_CHECK(sum_S <= 1 + 0.02);
+        VC_CHECK(sum_ST >= 1 - 0.02);
+        VC_CHECK(sum_S > 0.5);   // The inputs do explain the output
+    }
+    // Q_max does not depend on k_shell; the resistance does
+    VC_CHECK(res.outputs[0].total[4].value == 0);
+    VC_CHECK(res.outputs[1].total[4].value > 0.01);
+}
+
+void checkWorkerCountIndependent() {
+    vc::setWorkerCount(1);
+    const vc::SensitivityResult one = vc::sobolSensitivity(vc::DesignInputs<double>{}, kInputs, options());
+    for (unsigned workers : {2u, 4u, 7u}) {
+        vc::setWorkerCount(workers);
+        const vc::SensitivityResult many = vc::sobolSensitivity(vc::DesignInputs<double>{}, kInputs, options());
+        for (std::size_t k = 0; k < one.outputs.size(); ++k) {
+            const vc::OutputSensitivity& a = one.outputs[k];
+            const vc::OutputSensitivity& b = many.outputs[k];
+            VC_CHECK(a.mean == b.mean && a.variance == b.variance);
+            for (std::size_t i = 0; i < kInputs.size(); ++i) {
+                VC_CHECK(a.first_order[i].value == b.first_order[i].value);
+                VC_CHECK(a.first_order[i].lo == b.first_order[i].lo && a.first_order[i].hi == b.first_order[i].hi);
+                VC_CHECK(a.total[i].value == b.total[i].value);
+                VC_CHECK(a.total[i].lo == b.total[i].lo && a.total[i].hi == b.total[i].hi);
+            }
+        }
+    }
+    vc::setWorkerCount(0);
+}
+
+}  // namespace
+
+int main() {
+    checkIndices();
+    checkWorkerCountIndependent();
+    return vc_test::report("test_sensitivity");
+}
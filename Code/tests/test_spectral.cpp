@@ -0,0 +1,114 @@
+// vc_spectral.hpp: DCT round trips, agreement with the multigrid path of
+// vc_spreading.hpp, and a common R_evap_spreading definition.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "vc_multigrid.hpp"
+#include "vc_spectral.hpp"
+#include "vc_spreading.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// FFT (power-of-two) and cosine-table plans: forward against the defining
+// sum, inverse(forward(x)) == x.
+void checkDctRoundTrip(int n) {
+    const vc::DctPlan plan(n);
+    std::vector<double> x(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = std::sin(0.7 * i) + 0.01 * i * i - 0.5;
+    }
+    std::vector<double> X = x;
+    std::vector<std::complex<double>> work;
+    plan.forward(X.data(), work);
+    for (int k = 0; k < n; ++k) {
+        double direct = 0;
+        for (int i = 0; i < n; ++i) {
+            direct += x[i] * std::cos(M_PI * (i + 0.5) * k / n);
+        }
+        VC_CHECK_NEAR(X[k], direct, 1e-10 * n);
+    }
+    plan.inverse(X.data(), work);
+    for (int i = 0; i < n; ++i) {
+        VC_CHECK_NEAR(X[i], x[i], 1e-12 * n);
+    }
+}
+
+// The same discrete plate problem through both solvers.
+void checkAgainstMultigrid() {
+    const int nx = 64;
+    const int ny = 32;
+    const double length = 0.07;
+    const double width = 0.05;
+    const double c = 0.855;
+    const double h = 2500;
+    std::vector<vc::HeatSource> sources(2);
+    sources[0] = {0.010, 0.010, 0.012, 0.010, 60};
+    sources[1] = {0.045, 0.030, 0.008, 0.008, 25};
+    const std::vector<double> q = vc::rasterizePowerMap(nx, ny, length, width, sources);
+
+    std::vector<double> spectral;
+    vc::SpectralPlateSolver(nx, ny, length, width, c, h).solve(q, spectral);
+    vc::MultigridSolver mg(nx, ny, length / nx, width / ny, std::vector<double>(q.size(), c),
+                           std::vector<double>(q.size(), h));
+    std::vector<double> multigrid;
+    mg.solve(q, multigrid, 1e-12);
+    const double peak = *std::max_element(spectral.begin(), spectral.end());
+    double worst = 0;
+    for (std::size_t k = 0; k < q.size(); ++k) {
+        worst = std::max(worst, std::fabs(spectral[k] - multigrid[k]));
+    }
+    VC_CHECK(worst <= 1e-8 * peak);
+
+    // Energy balance: everything that enters leaves through h
+    double out = 0;
+    for (double t : spectral) {
+        out += h * t * (length / nx) * (width / ny);
+    }
+    VC_CHECK_NEAR(out, 85.0, 1e-9 * 85);
+}
+
+// One centered source: both solvers report the same R_evap_spreading.
+void checkSpreadingDefinition() {
+    const vc::DesignInputs<double> in;
+    vc::SpreadingOptions opt;
+    opt.nx = 128;
+    opt.ny = 128;
+    const vc::ModelOutputs<double> multigrid = vc::evaluateModelWithSpreading(in, vc::FluidProperties{}, opt);
+    const std::vector<vc::HeatSource> die{{0.5 * (in.vc_length - in.evap_length), 0.5 * (in.vc_width - in.evap_width),
+                                           in.evap_length, in.evap_width, in.Q_in}};
+    vc::PowerMapResult res;
+    const vc::ModelOutputs<double> spectral = vc::evaluateModelWithPowerMap(in, die, vc::FluidProperties{}, opt, &res);
+    VC_CHECK_NEAR(spectral.R_evap_spreading, multigrid.R_evap_spreading, 1e-6);
+    VC_CHECK(res.R_evap_spreading_peak > spectral.R_evap_spreading);
+    VC_CHECK_NEAR(res.R_evap_spreading_peak - spectral.R_evap_spreading, (res.theta_peak - res.theta_mean) / in.Q_in,
+                  1e-12);
+
+    // Peak reference: the network sums the hot-spot value, on both paths
+    opt.evap_reference = vc::SpreadingReference::Peak;
+    vc::PowerMapResult hot;
+    const vc::ModelOutputs<double> peak = vc::evaluateModelWithPowerMap(in, die, vc::FluidProperties{}, opt, &hot);
+    VC_CHECK_NEAR(peak.R_evap_spreading, res.R_evap_spreading_peak, 1e-15);
+    VC_CHECK_NEAR(peak.R_total_ideal - spectral.R_total_ideal, (res.theta_peak - res.theta_mean) / in.Q_in, 1e-12);
+    VC_CHECK_NEAR(peak.delta_T - spectral.delta_T,
+                  in.experimental_correction_factor * (res.theta_peak - res.theta_mean), 1e-9);
+    vc::SpreadingResult wall;
+    const vc::ModelOutputs<double> multigrid_peak = vc::evaluateModelWithSpreading(in, vc::FluidProperties{}, opt, &wall);
+    VC_CHECK_NEAR(multigrid_peak.R_evap_spreading - multigrid.R_evap_spreading,
+                  wall.theta_evap_peak - wall.theta_evap_source, 1e-12);
+    VC_CHECK_NEAR(multigrid_peak.R_evap_spreading, peak.R_evap_spreading, 1e-6);
+}
+
+}  // namespace
+
+int main() {
+    checkDctRoundTrip(64);
+    checkDctRoundTrip(48);
+    checkDctRoundTrip(1);
+    checkAgainstMultigrid();
+    checkSpreadingDefinition();
+    return vc_test::report("test_spectral");
+}
@@ -0,0 +1,59 @@
+// vc_spreading.hpp: the spreading terms replace, rather than add to, the 1D
+// wall and wick resistances they overlap.
+
+#include <vector>
+
+#include "vc_spreading.hpp"
+#include "vc_test.hpp"
+
+int main() {
+    const vc::DesignInputs<double> in;
+    const vc::ModelOutputs<double> plain = vc::evaluateModel(in);
+    vc::SpreadingOptions opt;
+    opt.nx = 112;   // 0.625 mm cells: the source edges fall on cell faces
+    opt.ny = 112;
+    vc::SpreadingResult res;
+    const vc::ModelOutputs<double> out = vc::evaluateModelWithSpreading(in, vc::FluidProperties{}, opt, &res);
+
+    // Source-averaged rise straight from the solved field
+    const std::vector<double> source =
+        vc::centeredFootprint(opt.nx, opt.ny, in.vc_length, in.vc_width, in.evap_length, in.evap_width);
+    double rise = 0;
+    double weight = 0;
+    for (std::size_t k = 0; k < source.size(); ++k) {
+        rise += res.theta_evap[k] * source[k];
+        weight += source[k];
+    }
+    rise /= weight;
+    VC_CHECK_NEAR(res.theta_evap_source, rise, 1e-12);
+
+    // Evaporator side of the network = lower wall half + the 2D field
+    const double evap_network = out.R_evap_wall + out.R_evap_wick + out.R_evap_spreading;
+    const double evap_field = in.t_evap_wall / (2 * in.k_shell * out.A_evap) + rise;
+    VC_CHECK_NEAR(evap_network, evap_field, 1e-9);
+
+    // Condenser side likewise with the plate-averaged rise
+    double cond_rise = 0;
+    for (double t : res.theta_cond) {
+        cond_rise += t;
+    }
+    cond_rise /= static_cast<double>(res.theta_cond.size());
+    VC_CHECK_NEAR(out.R_cond_wall + out.R_cond_spreading, in.t_cond_wall / (2 * in.k_shell * out.A_cond) + cond_rise,
+                  1e-9);
+
+    // A 20 mm source on a 70 mm copper plate spreads: the 2D total is below
+    // the 1D total, which puts all of the wick resistance under the source
+    VC_CHECK(out.R_evap_spreading < 0);
+    VC_CHECK(out.R_total_ideal < plain.R_total_ideal);
+    VC_CHECK_NEAR(out.R_total_ideal,
+                  evap_field + in.R_phase_change + out.R_cond_wick + out.R_cond_wall + out.R_cond_spreading, 1e-9);
+
+    // Without in-plane conduction nothing spreads and the 1D network stands
+    vc::DesignInputs<double> thin = in;
+    thin.t_evap_wall = 1e-9;
+    thin.t_cond_wall = 1e-9;
+    const vc::ModelOutputs<double> thin_out = vc::evaluateModelWithSpreading(thin, vc::FluidProperties{}, opt);
+    VC_CHECK_NEAR(thin_out.R_evap_spreading, 0.0, 1e-3 * thin_out.R_evap_wick);
+
+    return vc_test::report("test_spreading");
+}
@@ -0,0 +1,124 @@
+// vc_statistics.hpp: monteCarloStatistics against the segment tree folded
+// under several worker partitions (bit-identical), and against two-pass
+// moments and sorted quantiles of the same samples.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "vc_statistics.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+const std::vector<std::string> kOutputs{"Q_max", "R_total_corrected", "dP_total"};
+const double kQuantiles[] = {0.001, 0.01, 0.5, 0.99, 0.999};
+
+struct Study {
+    vc::SobolSequence sequence{3, vc::Scrambling::Owen, 11};
+    vc::DesignInputs<double> nominal;
+    std::vector<vc::UncertainInput> inputs{
+        vc::uncertainInput("Q_in", vc::InputDistribution::uniform(100, 200)),
+        vc::uncertainInput("d_w_evap", vc::InputDistribution::normal(51e-6, 3e-6)),
+        vc::uncertainInput("t_vapor", vc::InputDistribution::triangular(1.5e-3, 1.9e-3, 2.3e-3))};
+};
+
+// Samples first .. first + n - 1, evaluated into `out`.
+void evaluate(const Study& st, std::uint64_t first, std::size_t n, vc::OutputBatch<double>& out) {
+    vc::DesignBatch<double> in;
+    vc::sampleDesignBatch(st.sequence, first, n, st.nominal, st.inputs, in);
+    vc::evaluateBatch(in, out);
+}
+
+// The driver's reduction with the segments split over `workers` as parallelFor would.
+vc::StatisticsAccumulator foldSegments(const std::vector<vc::StatisticsAccumulator>& leaves, std::size_t workers) {
+    const std::size_t S = leaves.size();
+    workers = std::min(workers, S);
+    const std::size_t chunk = (S + workers - 1) / workers;
+    std::vector<vc::detail::StatisticsNode> stack;
+    for (std::size_t w = 0; w < workers; ++w) {
+        std::vector<vc::detail::StatisticsNode> part;
+        for (std::size_t s = w * chunk; s < std::min(S, (w + 1) * chunk); ++s) {
+            vc::detail::pushStatisticsNode(part, {0, s, leaves[s]});
+        }
+        for (vc::detail::StatisticsNode& node : part) {
+            vc::detail::pushStatisticsNode(stack, std::move(node));
+        }
+    }
+    vc::StatisticsAccumulator result(kOutputs);
+    for (const vc::detail::StatisticsNode& node : stack) {
+        result.merge(node.acc);
+    }
+    return result;
+}
+
+void checkIdentical(const vc::StatisticsAccumulator& a, const vc::StatisticsAccumulator& b) {
+    for (std::size_t o = 0; o < kOutputs.size(); ++o) {
+        const vc::OutputStatistics& x = a.outputs()[o];
+        const vc::OutputStatistics& y = b.outputs()[o];
+        VC_CHECK(x.moments.count == y.moments.count);
+        VC_CHECK(x.moments.mean == y.moments.mean);
+        VC_CHECK(x.moments.m2 == y.moments.m2);
+        VC_CHECK(x.moments.min == y.moments.min && x.moments.max == y.moments.max);
+        VC_CHECK(x.non_finite == y.non_finite);
+        VC_CHECK(x.sketch.centroidCount() == y.sketch.centroidCount());
+        for (double q : kQuantiles) {
+            VC_CHECK(x.sketch.quantile(q) == y.sketch.quantile(q));
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    const Study st;
+    const std::uint64_t count = 5 * vc::kStatisticsSegment + 3000;   // Six segments, the last partial
+    const vc::StatisticsAccumulator stats =
+        vc::monteCarloStatistics(st.sequence, 0, count, st.nominal, st.inputs, kOutputs);
+
+    // Same leaves folded for any worker count give the same bits
+    std::vector<vc::StatisticsAccumulator> leaves;
+    for (std::uint64_t first = 0; first < count; first += vc::kStatisticsSegment) {
+        vc::OutputBatch<double> out;
+        evaluate(st, first, static_cast<std::size_t>(std::min<std::uint64_t>(vc::kStatisticsSegment, count - first)), out);
+        leaves.emplace_back(kOutputs);
+        leaves.back().add(out);
+    }
+    for (std::size_t workers : {1, 2, 3, 4, 6, 7}) {
+        checkIdentical(foldSegments(leaves, workers), stats);
+    }
+
+    // Against the full sample
+    vc::OutputBatch<double> all;
+    evaluate(st, 0, count, all);
+    for (const std::string& name : kOutputs) {
+        std::vector<double> x = all.*vc::outputColumn<double>(name);
+        const vc::OutputStatistics& s = stats.output(name);
+        double mean = 0;
+        for (double v : x) {
+            mean += v;
+        }
+        mean /= x.size();
+        double m2 = 0;
+        for (double v : x) {
+            m2 += (v - mean) * (v - mean);
+        }
+        VC_CHECK(s.moments.count == count);
+        VC_CHECK_NEAR(s.moments.mean, mean, 1e-12 * std::fabs(mean));
+        VC_CHECK_NEAR(s.moments.m2, m2, 1e-9 * m2);
+
+        std::sort(x.begin(), x.end());
+        VC_CHECK(s.moments.min == x.front() && s.moments.max == x.back());
+        for (double q : kQuantiles) {
+            // Within 5% of min(q, 1 - q) in rank, and at least one sample
+            const double slack = std::max(1.0, 0.05 * std::min(q, 1 - q) * count);
+            const double lo = x[static_cast<std::size_t>(std::max(0.0, q * count - slack))];
+            const double hi = x[static_cast<std::size_t>(std::min(count - 1.0, q * count + slack))];
+            const double v = s.sketch.quantile(q);
+            VC_CHECK(v >= lo && v <= hi);
+        }
+    }
+    return vc_test::report("test_statistics");
+}
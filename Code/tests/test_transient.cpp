@@ -0,0 +1,113 @@
+// vc_transient.hpp: held power settles to the steady model's delta_T (and a
+// step-test ladder ends inside its settle band), and a network with a single
+// thermal mass follows the analytic RC exponential.
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_transient.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+void checkSettlesToSteadyModel() {
+    vc::DesignBatch<double> in;
+    for (int i = 0; i < 5; ++i) {
+        vc::DesignInputs<double> d;
+        d.k_shell = 200 + 40.0 * i;
+        d.t_evap_wall *= 0.6 + 0.2 * i;
+        d.num_layers_evap = 2 + i;
+        d.experimental_correction_factor = 1 + 0.1 * i;
+        in.push_back(d);
+    }
+    vc::OutputBatch<double> out;
+    vc::evaluateBatch(in, out);
+    vc::TransientBatch batch(in, out);
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        VC_CHECK_NEAR(batch.steadyRise(i, in.Q_in[i]), out.delta_T[i], 1e-12 * out.delta_T[i]);
+    }
+
+    // Hold each lane's own Q_in from a cold start for many time constants
+    for (int n = 0; n < 4000; ++n) {
+        batch.step(in.Q_in, 0.5);
+    }
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        VC_CHECK_NEAR(batch.heaterRise(i), out.delta_T[i], 1e-6 * out.delta_T[i]);
+    }
+
+    vc::StepTestProfile profile;
+    profile.Q_start = 50;
+    profile.steps = 3;
+    const vc::StepTestResult res = vc::simulateStepTest(batch, profile);
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        vc::DesignInputs<double> last = in.get(i);
+        last.Q_in = 80;
+        const double delta_T = vc::evaluateModel(last).delta_T;
+        VC_CHECK(std::fabs(batch.heaterRise(i) - delta_T) <= profile.settle_band);
+        double total = 0;
+        for (int s = 0; s < profile.steps; ++s) {
+            const double t = res.settle_time[i * profile.steps + s];
+            VC_CHECK(t > 0 && t < profile.max_hold);
+            total += t;
+        }
+        VC_CHECK(res.total_time[i] == total);
+    }
+}
+
+// Zero wall, vapor and wick masses (porosity 1, no liquid) except the
+// condenser wall, so the heater rise is
+// Q (R - R_4) + Q R_4 (1 - exp(-t / tau)), R_4 = R_cw / 2, tau = C_4 R_4.
+void checkSingleMass() {
+    vc::DesignInputs<double> d;
+    d.t_evap_wall = 0;
+    d.t_vapor = 0;
+    d.experimental_correction_factor = 1;
+    d.R_phase_change = 0.05;
+    vc::ModelOutputs<double> o;
+    o.t_evap_wick = o.t_cond_wick = 0.5e-3;
+    o.epsilon_evap = o.epsilon_cond = 1;
+    o.liquid_charge_volume_mL = 0;
+    o.R_evap_wall = 0.01;
+    o.R_evap_spreading = 0.02;
+    o.R_evap_wick = 0.1;
+    o.R_cond_wick = 0.08;
+    o.R_cond_wall = 0.03;
+    o.R_cond_spreading = 0.01;
+    vc::DesignBatch<double> in;
+    vc::OutputBatch<double> out;
+    in.push_back(d);
+    out.resize(1);
+    out.set(0, o);
+
+    vc::TransientBatch batch(in, out);
+    const vc::ThermalMassProperties mass;
+    const double C = mass.rho_shell * mass.c_shell * d.vc_length * d.vc_width * d.t_cond_wall;
+    const double R_4 = (o.R_cond_wall + o.R_cond_spreading) / 2;
+    const double R = 0.01 + 0.02 + 0.1 + 0.05 + 0.08 + 0.03 + 0.01;
+    const double tau = C * R_4;
+    const double Q = 40;
+    VC_CHECK_NEAR(batch.steadyRise(0, Q), Q * R, 1e-12 * Q * R);
+
+    // Backward Euler: exact recurrence T_n = (T_{n-1} + dt Q / C) / (1 + dt / tau),
+    // and within O(dt / tau) of the exponential
+    const double dt = tau / 1000;
+    const std::vector<double> load{Q};
+    double T = 0;
+    for (int n = 1; n <= 5000; ++n) {
+        batch.step(load, dt);
+        T = (T + dt * Q / C) / (1 + dt / tau);
+        const double t = n * dt;
+        const double exact = Q * (R - R_4) + Q * R_4 * (1 - std::exp(-t / tau));
+        VC_CHECK_NEAR(batch.nodeRise(vc::TransientBatch::CondWall, 0), T, 1e-12 * Q * R_4);
+        VC_CHECK_NEAR(batch.heaterRise(0), exact, 1e-3 * Q * R_4);
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkSettlesToSteadyModel();
+    checkSingleMass();
+    return vc_test::report("test_transient");
+}
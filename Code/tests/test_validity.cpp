@@ -0,0 +1,124 @@
+// vc_validity.hpp: each mask bit on a design built to fail that check, the
+// batch masks against the scalar ones, and pruning keeping lane order.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "vc_validity.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+const vc::ValidityLimits kBaselineGap = vc::ValidityLimits::fromDesign(vc::DesignInputs<double>{});
+
+std::uint8_t maskOf(const vc::DesignInputs<double>& d, const vc::ValidityLimits& limits = kBaselineGap) {
+    return vc::validityMask(d, vc::evaluateModel(d), limits);
+}
+
+void checkFlags() {
+    const vc::DesignInputs<double> base;
+    // 2 * 51e-6 * 5 + 2 * 150e-6 * 5 + 1.92e-3
+    VC_CHECK_NEAR(kBaselineGap.internal_gap, 3.93e-3, 1e-15);
+    VC_CHECK(maskOf(base) == 0);
+
+    // Mesh too fine for the wire: pi N d / 4 > 1, so epsilon <= 0
+    vc::DesignInputs<double> d = base;
+    d.mesh_number_evap_wpi = 700;
+    VC_CHECK(vc::evaluateModel(d).epsilon_evap <= 0);
+    VC_CHECK((maskOf(d) & vc::kPorosityEvap) != 0);
+    VC_CHECK((maskOf(d) & vc::kPorosityCond) == 0);
+    d = base;
+    d.mesh_number_cond_wpi = 250;
+    VC_CHECK((maskOf(d) & vc::kPorosityCond) != 0);
+    VC_CHECK((maskOf(d) & vc::kPorosityEvap) == 0);
+
+    // One extra evaporator layer overfills the baseline gap; nothing else changes sign
+    d = base;
+    d.num_layers_evap = 6;
+    VC_CHECK(maskOf(d) == vc::kStackFit);
+    VC_CHECK(maskOf(d, vc::ValidityLimits(1)) == 0);
+    // Thinner vapor space makes room for it
+    d.t_vapor -= 2 * d.d_w_evap;
+    VC_CHECK(maskOf(d) == 0);
+    d.t_vapor = 0;
+    VC_CHECK((maskOf(d) & vc::kStackFit) != 0);
+
+    d = base;
+    d.filling_ratio = std::numeric_limits<double>::quiet_NaN();
+    vc::ModelOutputs<double> out = vc::evaluateModel(d);
+    out.Q_max = std::numeric_limits<double>::infinity();
+    VC_CHECK((vc::validityMask(d, out, kBaselineGap) & vc::kNonFinite) != 0);
+    out = vc::evaluateModel(base);
+    out.Q_max = -1;
+    VC_CHECK(vc::validityMask(base, out, kBaselineGap) == vc::kNoCapillaryLimit);
+}
+
+// Lane i: valid unless i % 3 == 1 (stack too tall) or i % 5 == 2 (epsilon_evap <= 0).
+vc::DesignBatch<double> mixedBatch(std::size_t n) {
+    vc::DesignBatch<double> in;
+    for (std::size_t i = 0; i < n; ++i) {
+        vc::DesignInputs<double> d;
+        d.Q_in = 10 + 1.0 * i;   // Tags the lane
+        if (i % 3 == 1) {
+            d.num_layers_cond = 7;
+        }
+        if (i % 5 == 2) {
+            d.mesh_number_evap_wpi = 700;
+        }
+        in.push_back(d);
+    }
+    return in;
+}
+
+void checkBatchAndPruning() {
+    const std::size_t n = 61;
+    vc::DesignBatch<double> in = mixedBatch(n);
+    vc::OutputBatch<double> out;
+    std::vector<std::uint8_t> masks;
+    vc::evaluateBatchWithValidity(in, out, masks, kBaselineGap);
+    VC_CHECK(masks.size() == n);
+    for (std::size_t i = 0; i < n; ++i) {
+        VC_CHECK(masks[i] == maskOf(in.get(i)));
+        VC_CHECK(((masks[i] & vc::kStackFit) != 0) == (i % 3 == 1));
+        VC_CHECK(((masks[i] & vc::kPorosityEvap) != 0) == (i % 5 == 2));
+    }
+
+    // Rejecting only the stack-fit bit keeps the porous-invalid lanes
+    std::vector<std::uint32_t> keep;
+    const std::size_t fit = vc::validLaneIndices(masks, keep, vc::kStackFit);
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 3 != 1) {
+            VC_CHECK(k < fit && keep[k] == i);
+            ++k;
+        }
+    }
+    VC_CHECK(k == fit);
+
+    const vc::OutputBatch<double> all = out;
+    const std::size_t survivors = vc::pruneInvalid(in, out, masks);
+    VC_CHECK(in.size() == survivors && out.size() == survivors && masks.size() == survivors);
+    k = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 3 == 1 || i % 5 == 2) {
+            continue;
+        }
+        VC_CHECK(in.Q_in[k] == 10 + 1.0 * i);
+        VC_CHECK(out.Q_max[k] == all.Q_max[i]);
+        VC_CHECK(out.delta_T[k] == all.delta_T[i]);
+        VC_CHECK(masks[k] == 0);
+        ++k;
+    }
+    VC_CHECK(k == survivors);
+}
+
+}  // namespace
+
+int main() {
+    checkFlags();
+    checkBatchAndPruning();
+    return vc_test::report("test_validity");
+}
@@ -0,0 +1,87 @@
+// vc_wick_db.hpp: records against the models they were built from, through a
+// written and mapped database file.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "vc_test.hpp"
+#include "vc_wick_db.hpp"
+#include "vc_wick_types.hpp"
+
+namespace {
+
+void checkNearOutputs(const vc::ModelOutputs<double>& a, const vc::ModelOutputs<double>& b) {
+    VC_CHECK_NEAR(a.Q_max, b.Q_max, 1e-12 * b.Q_max);
+    VC_CHECK_NEAR(a.K_evap, b.K_evap, 1e-12 * b.K_evap);
+    VC_CHECK_NEAR(a.k_wick_evap, b.k_wick_evap, 1e-12 * b.k_wick_evap);
+    VC_CHECK_NEAR(a.k_wick_cond, b.k_wick_cond, 1e-12 * b.k_wick_cond);
+    VC_CHECK_NEAR(a.R_total_ideal, b.R_total_ideal, 1e-12 * b.R_total_ideal);
+}
+
+}  // namespace
+
+int main() {
+    const std::string path = "test_wick_db.bin";
+    vc::SinteredPowderWick powder;
+    powder.particle_diameter = 80e-6;
+    powder.porosity = 0.55;
+    vc::writeWickDatabase(path, {vc::screenWickRecord(3, "200x51um x5", 200, 51e-6, 5),
+                                 vc::screenWickRecord(7, "100x114um x2", 100, 114e-6, 2),
+                                 vc::sinteredPowderWickRecord(12, "Cu 80um", powder)});
+    const vc::WickDatabase db(path);
+    VC_CHECK(db.size() == 13);
+
+    // Screen records reproduce the screen correlations, including a
+    // non-default Kozeny-Carman constant and k_shell
+    vc::DesignInputs<double> d;
+    d.mesh_number_evap_wpi = 200;
+    d.d_w_evap = 51e-6;
+    d.num_layers_evap = 5;
+    d.mesh_number_cond_wpi = 100;
+    d.d_w_cond = 114e-6;
+    d.num_layers_cond = 2;
+    d.kozeny_carman_constant = 150;
+    d.k_shell = 200;
+    checkNearOutputs(vc::evaluateModel(d, db[3], db[7]), vc::evaluateModel(d));
+
+    // Powder records carry their own conductivity model
+    const vc::ScreenMeshWick screen;
+    checkNearOutputs(vc::evaluateModel(d, db[12], db[7]), vc::evaluateModel(d, powder, screen));
+    VC_CHECK(db[12].conductivity(d.k_shell, 0.6) != vc::effectiveWickConductivity(db[12].value(vc::kWickPorosity),
+                                                                                   d.k_shell, 0.6));
+
+    // A measured k_wick overrides the model
+    vc::WickRecord fixed = db[12];
+    fixed.setMeasured(vc::kWickConductivity, 42);
+    VC_CHECK(vc::evaluateModel(d, fixed, db[7]).k_wick_evap == 42);
+
+    // ID-only batches match the full-column batch
+    vc::DesignBatch<double> full;
+    vc::WickDesignBatch ids;
+    for (int i = 0; i < 5; ++i) {
+        d.Q_in = 20 + 10 * i;
+        d.t_vapor = 0.3e-3 + 0.1e-3 * i;
+        full.push_back(d);
+        ids.push_back(d, 3, 7);
+    }
+    vc::OutputBatch<double> a;
+    vc::OutputBatch<double> b;
+    vc::evaluateBatch(full, a);
+    vc::evaluateBatch(ids, db, b);
+    for (std::size_t i = 0; i < full.size(); ++i) {
+        checkNearOutputs(b.get(i), a.get(i));
+    }
+
+    bool threw = false;
+    ids.evap_wick[2] = 4;   // Empty record
+    try {
+        vc::evaluateBatch(ids, db, b);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    VC_CHECK(threw);
+
+    std::remove(path.c_str());
+    return vc_test::report("test_wick_db");
+}
@@ -0,0 +1,89 @@
+// vc_wick_flow.hpp: a full-width evaporator strip, where the plate flow is
+// one-dimensional and Darcy's law integrates in closed form, and the scaled
+// 1 W field against a fresh solve of the same load.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_wick_flow.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Evaporator across the whole width, 32 of 128 cells long (no partial cells).
+vc::DesignInputs<double> stripDesign() {
+    vc::DesignInputs<double> d;
+    d.evap_width = d.vc_width;
+    d.evap_length = d.vc_length * 32 / 128;
+    return d;
+}
+
+// Volume flow V = Q / (rho h_fg) leaves the strip symmetrically; per unit
+// width, the flux rises linearly to V / 2W at the strip edge and falls
+// linearly to 0 at the plate edge, so from the center to either edge
+// dP = V L / (8 W sigma), sigma = (K_e t_e + K_c t_c) / mu, whatever the strip length.
+void checkOneDimensionalDarcy() {
+    const vc::FluidProperties fluid;
+    for (double fraction : {0.25, 0.5}) {
+        vc::DesignInputs<double> d = stripDesign();
+        d.evap_length = d.vc_length * fraction;
+        const vc::ModelOutputs<double> out = vc::evaluateModel(d, fluid);
+        const vc::WickFlowSolver wick(d, out, fluid);
+        const double sigma = (out.K_evap * out.t_evap_wick + out.K_cond * out.t_cond_wick) / fluid.mu_l;
+        const double closed_form = d.vc_length / (8 * fluid.rho_l * fluid.h_fg * d.vc_width * sigma);
+        VC_CHECK_NEAR(wick.unitPressureDrop(), closed_form, 1e-5 * closed_form);
+
+        // No flow across the width: every column of the field is the same
+        const std::vector<double> p = wick.pressureField(1);
+        double across = 0;
+        for (int j = 1; j < wick.ny(); ++j) {
+            for (int i = 0; i < wick.nx(); ++i) {
+                across = std::max(across, std::fabs(p[j * wick.nx() + i] - p[i]));
+            }
+        }
+        VC_CHECK(across < 1e-6 * closed_form);
+    }
+}
+
+// pressureDrop(Q) is Q times the 1 W drop; solving the same footprint load
+// at Q from scratch gives the same drop and field.
+void checkLoadScaling() {
+    vc::DesignInputs<double> d;
+    d.evap_width = 0.015;
+    const vc::ModelOutputs<double> out = vc::evaluateModel(d);
+    vc::WickFlowSolver wick(d, out);
+    const int nx = wick.nx();
+    const int ny = wick.ny();
+    const double cell_area = (d.vc_length / nx) * (d.vc_width / ny);
+    const std::vector<double> cover = vc::centeredFootprint(nx, ny, d.vc_length, d.vc_width, d.evap_length, d.evap_width);
+    double evap_area = 0;
+    for (double c : cover) {
+        evap_area += c * cell_area;
+    }
+    for (double Q : {35.0, 150.0, 420.0}) {
+        std::vector<double> q(cover.size());
+        for (std::size_t k = 0; k < q.size(); ++k) {
+            q[k] = Q * cover[k] / evap_area;
+        }
+        std::vector<double> fresh;
+        const double dP = wick.pressureDropForHeatMap(q, &fresh);
+        VC_CHECK_NEAR(wick.pressureDrop(Q), Q * wick.unitPressureDrop(), 1e-15 * dP);
+        VC_CHECK_NEAR(wick.pressureDrop(Q), dP, 1e-6 * dP);
+        const std::vector<double> scaled = wick.pressureField(Q);
+        double worst = 0;
+        for (std::size_t k = 0; k < scaled.size(); ++k) {
+            worst = std::max(worst, std::fabs(scaled[k] - fresh[k]));
+        }
+        VC_CHECK(worst < 1e-6 * dP);
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkOneDimensionalDarcy();
+    checkLoadScaling();
+    return vc_test::report("test_wick_flow");
+}
@@ -0,0 +1,94 @@
+// vc_wick_types.hpp: the screen policy against the built-in model, the groove
+// and sintered correlations against hand-computed values, and the packed
+// batch against the scalar policies.
+
+#include <cmath>
+#include <cstddef>
+
+#include "vc_wick_types.hpp"
+#include "vc_test.hpp"
+
+namespace {
+
+// Screen mesh on both sides is the model of vc_model.hpp, bit for bit.
+void checkScreenReproducesModel() {
+    for (int i = 0; i < 8; ++i) {
+        vc::DesignInputs<double> d;
+        d.Q_in = 30 + 17.0 * i;
+        d.mesh_number_evap_wpi = 100 + 25.0 * i;
+        d.d_w_cond *= 0.7 + 0.1 * i;
+        d.num_layers_evap = 1 + i;
+        d.phi_deg = -20 + 10.0 * i;
+        const vc::ModelOutputs<double> base = vc::evaluateModel(d);
+        const vc::ModelOutputs<double> policy = vc::evaluateModel(d, vc::ScreenMeshWick{}, vc::ScreenMeshWick{});
+#define VC_CHECK_SAME(name) VC_CHECK(policy.name == base.name);
+        VC_OUTPUT_FIELDS(VC_CHECK_SAME)
+#undef VC_CHECK_SAME
+    }
+}
+
+// 0.2 mm wide, 0.3 mm deep grooves with 0.2 mm fins, k_shell = 380, k_l = 0.668.
+// Half of a closed 0.2 x 0.6 mm duct: aspect 1/3, where Shah & London tabulate
+// f Re = 17.09, and r_h = 2 w delta / (w + 2 delta) = 0.15 mm. With eps = 0.5,
+// K = 2 eps r_h^2 / f Re = 1.3166e-9 m^2. Chi's conductance, with the fin term
+// 0.185 w_f k_s + delta k_l = 0.0142604 W/K, is
+// (w_f k_l k_s delta + w k_l 0.0142604) / ((w + w_f) 0.0142604) = 3.00405 W/m-K.
+void checkGrooveCorrelations() {
+    vc::DesignInputs<double> d;
+    const vc::AxialGrooveWick groove;
+    const vc::WickProperties<double> p = groove.properties(d, vc::evaporatorScreen(d), 0.668);
+    VC_CHECK_NEAR(vc::AxialGrooveWick::frictionFactorRe(1.0 / 3), 17.09, 0.01);
+    VC_CHECK_NEAR(p.thickness, 0.3e-3, 1e-18);
+    VC_CHECK_NEAR(p.porosity, 0.5, 1e-15);
+    VC_CHECK_NEAR(p.capillary_radius, 0.2e-3, 1e-18);
+    VC_CHECK_NEAR(p.permeability, 1.3166e-9, 1e-3 * 1.3166e-9);
+    VC_CHECK_NEAR(p.conductivity, 3.00405, 1e-5);
+}
+
+// 100 um spheres at eps = 0.5: K = d^2 eps^3 / (150 (1 - eps)^2) = 3.3333e-11 m^2,
+// rc = 0.21 d = 21 um. With k_l / k_s = 0.668 / 380 = 0.0017579, Chi's form gives
+// 380 (2.0017579 - 0.9982421) / (2.0017579 + 0.4991211) = 152.481 W/m-K.
+void checkSinteredCorrelations() {
+    vc::DesignInputs<double> d;
+    const vc::SinteredPowderWick powder;
+    const vc::WickProperties<double> p = powder.properties(d, vc::evaporatorScreen(d), 0.668);
+    VC_CHECK_NEAR(p.porosity, 0.5, 1e-15);
+    VC_CHECK_NEAR(p.permeability, 3.3333e-11, 1e-4 * 3.3333e-11);
+    VC_CHECK_NEAR(p.capillary_radius, 21e-6, 1e-18);
+    VC_CHECK_NEAR(p.conductivity, 152.481, 1e-3);
+}
+
+// Packed batch, including a remainder shorter than kBatchLanes, against the
+// scalar policy model lane by lane.
+void checkBatchMatchesScalar() {
+    vc::DesignBatch<double> in;
+    const std::size_t n = 3 * vc::kBatchLanes + 2;
+    for (std::size_t i = 0; i < n; ++i) {
+        vc::DesignInputs<double> d;
+        d.Q_in = 20 + 9.0 * i;
+        d.k_shell = 200 + 15.0 * i;
+        d.d_w_cond *= 0.8 + 0.05 * i;
+        in.push_back(d);
+    }
+    vc::SinteredPowderWick powder;
+    powder.porosity = 0.6;
+    vc::CompositeWick composite;
+    vc::OutputBatch<double> out;
+    vc::evaluateBatch(in, out, vc::WickModel(powder), vc::WickModel(composite));
+    for (std::size_t i = 0; i < n; ++i) {
+        const vc::ModelOutputs<double> scalar = vc::evaluateModel(in.get(i), powder, composite);
+#define VC_CHECK_LANE(name) VC_CHECK_NEAR(out.name[i], scalar.name, 1e-14 * std::fabs(scalar.name));
+        VC_OUTPUT_FIELDS(VC_CHECK_LANE)
+#undef VC_CHECK_LANE
+    }
+}
+
+}  // namespace
+
+int main() {
+    checkScreenReproducesModel();
+    checkGrooveCorrelations();
+    checkSinteredCorrelations();
+    checkBatchMatchesScalar();
+    return vc_test::report("test_wick_types");
+}
@@ -0,0 +1,39 @@
+#pragma once
+// Minimal checks for the standalone test programs in this directory. Each
+// test_*.cpp is its own program and exits non-zero if any check failed:
+//
+//     g++ -std=c++17 -O2 -pthread -I.. test_spreading.cpp -o test_spreading && ./test_spreading
+
+#include <cmath>
+#include <cstdio>
+
+namespace vc_test {
+
+inline int& failures() {
+    static int n = 0;
+    return n;
+}
+
+inline void check(bool ok, const char* what, const char* file, int line) {
+    if (!ok) {
+        std::printf("%s:%d: check failed: %s\n", file, line, what);
+        ++failures();
+    }
+}
+
+inline void checkNear(double a, double b, double tol, const char* what, const char* file, int line) {
+    if (!(std::fabs(a - b) <= tol)) {
+        std::printf("%s:%d: check failed: %s (%.17g vs %.17g, tolerance %g)\n", file, line, what, a, b, tol);
+        ++failures();
+    }
+}
+
+inline int report(const char* name) {
+    std::printf("%s: %s\n", name, failures() == 0 ? "passed" : "FAILED");
+    return failures() == 0 ? 0 : 1;
+}
+
+}  // namespace vc_test
+
+#define VC_CHECK(cond) vc_test::check((cond), #cond, __FILE__, __LINE__)
+#define VC_CHECK_NEAR(a, b, tol) vc_test::checkNear((a), (b), (tol), #a " ~ " #b, __FILE__, __LINE__)
@@ -0,0 +1,332 @@
+#pragma once
+// Discretized form of the 1D model, from the heat-source center to the plate
+// edge, along x (planar strip) or r (equivalent disk, see vc_radial.hpp).
+//
+// Planar: half of the plate (x in [0, vc_length / 2], full vc_width) carries
+// Q_in / 2; the other half is its mirror image. Radial: the disk r in [0, R]
+// carries all of Q_in through circumference 2 pi r. With w(x) the flow width
+// (vc_width, or 2 pi r) and N cells:
+//
+//   wall:   -(1/w) (k_shell t_evap_wall w theta')' + h theta = q(x),   no flux at both ends
+//           q uniform over the source (x < evap_length / 2, or r < r_s), h = half wall
+//           plus evaporator wick (as in vc_spreading.hpp)
+//   phase:  evaporation h theta / h_fg (WallFin) or uniform over the source
+//           (UnderSource), condensation uniform over the plate
+//   liquid: dP_l/dx =  mu_l F / (rho_l K t w)
+//   vapor:  dP_v/dx = -48 mu_v F / (rho_v t_vapor w d_h^2)
+//
+// F(x) is the net evaporation inside [0, x], i.e. the liquid returning toward
+// the center across x (and the vapor leaving). Under the heat source the
+// liquid runs in the evaporator wick alone (K t = K_evap t_evap_wick). Beyond
+// it the two wicks are in parallel, as in vc_wick_flow.hpp. For the strip the
+// vapor term is the per-length form of the lumped model; for the disk d_h =
+// 2 t_vapor (parallel plates). Pressures are relative to the edge, which is
+// the wet point, so the capillary demand at x is
+//
+//   demand(x) = (P_v - P_l)(x) + rho_l g (L - x) sin(phi)
+//
+// The evaporation assumption decides the capillary limit. WallFin lets the
+// wall conduct heat sideways before it evaporates, so evaporation spreads
+// over a fin length sqrt(k_shell t_evap_wall / h) around the source (about
+// 18 mm at the default design) and the liquid returns over a much shorter
+// path. UnderSource evaporates everything over the source footprint, as the
+// lumped model and the closed form of vc_radial.hpp do, and reproduces the
+// latter on radial lanes. At the default design Q_max is about 4.8 kW (disk)
+// and 13 kW (strip) under UnderSource, against 31 kW and 61 kW under WallFin.
+// The lumped model gives 2.3 kW: it sends all of Q_in over L_eff through the
+// two wicks in series rather than half of it along the source-to-edge profile.
+// The wall field and R_evap_spreading do not depend on the assumption.
+//
+// The wick is dry where demand >= dP_cap. Local saturation comes from the
+// Udell Leverett function J(s), scaled so J(0) gives dP_cap. It is quasi-static:
+// there is no relative-permeability feedback on the flow.
+//
+// Every field except gravity is linear in Q_in, so each lane is solved once for
+// a 1 W load. The wall equation is one tridiagonal system per design. The
+// Thomas sweeps run cell by cell with the design lanes innermost (structure of
+// arrays, as in vc_transient.hpp), so the inner loops vectorize across designs.
+// The geometry enters only through per-lane coefficients, so planar and radial
+// lanes share one sweep.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_radial.hpp"
+
+namespace vc {
+
+enum class AxialEvaporation : std::uint8_t {
+    WallFin,       // Local evaporation h theta from the conducting wall
+    UnderSource,   // Uniform over the source footprint, as the lumped and closed-form models
+};
+
+struct AxialOptions {
+    int cells = 64;               // Cells from the center to the edge
+    bool keep_profiles = true;    // false: only the per-design scalars
+    AxialEvaporation evaporation = AxialEvaporation::WallFin;
+};
+
+struct AxialBatchResult {
+    int cells = 0;
+    std::size_t lanes = 0;
+
+    // --- Per design ---
+    std::vector<double> Q_max;        // Q_in at which the center reaches dP_cap [W]
+    std::vector<double> dryout_x;     // Dry-front distance from the center [m]; 0 = wick wet
+    std::vector<double> demand_peak;  // Capillary demand at the center [Pa]
+    std::vector<double> theta_peak;   // Wall rise above vapor in the center cell [K]
+    std::vector<double> R_evap_spreading;   // Source-averaged wall rise minus heat / h, the rise without spreading [K/W]
+
+    // --- Profiles at cell centers x_i = (i + 0.5) L / cells (L = vc_length / 2, or R), index at(cell, lane) ---
+    std::vector<double> theta;        // Evaporator wall rise above vapor [K]
+    std::vector<double> mass_flux;    // Net evaporation (> 0) / condensation (< 0) [kg/s-m^2]
+    std::vector<double> P_l;          // Liquid pressure relative to the edge [Pa]
+    std::vector<double> P_v;          // Vapor pressure relative to the edge [Pa]
+    std::vector<double> saturation;   // Wick saturation, 1 = flooded, 0 = dry
+
+    std::size_t at(int cell, std::size_t lane) const { return static_cast<std::size_t>(cell) * lanes + lane; }
+};
+
+namespace detail {
+
+// Udell's Leverett function, normalized to 1 at s = 0.
+inline double leverettFraction(double s) {
+    const double u = 1 - s;
+    return (1.417 * u - 2.120 * u * u + 1.263 * u * u * u) / 0.560;
+}
+
+// Saturation with leverettFraction(s) == r for r in [0, 1]. J is strictly
+// monotone, so a fixed number of Newton steps from the linear guess converges.
+inline double saturationFromDemand(double r) {
+    r = std::min(std::max(r, 0.0), 1.0);
+    double u = r;
+    for (int k = 0; k < 6; ++k) {
+        const double f = (1.417 * u - 2.120 * u * u + 1.263 * u * u * u) / 0.560 - r;
+        const double df = (1.417 - 4.240 * u + 3.789 * u * u) / 0.560;
+        u = std::min(std::max(u - f / df, 0.0), 1.0);
+    }
+    return 1 - u;
+}
+
+}  // namespace detail
+
+// Solves every lane of `in` (with its outputs `out`) at its own Q_in, as a
+// planar strip or a radial disk per lane.
+inline AxialBatchResult solveAxialBatch(const DesignBatch<double>& in, const OutputBatch<double>& out,
+                                        const std::vector<FlowGeometry>& geometry,
+                                        const AxialOptions& opt = AxialOptions{},
+                                        const FluidProperties& fluid = FluidProperties{}) {
+    if (opt.cells < 2) {
+        throw std::invalid_argument("solveAxialBatch needs at least 2 cells");
+    }
+    if (geometry.size() != in.size()) {
+        throw std::invalid_argument("solveAxialBatch: one geometry per lane required");
+    }
+    const int N = opt.cells;
+    const std::size_t lanes = in.size();
+    AxialBatchResult res;
+    res.cells = N;
+    res.lanes = lanes;
+    res.Q_max.resize(lanes);
+    res.dryout_x.resize(lanes);
+    res.demand_peak.resize(lanes);
+    res.theta_peak.resize(lanes);
+    res.R_evap_spreading.resize(lanes);
+    if (opt.keep_profiles) {
+        const std::size_t n = static_cast<std::size_t>(N) * lanes;
+        res.theta.resize(n);
+        res.mass_flux.resize(n);
+        res.P_l.resize(n);
+        res.P_v.resize(n);
+        res.saturation.resize(n);
+    }
+    const double g = 9.81;
+    const double fin = opt.evaporation == AxialEvaporation::WallFin;   // 1: h theta, 0: source footprint
+    const std::size_t kBlock = 256;
+
+    parallelFor(lanes, [&](std::size_t begin, std::size_t end, unsigned) {
+        // Per-lane geometry: `radial` is 0 or 1, so the two layouts blend without branches
+        std::vector<double> radial(kBlock), span(kBlock), dx(kBlock), W(kBlock), a(kBlock);
+        std::vector<double> kt(kBlock), h(kBlock), heat(kBlock), sink(kBlock);
+        std::vector<double> R_evap(kBlock), R_both(kBlock), R_v(kBlock), head(kBlock);
+        std::vector<double> upper(static_cast<std::size_t>(N) * kBlock);
+        std::vector<double> T(static_cast<std::size_t>(N) * kBlock);
+        std::vector<double> F(static_cast<std::size_t>(N + 1) * kBlock);
+        std::vector<double> Pl(kBlock), Pv(kBlock), prev_demand(kBlock), flow(kBlock);
+        std::vector<double> source_rise(kBlock), source_area(kBlock);
+
+        const auto width = [&](std::size_t l, double x) { return (1 - radial[l]) * W[l] + radial[l] * 2 * M_PI * x; };
+        const auto cellArea = [&](std::size_t l, int k) {
+            return (1 - radial[l]) * W[l] * dx[l] + radial[l] * M_PI * dx[l] * dx[l] * (2 * k + 1);
+        };
+        const auto covered = [&](std::size_t l, int k) {
+            const double r = a[l] / dx[l];
+            return (1 - radial[l]) * std::min(std::max(r - k, 0.0), 1.0) +
+                   radial[l] * std::min(std::max((r * r - static_cast<double>(k) * k) / (2 * k + 1), 0.0), 1.0);
+        };
+
+        for (std::size_t b0 = begin; b0 < end; b0 += kBlock) {
+            const std::size_t B = std::min(kBlock, end - b0);
+
+            // --- Per-lane coefficients for a 1 W load ---
+            for (std::size_t l = 0; l < B; ++l) {
+                const std::size_t i = b0 + l;
+                const bool disk = geometry[i] == FlowGeometry::Radial;
+                const double R = equivalentRadius(in.vc_length[i], in.vc_width[i]);
+                const double r_s = std::min(equivalentRadius(in.evap_length[i], in.evap_width[i]), R);
+                radial[l] = disk;
+                W[l] = in.vc_width[i];
+                span[l] = disk ? R : in.vc_length[i] / 2;
+                a[l] = disk ? r_s : in.evap_length[i] / 2;
+                dx[l] = span[l] / N;
+                // The strip carries half of Q_in, the disk all of it
+                const double share = disk ? 1.0 : 0.5;
+                heat[l] = share / (disk ? M_PI * r_s * r_s : a[l] * W[l]);
+                sink[l] = share / (disk ? M_PI * R * R : span[l] * W[l]);
+                kt[l] = in.k_shell[i] * in.t_evap_wall[i];
+                h[l] = 1 / (in.t_evap_wall[i] / (2 * in.k_shell[i]) + out.t_evap_wick[i] / out.k_wick_evap[i]);
+                R_evap[l] = fluid.mu_l / (fluid.rho_l * out.K_evap[i] * out.t_evap_wick[i]);
+                R_both[l] = fluid.mu_l / (fluid.rho_l * (out.K_evap[i] * out.t_evap_wick[i] + out.K_cond[i] * out.t_cond_wick[i]));
+                const double d_h = disk ? 2 * in.t_vapor[i] : out.d_h_vapor[i];
+                R_v[l] = 48 * fluid.mu_v / (fluid.rho_v * in.t_vapor[i] * d_h * d_h);
+                head[l] = fluid.rho_l * g * std::sin(toRadians(in.phi_deg[i]));
+            }
+
+            // --- Thomas forward sweep [W per K]: row k is
+            //     -c_k T_{k-1} + (c_k + c_{k+1} + h A_k) T_k - c_{k+1} T_{k+1} = q_k,
+            //     c_k = kt w(x_k) / dx the conductance of face k (zero at both ends) ---
+            for (int k = 0; k < N; ++k) {
+                double* u = &upper[static_cast<std::size_t>(k) * kBlock];
+                double* d = &T[static_cast<std::size_t>(k) * kBlock];
+                const double* u_prev = k > 0 ? &upper[static_cast<std::size_t>(k - 1) * kBlock] : nullptr;
+                const double* d_prev = k > 0 ? &T[static_cast<std::size_t>(k - 1) * kBlock] : nullptr;
+                const double has_lower = k > 0;
+                const double has_upper = k < N - 1;
+                for (std::size_t l = 0; l < B; ++l) {
+                    const double area = cellArea(l, k);
+                    const double q = covered(l, k) * area * heat[l];
+                    const double c_lo = has_lower * kt[l] * width(l, k * dx[l]) / dx[l];
+                    const double c_hi = has_upper * kt[l] * width(l, (k + 1) * dx[l]) / dx[l];
+                    const double carry_u = u_prev ? u_prev[l] : 0.0;
+                    const double carry_d = d_prev ? d_prev[l] : 0.0;
+                    const double pivot = h[l] * area + c_lo + c_hi - c_lo * carry_u;
+                    u[l] = c_hi / pivot;
+                    d[l] = (q + c_lo * carry_d) / pivot;
+                }
+            }
+            // --- Back substitution: T_k = d_k + u_k T_{k+1} ---
+            for (int k = N - 2; k >= 0; --k) {
+                double* t = &T[static_cast<std::size_t>(k) * kBlock];
+                const double* t_next = &T[static_cast<std::size_t>(k + 1) * kBlock];
+                const double* u = &upper[static_cast<std::size_t>(k) * kBlock];
+                for (std::size_t l = 0; l < B; ++l) {
+                    t[l] += u[l] * t_next[l];
+                }
+            }
+
+            // --- Face flows F_k = net evaporation in cells [0, k) [kg/s per W]; source-averaged rise ---
+            std::fill(F.begin(), F.begin() + B, 0.0);
+            std::fill(source_rise.begin(), source_rise.begin() + B, 0.0);
+            std::fill(source_area.begin(), source_area.begin() + B, 0.0);
+            for (int k = 0; k < N; ++k) {
+                const double* t = &T[static_cast<std::size_t>(k) * kBlock];
+                const double* f = &F[static_cast<std::size_t>(k) * kBlock];
+                double* f_next = &F[static_cast<std::size_t>(k + 1) * kBlock];
+                for (std::size_t l = 0; l < B; ++l) {
+                    const double area = cellArea(l, k);
+                    const double heated = covered(l, k) * area;
+                    const double evaporated = fin * h[l] * t[l] + (1 - fin) * covered(l, k) * heat[l];
+                    f_next[l] = f[l] + (evaporated - sink[l]) * area / fluid.h_fg;
+                    source_rise[l] += t[l] * heated;
+                    source_area[l] += heated;
+                }
+            }
+
+            // --- Pressures from the edge inward: half-cell trapezoids of F / w ---
+            std::fill(Pl.begin(), Pl.begin() + B, 0.0);
+            std::fill(Pv.begin(), Pv.begin() + B, 0.0);
+            std::fill(prev_demand.begin(), prev_demand.begin() + B, 0.0);
+            std::fill(flow.begin(), flow.begin() + B, 0.0);   // Center demand per watt
+            for (std::size_t l = 0; l < B; ++l) {
+                res.dryout_x[b0 + l] = 0;
+            }
+            for (int k = N - 1; k >= 0; --k) {
+                const double* f_in = &F[static_cast<std::size_t>(k) * kBlock];
+                const double* f_out = &F[static_cast<std::size_t>(k + 1) * kBlock];
+                const double* t = &T[static_cast<std::size_t>(k) * kBlock];
+                for (std::size_t l = 0; l < B; ++l) {
+                    const std::size_t i = b0 + l;
+                    const double Q = in.Q_in[i];
+                    const double frac = covered(l, k);
+                    const double R_l = frac * R_evap[l] + (1 - frac) * R_both[l];
+                    const double x_in = k * dx[l];
+                    const double x_mid = x_in + dx[l] / 2;
+                    const double w_in = width(l, x_in);
+                    // w = 0 only at the disk center, where F = 0 too
+                    const double G_in = w_in > 0 ? f_in[l] / w_in : 0.0;
+                    const double G_mid = (f_in[l] + f_out[l]) / 2 / width(l, x_mid);
+                    const double G_out = f_out[l] / width(l, x_in + dx[l]);
+                    // Outer face -> cell center -> inner face
+                    const double to_center = dx[l] / 2 * (G_out + G_mid) / 2;
+                    const double to_face = dx[l] / 2 * (G_mid + G_in) / 2;
+                    const double Pl_center = Pl[l] - Q * R_l * to_center;
+                    const double Pv_center = Pv[l] + Q * R_v[l] * to_center;
+                    Pl[l] = Pl_center - Q * R_l * to_face;
+                    Pv[l] = Pv_center + Q * R_v[l] * to_face;
+                    flow[l] += (to_center + to_face) * (R_l + R_v[l]);
+
+                    // Dry front: outermost face with demand >= dP_cap, interpolated toward the next face out
+                    const double demand = Pv[l] - Pl[l] + head[l] * (span[l] - x_in);
+                    const double excess = demand - out.dP_cap[i];
+                    const double excess_out = prev_demand[l] - out.dP_cap[i];
+                    const double step = excess >= 0 && excess_out < 0 ? excess / (excess - excess_out) : 0.0;
+                    const double front = excess >= 0 ? x_in + step * dx[l] : 0.0;
+                    res.dryout_x[i] = std::max(res.dryout_x[i], front);
+                    prev_demand[l] = demand;
+
+                    if (opt.keep_profiles) {
+                        const std::size_t at = res.at(k, i);
+                        const double demand_mid = Pv_center - Pl_center + head[l] * (span[l] - x_mid);
+                        res.theta[at] = Q * t[l];
+                        const double evaporated = fin * h[l] * t[l] + (1 - fin) * frac * heat[l];
+                        res.mass_flux[at] = Q * (evaporated - sink[l]) / fluid.h_fg;
+                        res.P_l[at] = Pl_center;
+                        res.P_v[at] = Pv_center;
+                        res.saturation[at] = demand_mid >= out.dP_cap[i]
+                                                 ? 0.0
+                                                 : detail::saturationFromDemand(demand_mid / out.dP_cap[i]);
+                    }
+                }
+            }
+
+            // --- Center values: face 0 ---
+            for (std::size_t l = 0; l < B; ++l) {
+                const std::size_t i = b0 + l;
+                res.demand_peak[i] = prev_demand[l];
+                res.Q_max[i] = (out.dP_cap[i] - head[l] * span[l]) / flow[l];
+                res.theta_peak[i] = in.Q_in[i] * T[l];
+                // heat / h is the rise under the source without spreading. On the disk it
+                // is 1 / (h A_evap), which the network already counts (see vc_spreading.hpp);
+                // the strip's source is a full-width band, so its value is the band's spreading
+                res.R_evap_spreading[i] = source_rise[l] / source_area[l] - heat[l] / h[l];
+            }
+        }
+    }, 1024);
+    return res;
+}
+
+// All lanes as planar strips.
+inline AxialBatchResult solveAxialBatch(const DesignBatch<double>& in, const OutputBatch<double>& out,
+                                        const AxialOptions& opt = AxialOptions{},
+                                        const FluidProperties& fluid = FluidProperties{}) {
+    return solveAxialBatch(in, out, std::vector<FlowGeometry>(in.size(), FlowGeometry::Planar), opt, fluid);
+}
+
+}  // namespace vc
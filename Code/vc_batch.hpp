@@ -0,0 +1,247 @@
+#pragma once
+// Structure-of-arrays batch evaluation of the 1D model.
+// One std::vector per design field / output field, split across worker
+// threads. Works for any scalar type evaluateModel accepts; double batches run
+// the model on Lanes<kBatchLanes>, kBatchLanes consecutive designs per pass,
+// loaded from and stored to the columns directly.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+template <class T>
+struct DesignBatch {
+#define VC_DECLARE_INPUT_COLUMN(name, value) std::vector<T> name;
+    VC_DESIGN_FIELDS(VC_DECLARE_INPUT_COLUMN)
+#undef VC_DECLARE_INPUT_COLUMN
+
+    std::size_t size() const { return Q_in.size(); }
+
+    // Resizes every column, filling new lanes with `fill`.
+    void resize(std::size_t n, const DesignInputs<T>& fill = DesignInputs<T>{}) {
+#define VC_RESIZE_INPUT_COLUMN(name, value) name.resize(n, fill.name);
+        VC_DESIGN_FIELDS(VC_RESIZE_INPUT_COLUMN)
+#undef VC_RESIZE_INPUT_COLUMN
+    }
+
+    DesignInputs<T> get(std::size_t i) const {
+        DesignInputs<T> d;
+#define VC_GET_INPUT_COLUMN(name, value) d.name = name[i];
+        VC_DESIGN_FIELDS(VC_GET_INPUT_COLUMN)
+#undef VC_GET_INPUT_COLUMN
+        return d;
+    }
+
+    void set(std::size_t i, const DesignInputs<T>& d) {
+#define VC_SET_INPUT_COLUMN(name, value) name[i] = d.name;
+        VC_DESIGN_FIELDS(VC_SET_INPUT_COLUMN)
+#undef VC_SET_INPUT_COLUMN
+    }
+
+    void push_back(const DesignInputs<T>& d) {
+#define VC_PUSH_INPUT_COLUMN(name, value) name.push_back(d.name);
+        VC_DESIGN_FIELDS(VC_PUSH_INPUT_COLUMN)
+#undef VC_PUSH_INPUT_COLUMN
+    }
+};
+
+template <class T>
+struct OutputBatch {
+#define VC_DECLARE_OUTPUT_COLUMN(name) std::vector<T> name;
+    VC_OUTPUT_FIELDS(VC_DECLARE_OUTPUT_COLUMN)
+#undef VC_DECLARE_OUTPUT_COLUMN
+
+    std::size_t size() const { return Q_max.size(); }
+
+    void resize(std::size_t n) {
+#define VC_RESIZE_OUTPUT_COLUMN(name) name.resize(n);
+        VC_OUTPUT_FIELDS(VC_RESIZE_OUTPUT_COLUMN)
+#undef VC_RESIZE_OUTPUT_COLUMN
+    }
+
+    ModelOutputs<T> get(std::size_t i) const {
+        ModelOutputs<T> o;
+#define VC_GET_OUTPUT_COLUMN(name) o.name = name[i];
+        VC_OUTPUT_FIELDS(VC_GET_OUTPUT_COLUMN)
+#undef VC_GET_OUTPUT_COLUMN
+        return o;
+    }
+
+    void set(std::size_t i, const ModelOutputs<T>& o) {
+#define VC_SET_OUTPUT_COLUMN(name) name[i] = o.name;
+        VC_OUTPUT_FIELDS(VC_SET_OUTPUT_COLUMN)
+#undef VC_SET_OUTPUT_COLUMN
+    }
+};
+
+// Column of `DesignBatch<T>` by input name, e.g. designColumn<double>("d_w_evap").
+template <class T>
+std::vector<T> DesignBatch<T>::*designColumn(const std::string& name) {
+#define VC_MATCH_INPUT_COLUMN(field, value)     \
+    if (name == #field) {                       \
+        return &DesignBatch<T>::field;          \
+    }
+    VC_DESIGN_FIELDS(VC_MATCH_INPUT_COLUMN)
+#undef VC_MATCH_INPUT_COLUMN
+    throw std::invalid_argument("unknown design input: " + name);
+}
+
+// Column of `OutputBatch<T>` by output name, e.g. outputColumn<double>("Q_max").
+template <class T>
+std::vector<T> OutputBatch<T>::*outputColumn(const std::string& name) {
+#define VC_MATCH_OUTPUT_COLUMN(field)           \
+    if (name == #field) {                       \
+        return &OutputBatch<T>::field;          \
+    }
+    VC_OUTPUT_FIELDS(VC_MATCH_OUTPUT_COLUMN)
+#undef VC_MATCH_OUTPUT_COLUMN
+    throw std::invalid_argument("unknown model output: " + name);
+}
+
+// W doubles evaluated as one scalar: each operation is a fixed-length loop
+// over the lanes, which the compiler maps onto SIMD registers. Lane k gets
+// exactly the operations evaluateModel<double> applies to it.
+template <std::size_t W>
+struct Lanes {
+    double v[W];
+
+    Lanes() = default;
+    Lanes(double x) {
+        for (std::size_t k = 0; k < W; ++k) {
+            v[k] = x;
+        }
+    }
+
+#define VC_LANES_BINARY_OP(op)                                          \
+    friend Lanes operator op(const Lanes& a, const Lanes& b) {          \
+        Lanes r;                                                        \
+        for (std::size_t k = 0; k < W; ++k) {                           \
+            r.v[k] = a.v[k] op b.v[k];                                  \
+        }                                                               \
+        return r;                                                       \
+    }                                                                   \
+    friend Lanes& operator op##=(Lanes& a, const Lanes& b) { return a = a op b; }
+    VC_LANES_BINARY_OP(+)
+    VC_LANES_BINARY_OP(-)
+    VC_LANES_BINARY_OP(*)
+    VC_LANES_BINARY_OP(/)
+#undef VC_LANES_BINARY_OP
+
+    friend Lanes operator-(const Lanes& a) {
+        Lanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.v[k] = -a.v[k];
+        }
+        return r;
+    }
+
+    friend Lanes sin(const Lanes& a) {
+        Lanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.v[k] = std::sin(a.v[k]);
+        }
+        return r;
+    }
+
+    friend Lanes cos(const Lanes& a) {
+        Lanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.v[k] = std::cos(a.v[k]);
+        }
+        return r;
+    }
+
+    friend Lanes sqrt(const Lanes& a) {
+        Lanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.v[k] = std::sqrt(a.v[k]);
+        }
+        return r;
+    }
+
+    friend Lanes log(const Lanes& a) {
+        Lanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.v[k] = std::log(a.v[k]);
+        }
+        return r;
+    }
+
+    friend Lanes min(const Lanes& a, const Lanes& b) {
+        Lanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.v[k] = std::min(a.v[k], b.v[k]);
+        }
+        return r;
+    }
+};
+
+constexpr std::size_t kBatchLanes = 4;
+
+// Evaluates lanes [begin, end) on the calling thread.
+template <class T>
+void evaluateBatchRange(const DesignBatch<T>& in, OutputBatch<T>& out, std::size_t begin, std::size_t end,
+                        const FluidProperties& fluid = FluidProperties{}) {
+    for (std::size_t i = begin; i < end; ++i) {
+        out.set(i, evaluateModel(in.get(i), fluid));
+    }
+}
+
+namespace detail {
+
+// Designs [i, i + W) of `in` as one pack.
+template <std::size_t W>
+DesignInputs<Lanes<W>> loadDesignLanes(const DesignBatch<double>& in, std::size_t i) {
+    DesignInputs<Lanes<W>> d;
+#define VC_LOAD_INPUT_LANES(name, value)      \
+    for (std::size_t k = 0; k < W; ++k) {     \
+        d.name.v[k] = in.name[i + k];         \
+    }
+    VC_DESIGN_FIELDS(VC_LOAD_INPUT_LANES)
+#undef VC_LOAD_INPUT_LANES
+    return d;
+}
+
+// Stores a pack into outputs [i, i + W) of `out`.
+template <std::size_t W>
+void storeOutputLanes(const ModelOutputs<Lanes<W>>& o, OutputBatch<double>& out, std::size_t i) {
+#define VC_STORE_OUTPUT_LANES(name)           \
+    for (std::size_t k = 0; k < W; ++k) {     \
+        out.name[i + k] = o.name.v[k];        \
+    }
+    VC_OUTPUT_FIELDS(VC_STORE_OUTPUT_LANES)
+#undef VC_STORE_OUTPUT_LANES
+}
+
+}  // namespace detail
+
+// Column-wise kernel for double batches: kBatchLanes designs per model pass,
+// the remainder one at a time.
+inline void evaluateBatchRange(const DesignBatch<double>& in, OutputBatch<double>& out, std::size_t begin,
+                               std::size_t end, const FluidProperties& fluid = FluidProperties{}) {
+    std::size_t i = begin;
+    for (; i + kBatchLanes <= end; i += kBatchLanes) {
+        detail::storeOutputLanes(evaluateModel(detail::loadDesignLanes<kBatchLanes>(in, i), fluid), out, i);
+    }
+    for (; i < end; ++i) {
+        out.set(i, evaluateModel(in.get(i), fluid));
+    }
+}
+
+template <class T>
+void evaluateBatch(const DesignBatch<T>& in, OutputBatch<T>& out, const FluidProperties& fluid = FluidProperties{}) {
+    out.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        evaluateBatchRange(in, out, begin, end, fluid);
+    });
+}
+
+}  // namespace vc
@@ -0,0 +1,248 @@
+#pragma once
+// Bayesian calibration with an affine-invariant ensemble sampler.
+//
+// Samples the posterior of (experimental_correction_factor, R_phase_change,
+// kozeny_carman_constant) given test runs (vc_calibration.hpp). The likelihood
+// is Gaussian in the measured delta_T plateaus and, where a run observed
+// dryout, in Q_max; the priors are uniform boxes. delta_T does not depend on
+// the Kozeny-Carman constant, so that marginal only moves away from its prior
+// when some runs carry Q_max_observed.
+//
+// The sampler is the Goodman-Weare stretch move. Walkers are split in two
+// halves; all proposals of a half are scored together as one DesignBatch of
+// (walker x run) lanes through evaluateBatch, so the batch kernel does the
+// work and its threads parallelize the chains. Each walker owns its RNG
+// stream, so results do not depend on the thread count.
+//
+// After burn-in every walker state can be pushed through a target design to
+// stream posterior-predictive Q_max / delta_T samples to a callback.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_calibration.hpp"
+#include "vc_model.hpp"
+#include "vc_statistics.hpp"
+
+namespace vc {
+
+struct BayesianParameters {
+    static constexpr int kCount = 3;
+    enum Index { CorrectionFactor = 0, PhaseChange = 1, KozenyCarman = 2 };
+};
+
+struct BayesianOptions {
+    int walkers = 64;              // Even, and at least 2 * kCount
+    int burn_in = 500;             // Ensemble iterations discarded
+    int iterations = 2000;         // Ensemble iterations kept
+    int thin = 1;                  // Keep every thin-th iteration
+    double stretch = 2.0;          // Goodman-Weare scale a
+    double sigma_delta_T = 0.5;    // Measurement noise on delta_T [K]
+    std::array<double, 3> prior_lo{0.5, 0.0, 50};
+    std::array<double, 3> prior_hi{3.0, 0.2, 300};
+    std::array<double, 3> start{1.2, 0.01, 122};   // Walkers start in a small ball around this
+    double start_spread = 0.05;                    // Relative size of that ball
+    unsigned long long seed = 1;
+};
+
+struct PosteriorSample {
+    std::array<double, 3> theta;
+    double log_posterior;
+};
+
+struct PredictiveSample {
+    double Q_max;
+    double delta_T;
+};
+
+struct BayesianResult {
+    std::vector<PosteriorSample> samples;   // Post burn-in, thinned, walker-major per iteration
+    std::array<double, 3> mean{};
+    std::array<double, 3> std_dev{};
+    double acceptance_rate = 0;
+};
+
+// Posterior-predictive band for one output, from streamed samples. Held in a
+// QuantileSketch, so memory stays bounded however many samples stream in.
+class PredictiveBand {
+public:
+    explicit PredictiveBand(double compression = 500) : sketch_(compression) {}
+
+    void add(double v) {
+        sketch_.add(v);
+        ++count_;
+    }
+    std::size_t size() const { return count_; }
+
+    // Quantile, p in [0, 1]; NaN when empty
+    double quantile(double p) const { return sketch_.quantile(p); }
+
+private:
+    QuantileSketch sketch_;
+    std::size_t count_ = 0;
+};
+
+namespace detail {
+
+inline void applyBayesianTheta(DesignInputs<double>& d, const std::array<double, 3>& theta) {
+    d.experimental_correction_factor = theta[BayesianParameters::CorrectionFactor];
+    d.R_phase_change = theta[BayesianParameters::PhaseChange];
+    d.kozeny_carman_constant = theta[BayesianParameters::KozenyCarman];
+}
+
+// Log posterior of many parameter vectors at once via the batch kernel.
+inline void logPosteriorBatch(const std::vector<TestRun>& runs, const std::vector<std::array<double, 3>>& thetas,
+                              const BayesianOptions& opt, const FluidProperties& fluid, std::vector<double>& lp,
+                              DesignBatch<double>& lanes, OutputBatch<double>& out) {
+    const std::size_t n_theta = thetas.size();
+    const std::size_t n_runs = runs.size();
+    lp.assign(n_theta, 0.0);
+    std::vector<char> inside(n_theta, 1);
+    for (std::size_t w = 0; w < n_theta; ++w) {
+        for (int i = 0; i < 3; ++i) {
+            if (!(thetas[w][i] >= opt.prior_lo[i] && thetas[w][i] <= opt.prior_hi[i])) {
+                inside[w] = 0;
+            }
+        }
+    }
+    lanes.resize(n_theta * n_runs);
+    for (std::size_t w = 0; w < n_theta; ++w) {
+        for (std::size_t r = 0; r < n_runs; ++r) {
+            DesignInputs<double> d = runs[r].design;
+            applyBayesianTheta(d, thetas[w]);
+            d.Q_in = 1;   // delta_T is linear in Q_in
+            lanes.set(w * n_runs + r, d);
+        }
+    }
+    evaluateBatch(lanes, out, fluid);
+    const double inv_var = 1 / (opt.sigma_delta_T * opt.sigma_delta_T);
+    for (std::size_t w = 0; w < n_theta; ++w) {
+        if (!inside[w]) {
+            lp[w] = -std::numeric_limits<double>::infinity();
+            continue;
+        }
+        double ll = 0;
+        for (std::size_t r = 0; r < n_runs; ++r) {
+            const std::size_t lane = w * n_runs + r;
+            const double R = out.R_total_corrected[lane];
+            for (std::size_t k = 0; k < runs[r].Q_in.size(); ++k) {
+                const double e = runs[r].Q_in[k] * R - runs[r].delta_T[k];
+                ll -= 0.5 * e * e * inv_var;
+            }
+            if (std::isfinite(runs[r].Q_max_observed)) {
+                const double e = (out.Q_max[lane] - runs[r].Q_max_observed) / runs[r].Q_max_sigma;
+                ll -= 0.5 * e * e;
+            }
+        }
+        lp[w] = std::isfinite(ll) ? ll : -std::numeric_limits<double>::infinity();
+    }
+}
+
+}  // namespace detail
+
+// Runs the ensemble sampler. If `predict` is given, every kept walker state is
+// also evaluated at `*predict` and handed to `on_predictive`.
+inline BayesianResult sampleCalibrationPosterior(
+    const std::vector<TestRun>& runs, const BayesianOptions& opt = BayesianOptions{},
+    const FluidProperties& fluid = FluidProperties{}, const DesignInputs<double>* predict = nullptr,
+    const std::function<void(const PredictiveSample&)>& on_predictive = nullptr) {
+    const int W = opt.walkers & ~1;
+    const int half = W / 2;
+    BayesianResult res;
+    std::vector<std::mt19937_64> rng;
+    rng.reserve(W);
+    for (int w = 0; w < W; ++w) {
+        rng.emplace_back(opt.seed * 0x9E3779B97F4A7C15ULL + static_cast<unsigned long long>(w));
+    }
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+
+    // --- Initial ensemble ---
+    std::vector<std::array<double, 3>> x(W);
+    for (int w = 0; w < W; ++w) {
+        std::normal_distribution<double> N(0.0, opt.start_spread);
+        for (int i = 0; i < 3; ++i) {
+            const double span = opt.prior_hi[i] - opt.prior_lo[i];
+            x[w][i] = std::min(opt.prior_hi[i], std::max(opt.prior_lo[i], opt.start[i] + N(rng[w]) * std::max(std::fabs(opt.start[i]), 1e-3 * span)));
+        }
+    }
+    DesignBatch<double> lanes;
+    OutputBatch<double> out;
+    std::vector<double> lp;
+    detail::logPosteriorBatch(runs, x, opt, fluid, lp, lanes, out);
+
+    DesignBatch<double> pred_lanes;
+    OutputBatch<double> pred_out;
+    std::array<double, 3> sum{};
+    std::array<double, 3> sum_sq{};
+    std::size_t accepted = 0;
+    std::size_t proposed = 0;
+
+    const int total = opt.burn_in + opt.iterations;
+    std::vector<std::array<double, 3>> proposal(half);
+    std::vector<double> z(half);
+    std::vector<double> lp_prop;
+    for (int it = 0; it < total; ++it) {
+        for (int s = 0; s < 2; ++s) {
+            const int self = s * half;
+            const int other = (1 - s) * half;
+            for (int k = 0; k < half; ++k) {
+                std::mt19937_64& g = rng[self + k];
+                // z ~ g(z) proportional to 1/sqrt(z) on [1/a, a]
+                const double u = U(g);
+                z[k] = std::pow((opt.stretch - 1) * u + 1, 2) / opt.stretch;
+                const int j = other + static_cast<int>(U(g) * half) % half;
+                for (int i = 0; i < 3; ++i) {
+                    proposal[k][i] = x[j][i] + z[k] * (x[self + k][i] - x[j][i]);
+                }
+            }
+            detail::logPosteriorBatch(runs, proposal, opt, fluid, lp_prop, lanes, out);
+            for (int k = 0; k < half; ++k) {
+                const double log_ratio = 2 * std::log(z[k]) + lp_prop[k] - lp[self + k];   // z^(d-1), d = 3
+                if (std::log(U(rng[self + k])) < log_ratio) {
+                    x[self + k] = proposal[k];
+                    lp[self + k] = lp_prop[k];
+                    ++accepted;
+                }
+                ++proposed;
+            }
+        }
+        if (it < opt.burn_in || (it - opt.burn_in) % std::max(opt.thin, 1) != 0) {
+            continue;
+        }
+        for (int w = 0; w < W; ++w) {
+            res.samples.push_back({x[w], lp[w]});
+            for (int i = 0; i < 3; ++i) {
+                sum[i] += x[w][i];
+                sum_sq[i] += x[w][i] * x[w][i];
+            }
+        }
+        if (predict && on_predictive) {
+            pred_lanes.resize(W);
+            for (int w = 0; w < W; ++w) {
+                DesignInputs<double> d = *predict;
+                detail::applyBayesianTheta(d, x[w]);
+                pred_lanes.set(w, d);
+            }
+            evaluateBatch(pred_lanes, pred_out, fluid);
+            for (int w = 0; w < W; ++w) {
+                on_predictive({pred_out.Q_max[w], pred_out.delta_T[w]});
+            }
+        }
+    }
+    const double n = static_cast<double>(res.samples.size());
+    for (int i = 0; i < 3 && n > 0; ++i) {
+        res.mean[i] = sum[i] / n;
+        res.std_dev[i] = std::sqrt(std::max(0.0, sum_sq[i] / n - res.mean[i] * res.mean[i]));
+    }
+    res.acceptance_rate = proposed > 0 ? static_cast<double>(accepted) / proposed : 0;
+    return res;
+}
+
+}  // namespace vc
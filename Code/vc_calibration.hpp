@@ -0,0 +1,347 @@
+#pragma once
+// Least-squares calibration of the resistance network against test data.
+//
+// Fits experimental_correction_factor, R_phase_change and, optionally, the
+// wick / wall resistance multipliers so that Q_in * R_total_corrected matches
+// measured delta_T plateaus (see vc_csv_stream.hpp). Jacobians come from
+// evaluateModel<Dual<4>>, so any parameter that enters the model is exact.
+//
+// Two entry points:
+//   calibratePooled() - one parameter set shared by every run, by default
+//                       the correction factor and R_phase_change. Residuals
+//                       and Jacobian rows are summed over fixed blocks of
+//                       runs across threads. With runs of different designs
+//                       this is the fit that separates the two.
+//   calibrateRuns()   - an independent Levenberg-Marquardt fit per run, the
+//                       runs batched across threads. A single design's
+//                       delta_T(Q) only fixes the product
+//                       factor * R_total_ideal, so fit one parameter per run
+//                       (the default there) unless prior_weight > 0.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_dual.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+struct TestRun {
+    DesignInputs<double> design;
+    std::vector<double> Q_in;      // Steady heater powers [W]
+    std::vector<double> delta_T;   // Measured temperature drops [K]
+    std::vector<double> weight;    // Optional per-point weights (1 / sigma); empty = all 1
+    double Q_max_observed = std::nan("");   // Observed dryout power, if the run reached it [W]
+    double Q_max_sigma = 5;                 // Its uncertainty [W]
+};
+
+struct CalibrationParameters {
+    static constexpr int kCount = 4;
+    enum Index { CorrectionFactor = 0, PhaseChange = 1, WickMultiplier = 2, WallMultiplier = 3 };
+
+    std::array<double, kCount> value{1.2, 0.01, 1, 1};
+
+    double& operator[](int i) { return value[i]; }
+    double operator[](int i) const { return value[i]; }
+
+    // Copies the parameters into a design.
+    template <class T>
+    void apply(DesignInputs<T>& d) const {
+        d.experimental_correction_factor = T(value[CorrectionFactor]);
+        d.R_phase_change = T(value[PhaseChange]);
+        d.wick_resistance_multiplier = T(value[WickMultiplier]);
+        d.wall_resistance_multiplier = T(value[WallMultiplier]);
+    }
+};
+
+struct CalibrationOptions {
+    // Bit i set = fit parameter i. 0 = the entry point's default: the
+    // correction factor and R_phase_change for calibratePooled(), the factor
+    // alone for calibrateRuns().
+    unsigned fit_mask = 0;
+    CalibrationParameters initial;
+    int max_iterations = 100;
+    double tolerance = 1e-10;      // Relative step / cost change for convergence
+    double lambda = 1e-3;          // Initial Levenberg-Marquardt damping
+    double prior_weight = 0;       // Tikhonov pull toward `initial` (relative units)
+};
+
+struct CalibrationResult {
+    CalibrationParameters params;
+    std::array<double, CalibrationParameters::kCount> std_error{};   // From (J^T J)^-1 * s^2, 0 if not fitted
+    double rms_residual = 0;   // [K]
+    int iterations = 0;
+    bool converged = false;
+};
+
+namespace detail {
+
+using CalDual = Dual<CalibrationParameters::kCount>;
+
+// Accumulates J^T J, J^T r and r^T r for one run at `p`.
+inline void accumulateRun(const TestRun& run, const CalibrationParameters& p, unsigned mask,
+                          std::array<double, 16>& JTJ, std::array<double, 4>& JTr, double& rr, std::size_t& count) {
+    DesignInputs<CalDual> d;
+#define VC_CAL_COPY_FIELD(name, value) d.name = CalDual(run.design.name);
+    VC_DESIGN_FIELDS(VC_CAL_COPY_FIELD)
+#undef VC_CAL_COPY_FIELD
+    d.experimental_correction_factor = CalDual::variable(p[0], 0);
+    d.R_phase_change = CalDual::variable(p[1], 1);
+    d.wick_resistance_multiplier = CalDual::variable(p[2], 2);
+    d.wall_resistance_multiplier = CalDual::variable(p[3], 3);
+    // delta_T is linear in Q_in, so one model evaluation serves every plateau of the run
+    d.Q_in = CalDual(1);
+    const CalDual R = evaluateModel(d).R_total_corrected;
+    for (std::size_t k = 0; k < run.Q_in.size(); ++k) {
+        const double w = run.weight.empty() ? 1 : run.weight[k];
+        const double r = w * (run.Q_in[k] * R.v - run.delta_T[k]);
+        std::array<double, 4> J{};
+        for (int i = 0; i < 4; ++i) {
+            J[i] = (mask >> i & 1u) ? w * run.Q_in[k] * R.d[i] : 0;
+        }
+        for (int i = 0; i < 4; ++i) {
+            JTr[i] += J[i] * r;
+            for (int j = 0; j < 4; ++j) {
+                JTJ[i * 4 + j] += J[i] * J[j];
+            }
+        }
+        rr += r * r;
+        ++count;
+    }
+}
+
+// Solves the (masked) 4x4 system A x = b by Gaussian elimination with partial pivoting.
+inline bool solveSmall(std::array<double, 16> A, std::array<double, 4> b, unsigned mask, std::array<double, 4>& x) {
+    for (int i = 0; i < 4; ++i) {
+        if (!(mask >> i & 1u)) {
+            for (int j = 0; j < 4; ++j) {
+                A[i * 4 + j] = A[j * 4 + i] = 0;
+            }
+            A[i * 4 + i] = 1;
+            b[i] = 0;
+        }
+    }
+    for (int c = 0; c < 4; ++c) {
+        int piv = c;
+        for (int r = c + 1; r < 4; ++r) {
+            if (std::fabs(A[r * 4 + c]) > std::fabs(A[piv * 4 + c])) {
+                piv = r;
+            }
+        }
+        if (A[piv * 4 + c] == 0) {
+            return false;
+        }
+        if (piv != c) {
+            for (int j = 0; j < 4; ++j) {
+                std::swap(A[c * 4 + j], A[piv * 4 + j]);
+            }
+            std::swap(b[c], b[piv]);
+        }
+        for (int r = c + 1; r < 4; ++r) {
+            const double f = A[r * 4 + c] / A[c * 4 + c];
+            for (int j = c; j < 4; ++j) {
+                A[r * 4 + j] -= f * A[c * 4 + j];
+            }
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = 3; r >= 0; --r) {
+        double s = b[r];
+        for (int j = r + 1; j < 4; ++j) {
+            s -= A[r * 4 + j] * x[j];
+        }
+        x[r] = s / A[r * 4 + r];
+    }
+    return true;
+}
+
+// Generic LM loop; `normal(p, JTJ, JTr, rr, n)` fills the normal equations at p.
+template <class NormalFn>
+CalibrationResult levenbergMarquardt(const CalibrationOptions& opt, NormalFn&& normal) {
+    CalibrationResult res;
+    CalibrationParameters p = opt.initial;
+    const unsigned mask = opt.fit_mask;
+
+    // Prior term: prior_weight * (p_i - p0_i) / scale_i for each fitted parameter
+    const auto addPrior = [&](const CalibrationParameters& q, std::array<double, 16>& JTJ, std::array<double, 4>& JTr,
+                              double& rr) {
+        if (opt.prior_weight <= 0) {
+            return;
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (mask >> i & 1u) {
+                const double scale = std::max(std::fabs(opt.initial[i]), 1e-12);
+                const double J = opt.prior_weight / scale;
+                const double r = J * (q[i] - opt.initial[i]);
+                JTJ[i * 4 + i] += J * J;
+                JTr[i] += J * r;
+                rr += r * r;
+            }
+        }
+    };
+    const auto system = [&](const CalibrationParameters& q, std::array<double, 16>& JTJ, std::array<double, 4>& JTr,
+                            double& rr, std::size_t& n) {
+        JTJ.fill(0);
+        JTr.fill(0);
+        rr = 0;
+        n = 0;
+        normal(q, JTJ, JTr, rr, n);
+        addPrior(q, JTJ, JTr, rr);
+    };
+
+    std::array<double, 16> JTJ;
+    std::array<double, 4> JTr;
+    double cost;
+    std::size_t n;
+    system(p, JTJ, JTr, cost, n);
+    double lambda = opt.lambda;
+    for (res.iterations = 0; res.iterations < opt.max_iterations; ++res.iterations) {
+        std::array<double, 16> A = JTJ;
+        for (int i = 0; i < 4; ++i) {
+            A[i * 4 + i] += lambda * std::max(JTJ[i * 4 + i], 1e-30);
+        }
+        std::array<double, 4> minus_g;
+        for (int i = 0; i < 4; ++i) {
+            minus_g[i] = -JTr[i];
+        }
+        std::array<double, 4> step{};
+        if (!solveSmall(A, minus_g, mask, step)) {
+            break;
+        }
+        CalibrationParameters trial = p;
+        double step_norm = 0;
+        double p_norm = 0;
+        for (int i = 0; i < 4; ++i) {
+            // Resistances and factors are physically non-negative
+            trial[i] = std::max(0.0, p[i] + step[i]);
+            step_norm += (trial[i] - p[i]) * (trial[i] - p[i]);
+            p_norm += p[i] * p[i];
+        }
+        std::array<double, 16> JTJ_t;
+        std::array<double, 4> JTr_t;
+        double cost_t;
+        std::size_t n_t;
+        system(trial, JTJ_t, JTr_t, cost_t, n_t);
+        if (cost_t < cost) {
+            const double drop = cost - cost_t;
+            p = trial;
+            JTJ = JTJ_t;
+            JTr = JTr_t;
+            cost = cost_t;
+            lambda = std::max(lambda / 3, 1e-12);
+            if (step_norm <= opt.tolerance * opt.tolerance * (p_norm + opt.tolerance) || drop <= opt.tolerance * cost) {
+                res.converged = true;
+                ++res.iterations;
+                break;
+            }
+        } else {
+            lambda *= 4;
+            if (lambda > 1e12) {
+                res.converged = true;   // No downhill step left: at a minimum to machine precision
+                break;
+            }
+        }
+    }
+    res.params = p;
+    res.rms_residual = n > 0 ? std::sqrt(cost / n) : 0;
+
+    // Standard errors from the unit-weight covariance s^2 (J^T J)^-1
+    int n_fit = 0;
+    for (int i = 0; i < 4; ++i) {
+        n_fit += (mask >> i & 1u) ? 1 : 0;
+    }
+    const double s2 = n > static_cast<std::size_t>(n_fit) ? cost / (n - n_fit) : 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!(mask >> i & 1u)) {
+            continue;
+        }
+        std::array<double, 4> e{};
+        e[i] = 1;
+        std::array<double, 4> col{};
+        if (solveSmall(JTJ, e, mask, col)) {
+            res.std_error[i] = std::sqrt(std::max(0.0, s2 * col[i]));
+        }
+    }
+    return res;
+}
+
+// Normal-equation sums of a block of runs.
+struct CalibrationSums {
+    std::array<double, 16> JTJ{};
+    std::array<double, 4> JTr{};
+    double rr = 0;
+    std::size_t count = 0;
+};
+
+// `opt` with a zero fit_mask replaced by `fallback`.
+inline CalibrationOptions withFitMask(CalibrationOptions opt, unsigned fallback) {
+    if (opt.fit_mask == 0) {
+        opt.fit_mask = fallback;
+    }
+    return opt;
+}
+
+}  // namespace detail
+
+// One parameter set fitted to all runs together.
+inline CalibrationResult calibratePooled(const std::vector<TestRun>& runs,
+                                         const CalibrationOptions& options = CalibrationOptions{}) {
+    const CalibrationOptions opt = detail::withFitMask(
+        options, 1u << CalibrationParameters::CorrectionFactor | 1u << CalibrationParameters::PhaseChange);
+    // Runs per partial sum. Blocks are fixed and reduced in order, so the
+    // result does not depend on the thread count.
+    constexpr std::size_t kBlock = 64;
+    const std::size_t n_blocks = (runs.size() + kBlock - 1) / kBlock;
+    std::vector<detail::CalibrationSums> blocks(n_blocks);
+    return detail::levenbergMarquardt(opt, [&](const CalibrationParameters& p, std::array<double, 16>& JTJ,
+                                               std::array<double, 4>& JTr, double& rr, std::size_t& n) {
+        parallelFor(
+            n_blocks,
+            [&](std::size_t b_begin, std::size_t b_end, unsigned) {
+                for (std::size_t b = b_begin; b < b_end; ++b) {
+                    detail::CalibrationSums& s = blocks[b];
+                    s = detail::CalibrationSums{};
+                    for (std::size_t r = b * kBlock; r < std::min(runs.size(), (b + 1) * kBlock); ++r) {
+                        detail::accumulateRun(runs[r], p, opt.fit_mask, s.JTJ, s.JTr, s.rr, s.count);
+                    }
+                }
+            },
+            1);
+        for (const detail::CalibrationSums& s : blocks) {
+            for (int k = 0; k < 16; ++k) {
+                JTJ[k] += s.JTJ[k];
+            }
+            for (int k = 0; k < 4; ++k) {
+                JTr[k] += s.JTr[k];
+            }
+            rr += s.rr;
+            n += s.count;
+        }
+    });
+}
+
+// Independent fit per run, runs spread across threads.
+inline std::vector<CalibrationResult> calibrateRuns(const std::vector<TestRun>& runs,
+                                                    const CalibrationOptions& options = CalibrationOptions{}) {
+    const CalibrationOptions opt = detail::withFitMask(options, 1u << CalibrationParameters::CorrectionFactor);
+    std::vector<CalibrationResult> results(runs.size());
+    parallelFor(
+        runs.size(),
+        [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t r = begin; r < end; ++r) {
+                results[r] = detail::levenbergMarquardt(
+                    opt, [&](const CalibrationParameters& p, std::array<double, 16>& JTJ, std::array<double, 4>& JTr,
+                             double& rr, std::size_t& n) {
+                        detail::accumulateRun(runs[r], p, opt.fit_mask, JTJ, JTr, rr, n);
+                    });
+            }
+        },
+        8);
+    return results;
+}
+
+}  // namespace vc
@@ -0,0 +1,317 @@
+#pragma once
+// Streaming ingestion of thermocouple logs (Experiment/Data/*.csv) with online
+// steady-state detection per heater power step.
+//
+// The file is read in fixed-size chunks and parsed in place, touching only the
+// columns that are asked for, so memory stays constant for multi-gigabyte
+// campaigns. Each row is reduced to (t, Q, delta_T) where delta_T is the mean
+// of the hot-side channels minus the mean of the cold-side channels, i.e. the
+// quantity the model reports as delta_T.
+//
+// A plateau is steady while, over the trailing window, the least-squares
+// slope of delta_T is below max_slope, its standard deviation is below
+// max_std and the heater power stays within power_tolerance of the step. One
+// SteadyPlateau is emitted per power step that reached steady state, averaged
+// over the steady samples only.
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace vc {
+
+struct ThermocoupleColumns {
+    std::string time = "time_s";
+    std::string power = "power_W";
+    std::vector<std::string> hot;    // Evaporator / heater-side thermocouples
+    std::vector<std::string> cold;   // Condenser / cold-plate-side thermocouples
+};
+
+struct SteadyStateOptions {
+    double window_s = 120;          // Trailing window for the steadiness test [s]
+    double max_slope = 0.05;        // [K/min]
+    double max_std = 0.1;           // [K]
+    double power_tolerance = 0.5;   // Power change that starts a new step [W]
+    std::size_t min_samples = 10;   // Samples needed in the window before testing
+};
+
+struct SteadyPlateau {
+    double Q_in = 0;         // Mean heater power over the steady samples [W]
+    double delta_T = 0;      // Mean hot-minus-cold temperature [K]
+    double delta_T_std = 0;  // Standard deviation over the steady samples [K]
+    double t_start = 0;      // First steady sample [s]
+    double t_end = 0;        // Last steady sample [s]
+    std::size_t samples = 0;
+};
+
+// Online plateau detector. push() samples in time order; plateaus are handed
+// to the callback as soon as the power step that produced them ends.
+class SteadyStateDetector {
+public:
+    using Callback = std::function<void(const SteadyPlateau&)>;
+
+    SteadyStateDetector(const SteadyStateOptions& opt, Callback emit) : opt_(opt), emit_(std::move(emit)) {}
+
+    void push(double t, double Q, double dT) {
+        if (window_.empty() || std::fabs(Q - step_Q_) > opt_.power_tolerance) {
+            startStep(t, Q);
+        }
+        window_.push_back({t - t_ref_, dT});
+        add(window_.back(), 1);
+        while (window_.front().t < window_.back().t - opt_.window_s) {
+            add(window_.front(), -1);
+            window_.pop_front();
+        }
+        if (window_.size() >= opt_.min_samples && isSteady()) {
+            if (plateau_.samples == 0) {
+                plateau_.t_start = t;
+            }
+            plateau_.t_end = t;
+            ++plateau_.samples;
+            // Welford update of delta_T, running mean of Q
+            const double d = dT - plateau_.delta_T;
+            plateau_.delta_T += d / plateau_.samples;
+            m2_ += d * (dT - plateau_.delta_T);
+            plateau_.Q_in += (Q - plateau_.Q_in) / plateau_.samples;
+        }
+    }
+
+    // Flushes the plateau of the final step.
+    void finish() {
+        flush();
+        window_.clear();
+    }
+
+private:
+    struct Sample {
+        double t;
+        double y;
+    };
+
+    void add(const Sample& s, double sign) {
+        n_ += sign;
+        st_ += sign * s.t;
+        stt_ += sign * s.t * s.t;
+        sy_ += sign * s.y;
+        syy_ += sign * s.y * s.y;
+        sty_ += sign * s.t * s.y;
+    }
+
+    bool isSteady() const {
+        const double var_t = stt_ - st_ * st_ / n_;
+        const double cov = sty_ - st_ * sy_ / n_;
+        const double var_y = std::max(0.0, (syy_ - sy_ * sy_ / n_) / n_);
+        const double slope_per_min = var_t > 0 ? 60 * cov / var_t : 0;
+        return std::fabs(slope_per_min) <= opt_.max_slope && std::sqrt(var_y) <= opt_.max_std;
+    }
+
+    void flush() {
+        if (plateau_.samples > 0 && emit_) {
+            plateau_.delta_T_std = plateau_.samples > 1 ? std::sqrt(m2_ / (plateau_.samples - 1)) : 0;
+            emit_(plateau_);
+        }
+        plateau_ = SteadyPlateau{};
+        m2_ = 0;
+    }
+
+    void startStep(double t, double Q) {
+        flush();
+        window_.clear();
+        n_ = st_ = stt_ = sy_ = syy_ = sty_ = 0;
+        step_Q_ = Q;
+        t_ref_ = t;   // Window sums are kept relative to the step start for precision
+    }
+
+    SteadyStateOptions opt_;
+    Callback emit_;
+    std::deque<Sample> window_;
+    double n_ = 0, st_ = 0, stt_ = 0, sy_ = 0, syy_ = 0, sty_ = 0;
+    double step_Q_ = 0;
+    double t_ref_ = 0;
+    SteadyPlateau plateau_;
+    double m2_ = 0;
+};
+
+// Chunked CSV reader. Calls fn(fields) for every data row with the requested
+// columns parsed to double (NaN when a field is empty or not numeric).
+// Surrounding spaces and double quotes are stripped from header names and
+// values; a header may be requested more than once.
+class CsvStreamReader {
+public:
+    explicit CsvStreamReader(const std::string& path, std::size_t chunk_bytes = 4 << 20, char delimiter = ',')
+        : file_(std::fopen(path.c_str(), "rb")), chunk_(chunk_bytes), delim_(delimiter) {
+        if (!file_) {
+            throw std::runtime_error("cannot open " + path);
+        }
+    }
+
+    ~CsvStreamReader() {
+        if (file_) {
+            std::fclose(file_);
+        }
+    }
+
+    CsvStreamReader(const CsvStreamReader&) = delete;
+    CsvStreamReader& operator=(const CsvStreamReader&) = delete;
+
+    // Streams the file. `columns` are header names to extract, in output order.
+    template <class Fn>
+    void forEachRow(const std::vector<std::string>& columns, Fn&& fn) {
+        std::vector<char> buf(chunk_);
+        std::string carry;
+        std::vector<std::vector<int>> slot;   // header index -> output slots (empty = skip)
+        std::vector<double> values(columns.size());
+        bool have_header = false;
+        const auto handleLine = [&](const char* begin, const char* end) {
+            if (end > begin && end[-1] == '\r') {
+                --end;
+            }
+            if (begin == end) {
+                return;
+            }
+            if (!have_header) {
+                slot = mapHeader(begin, end, columns);
+                have_header = true;
+                return;
+            }
+            parseRow(begin, end, slot, values);
+            fn(values);
+        };
+        std::size_t got;
+        while ((got = std::fread(buf.data(), 1, buf.size(), file_)) > 0) {
+            const char* p = buf.data();
+            const char* end = p + got;
+            while (p < end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!nl) {
+                    carry.append(p, end);
+                    break;
+                }
+                if (!carry.empty()) {
+                    carry.append(p, nl);
+                    handleLine(carry.data(), carry.data() + carry.size());
+                    carry.clear();
+                } else {
+                    handleLine(p, nl);
+                }
+                p = nl + 1;
+            }
+        }
+        if (!carry.empty()) {
+            handleLine(carry.data(), carry.data() + carry.size());
+        }
+    }
+
+private:
+    static void trim(const char*& b, const char*& e) {
+        while (b < e && (*b == ' ' || *b == '"')) {
+            ++b;
+        }
+        while (e > b && (e[-1] == ' ' || e[-1] == '"')) {
+            --e;
+        }
+    }
+
+    std::vector<std::vector<int>> mapHeader(const char* b, const char* e, const std::vector<std::string>& columns) const {
+        std::vector<std::vector<int>> slot;
+        std::vector<bool> found(columns.size(), false);
+        while (true) {
+            const char* f = static_cast<const char*>(std::memchr(b, delim_, e - b));
+            const char* nb = b;
+            const char* ne = f ? f : e;
+            trim(nb, ne);
+            const std::string name(nb, ne);
+            std::vector<int> s;
+            for (std::size_t c = 0; c < columns.size(); ++c) {
+                if (columns[c] == name && !found[c]) {
+                    s.push_back(static_cast<int>(c));
+                    found[c] = true;
+                }
+            }
+            slot.push_back(std::move(s));
+            if (!f) {
+                break;
+            }
+            b = f + 1;
+        }
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            if (!found[c]) {
+                throw std::runtime_error("CSV column not found: " + columns[c]);
+            }
+        }
+        return slot;
+    }
+
+    void parseRow(const char* b, const char* e, const std::vector<std::vector<int>>& slot,
+                  std::vector<double>& values) const {
+        std::fill(values.begin(), values.end(), std::nan(""));
+        for (std::size_t idx = 0; idx < slot.size() && b <= e; ++idx) {
+            const char* f = static_cast<const char*>(std::memchr(b, delim_, e - b));
+            const char* fe = f ? f : e;
+            if (!slot[idx].empty()) {
+                const char* vb = b;
+                const char* ve = fe;
+                trim(vb, ve);
+                double v;
+                const std::from_chars_result r = std::from_chars(vb, ve, v);
+                // Only a field that is wholly a number: "12.5abc" or "1.0 K" stay NaN
+                if (r.ec == std::errc() && r.ptr == ve) {
+                    for (int s : slot[idx]) {
+                        values[s] = v;
+                    }
+                }
+            }
+            if (!f) {
+                break;
+            }
+            b = f + 1;
+        }
+    }
+
+    std::FILE* file_;
+    std::size_t chunk_;
+    char delim_;
+};
+
+// Reads a thermocouple log and returns one (Q_in, delta_T) plateau per steady power step.
+inline std::vector<SteadyPlateau> extractSteadyPlateaus(const std::string& path, const ThermocoupleColumns& cols,
+                                                        const SteadyStateOptions& opt = SteadyStateOptions{}) {
+    std::vector<std::string> names{cols.time, cols.power};
+    names.insert(names.end(), cols.hot.begin(), cols.hot.end());
+    names.insert(names.end(), cols.cold.begin(), cols.cold.end());
+    const std::size_t n_hot = cols.hot.size();
+    const std::size_t n_cold = cols.cold.size();
+    if (n_hot == 0 || n_cold == 0) {
+        throw std::invalid_argument("need at least one hot and one cold thermocouple column");
+    }
+
+    std::vector<SteadyPlateau> plateaus;
+    SteadyStateDetector detector(opt, [&plateaus](const SteadyPlateau& p) { plateaus.push_back(p); });
+    CsvStreamReader reader(path);
+    reader.forEachRow(names, [&](const std::vector<double>& v) {
+        double hot = 0;
+        double cold = 0;
+        for (std::size_t c = 0; c < n_hot; ++c) {
+            hot += v[2 + c];
+        }
+        for (std::size_t c = 0; c < n_cold; ++c) {
+            cold += v[2 + n_hot + c];
+        }
+        const double dT = hot / n_hot - cold / n_cold;
+        if (std::isfinite(v[0]) && std::isfinite(v[1]) && std::isfinite(dT)) {
+            detector.push(v[0], v[1], dT);
+        }
+    });
+    detector.finish();
+    return plateaus;
+}
+
+}  // namespace vc
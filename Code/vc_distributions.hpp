@@ -0,0 +1,157 @@
+#pragma once
+// Input distributions for sampling studies, applied by inverse CDF so that
+// quasi-random points in [0, 1)^d keep their low-discrepancy structure.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_qmc.hpp"
+
+namespace vc {
+
+// Inverse standard normal CDF (Acklam's rational approximation, |rel err| < 1.2e-9).
+inline double inverseNormalCdf(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double p_low = 0.02425;
+    p = std::min(std::max(p, 1e-300), 1 - 1e-16);
+    if (p < p_low) {
+        const double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    if (p > 1 - p_low) {
+        const double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    const double q = p - 0.5;
+    const double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+inline double normalCdf(double z) {
+    return 0.5 * std::erfc(-z * M_SQRT1_2);
+}
+
+struct InputDistribution {
+    enum Kind { Uniform, Normal, LogNormal, Triangular };
+    Kind kind = Uniform;
+    double p1 = 0;   // Uniform: lo     Normal: mean   LogNormal: median  Triangular: lo
+    double p2 = 1;   // Uniform: hi     Normal: sigma  LogNormal: sigma of ln  Triangular: mode
+    double p3 = 0;   //                                                     Triangular: hi
+
+    static InputDistribution uniform(double lo, double hi) { return {Uniform, lo, hi, 0}; }
+    static InputDistribution normal(double mean, double sigma) { return {Normal, mean, sigma, 0}; }
+    static InputDistribution logNormal(double median, double sigma_ln) { return {LogNormal, median, sigma_ln, 0}; }
+    static InputDistribution triangular(double lo, double mode, double hi) { return {Triangular, lo, mode, hi}; }
+
+    // Maps u in (0, 1) to a value of the distribution.
+    double quantile(double u) const {
+        switch (kind) {
+            case Uniform:
+                return p1 + u * (p2 - p1);
+            case Normal:
+                return p1 + p2 * inverseNormalCdf(u);
+            case LogNormal:
+                return p1 * std::exp(p2 * inverseNormalCdf(u));
+            case Triangular: {
+                const double f = (p2 - p1) / (p3 - p1);
+                return u < f ? p1 + std::sqrt(u * (p3 - p1) * (p2 - p1))
+                             : p3 - std::sqrt((1 - u) * (p3 - p1) * (p3 - p2));
+            }
+        }
+        return p1;
+    }
+
+    // Inverse of quantile().
+    double cdf(double x) const {
+        switch (kind) {
+            case Uniform:
+                return (x - p1) / (p2 - p1);
+            case Normal:
+                return normalCdf((x - p1) / p2);
+            case LogNormal:
+                return x > 0 ? normalCdf(std::log(x / p1) / p2) : 0;
+            case Triangular:
+                if (x <= p1) {
+                    return 0;
+                }
+                if (x >= p3) {
+                    return 1;
+                }
+                return x < p2 ? sq(x - p1) / ((p3 - p1) * (p2 - p1)) : 1 - sq(p3 - x) / ((p3 - p1) * (p3 - p2));
+        }
+        return 0;
+    }
+};
+
+// One uncertain design input and its distribution.
+struct UncertainInput {
+    double DesignInputs<double>::*field;
+    InputDistribution dist;
+    std::string name;
+    std::vector<double> DesignBatch<double>::*column;   // Same field as a batch column
+};
+
+inline UncertainInput uncertainInput(const std::string& name, const InputDistribution& dist) {
+    return {designField(name), dist, name, designColumn<double>(name)};
+}
+
+// Writes u (one value per uncertain input) into `d` through the inverse CDFs.
+inline void applyUncertainInputs(const std::vector<UncertainInput>& inputs, const double* u, DesignInputs<double>& d) {
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        d.*(inputs[i].field) = inputs[i].dist.quantile(u[i]);
+    }
+}
+
+// Fills `batch` with points first_index, first_index + 1, ... of a
+// quasi-random sequence (SobolSequence or HaltonSequence with
+// inputs.size() dimensions), mapped through the input distributions. Fields
+// not listed in `inputs` are set to `nominal`. Each worker copies `sequence`,
+// seeks to its own lane range and writes its columns block by block, so the
+// full sample matrix never exists and the result does not depend on the
+// thread count.
+template <class Sequence>
+void sampleDesignBatch(const Sequence& sequence, std::uint64_t first_index, std::size_t count,
+                       const DesignInputs<double>& nominal, const std::vector<UncertainInput>& inputs,
+                       DesignBatch<double>& batch) {
+    constexpr std::size_t kBlock = 1024;
+    const std::size_t d = inputs.size();
+    checkSequenceRange(sequence, first_index, count, "sampleDesignBatch");
+    batch.resize(0);
+    batch.resize(count, nominal);
+    parallelFor(count, [&](std::size_t begin, std::size_t end, unsigned) {
+        Sequence seq = sequence;
+        seq.seek(first_index + begin);
+        std::vector<double> u(d * kBlock);
+        for (std::size_t b0 = begin; b0 < end; b0 += kBlock) {
+            const std::size_t n = std::min(kBlock, end - b0);
+            seq.fillBlock(n, u.data(), kBlock);
+            for (std::size_t i = 0; i < d; ++i) {
+                const InputDistribution& dist = inputs[i].dist;
+                const double* src = &u[i * kBlock];
+                double* dst = (batch.*(inputs[i].column)).data() + b0;
+                for (std::size_t j = 0; j < n; ++j) {
+                    dst[j] = dist.quantile(src[j]);
+                }
+            }
+        }
+    }, kBlock);
+}
+
+}  // namespace vc
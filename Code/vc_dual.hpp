@@ -0,0 +1,102 @@
+#pragma once
+// Forward-mode automatic differentiation.
+// Dual<N> carries a value and its gradient with respect to N seeded inputs;
+// evaluateModel<Dual<N>> therefore returns every output together with its
+// exact partial derivatives in one pass.
+
+#include <array>
+#include <cmath>
+
+namespace vc {
+
+template <int N>
+struct Dual {
+    double v = 0;
+    std::array<double, N> d{};
+
+    Dual() = default;
+    Dual(double value) : v(value) {}
+
+    // Independent variable number `index`
+    static Dual variable(double value, int index) {
+        Dual x(value);
+        x.d[index] = 1;
+        return x;
+    }
+
+    friend Dual operator+(const Dual& a, const Dual& b) {
+        Dual r(a.v + b.v);
+        for (int i = 0; i < N; ++i) {
+            r.d[i] = a.d[i] + b.d[i];
+        }
+        return r;
+    }
+
+    friend Dual operator-(const Dual& a, const Dual& b) {
+        Dual r(a.v - b.v);
+        for (int i = 0; i < N; ++i) {
+            r.d[i] = a.d[i] - b.d[i];
+        }
+        return r;
+    }
+
+    friend Dual operator-(const Dual& a) {
+        Dual r(-a.v);
+        for (int i = 0; i < N; ++i) {
+            r.d[i] = -a.d[i];
+        }
+        return r;
+    }
+
+    friend Dual operator*(const Dual& a, const Dual& b) {
+        Dual r(a.v * b.v);
+        for (int i = 0; i < N; ++i) {
+            r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+        }
+        return r;
+    }
+
+    friend Dual operator/(const Dual& a, const Dual& b) {
+        const double inv = 1 / b.v;
+        Dual r(a.v * inv);
+        for (int i = 0; i < N; ++i) {
+            r.d[i] = (a.d[i] - r.v * b.d[i]) * inv;
+        }
+        return r;
+    }
+
+    friend Dual& operator+=(Dual& a, const Dual& b) { return a = a + b; }
+    friend Dual& operator-=(Dual& a, const Dual& b) { return a = a - b; }
+    friend Dual& operator*=(Dual& a, const Dual& b) { return a = a * b; }
+    friend Dual& operator/=(Dual& a, const Dual& b) { return a = a / b; }
+
+    friend bool operator<(const Dual& a, const Dual& b) { return a.v < b.v; }
+    friend bool operator>(const Dual& a, const Dual& b) { return a.v > b.v; }
+    friend bool operator<=(const Dual& a, const Dual& b) { return a.v <= b.v; }
+    friend bool operator>=(const Dual& a, const Dual& b) { return a.v >= b.v; }
+
+    // Chain rule for a scalar function with value f and derivative df at a.v
+    static Dual chain(const Dual& a, double f, double df) {
+        Dual r(f);
+        for (int i = 0; i < N; ++i) {
+            r.d[i] = df * a.d[i];
+        }
+        return r;
+    }
+
+    friend Dual sin(const Dual& a) { return chain(a, std::sin(a.v), std::cos(a.v)); }
+    friend Dual cos(const Dual& a) { return chain(a, std::cos(a.v), -std::sin(a.v)); }
+    friend Dual exp(const Dual& a) {
+        const double e = std::exp(a.v);
+        return chain(a, e, e);
+    }
+    friend Dual log(const Dual& a) { return chain(a, std::log(a.v), 1 / a.v); }
+    friend Dual sqrt(const Dual& a) {
+        const double s = std::sqrt(a.v);
+        return chain(a, s, 0.5 / s);
+    }
+    friend Dual pow(const Dual& a, double p) { return chain(a, std::pow(a.v, p), p * std::pow(a.v, p - 1)); }
+    friend Dual fabs(const Dual& a) { return a.v < 0 ? -a : a; }
+};
+
+}  // namespace vc
@@ -0,0 +1,249 @@
+#pragma once
+// Adaptive tracing of the capillary limit dP_cap == dP_total.
+//
+// Two or three design inputs span a box. A coarse grid of cells is evaluated
+// first; a cell is split into 2^dims children only while its corners disagree
+// on the section 6 check (dP_cap >= dP_total), so evaluations concentrate on a
+// band around the boundary. Corner values live on the finest lattice and are
+// cached, so shared corners are evaluated once, and each refinement level is
+// evaluated as one DesignBatch through the batch kernel.
+//
+// Finest-level boundary cells are split into simplices (2 triangles per
+// square, 6 Kuhn tetrahedra per cube) and the zero level set of the margin
+// dP_cap - dP_total is interpolated linearly along simplex edges. That gives
+// line segments in 2D and triangles in 3D, with no ambiguous cases.
+//
+// The coarse grid must resolve the boundary's topology: a feasible pocket that
+// fits entirely inside one coarse cell without touching its corners is missed.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+
+namespace vc {
+
+struct BoundaryAxis {
+    std::string name;   // Design input, e.g. "Q_in" or "mesh_number_evap_wpi"
+    double lo = 0;
+    double hi = 1;
+};
+
+struct FeasibilityBoundaryOptions {
+    std::vector<BoundaryAxis> axes;   // 2 or 3
+    int coarse_cells = 8;             // Cells per axis on level 0
+    int max_level = 5;                // Finest cells are coarse / 2^max_level
+};
+
+struct FeasibilityBoundary {
+    int dims = 0;
+    // 2D: consecutive pairs are segments. 3D: consecutive triples are
+    // triangles. Unused coordinates are 0.
+    std::vector<std::array<double, 3>> points;
+    std::size_t boundary_cells = 0;        // Finest-level cells crossed by the boundary
+    std::size_t model_calls = 0;
+    std::size_t uniform_grid_calls = 0;    // Vertices of a uniform grid at the finest resolution
+};
+
+namespace detail {
+
+constexpr int kLatticeBits = 21;
+
+inline std::uint64_t latticeKey(const std::array<std::uint32_t, 3>& p) {
+    return (static_cast<std::uint64_t>(p[0]) << (2 * kLatticeBits)) |
+           (static_cast<std::uint64_t>(p[1]) << kLatticeBits) | p[2];
+}
+
+struct RefinementCell {
+    std::array<std::uint32_t, 3> origin;   // Finest-lattice units
+    int level;
+};
+
+}  // namespace detail
+
+// Traces dP_cap == dP_total over `opt.axes`; other inputs stay at `nominal`.
+inline FeasibilityBoundary refineCapillaryBoundary(const DesignInputs<double>& nominal,
+                                                   const FeasibilityBoundaryOptions& opt,
+                                                   const FluidProperties& fluid = FluidProperties{}) {
+    const int dims = static_cast<int>(opt.axes.size());
+    if (dims < 2 || dims > 3 || opt.coarse_cells < 1 || opt.max_level < 0) {
+        throw std::invalid_argument("refineCapillaryBoundary needs 2 or 3 axes");
+    }
+    const std::uint64_t fine_cells = static_cast<std::uint64_t>(opt.coarse_cells) << opt.max_level;
+    if (fine_cells >= (std::uint64_t{1} << detail::kLatticeBits)) {
+        throw std::invalid_argument("refineCapillaryBoundary: coarse_cells * 2^max_level too large");
+    }
+    std::vector<std::vector<double> DesignBatch<double>::*> columns;
+    for (const BoundaryAxis& a : opt.axes) {
+        columns.push_back(designColumn<double>(a.name));
+    }
+    const int n_corners = 1 << dims;
+    const auto coordinate = [&](int axis, double lattice) {
+        const BoundaryAxis& a = opt.axes[axis];
+        return a.lo + (a.hi - a.lo) * lattice / static_cast<double>(fine_cells);
+    };
+
+    FeasibilityBoundary res;
+    res.dims = dims;
+    res.uniform_grid_calls = 1;
+    for (int a = 0; a < dims; ++a) {
+        res.uniform_grid_calls *= fine_cells + 1;
+    }
+
+    std::unordered_map<std::uint64_t, double> margin;   // dP_cap - dP_total per lattice vertex
+    std::vector<detail::RefinementCell> active;
+    const std::uint32_t coarse_size = static_cast<std::uint32_t>(1u << opt.max_level);
+    for (int k = 0; k < (dims == 3 ? opt.coarse_cells : 1); ++k) {
+        for (int j = 0; j < opt.coarse_cells; ++j) {
+            for (int i = 0; i < opt.coarse_cells; ++i) {
+                active.push_back({{i * coarse_size, j * coarse_size, k * coarse_size}, 0});
+            }
+        }
+    }
+    const auto cornerOf = [&](const detail::RefinementCell& c, int k) {
+        const std::uint32_t size = coarse_size >> c.level;
+        std::array<std::uint32_t, 3> p = c.origin;
+        for (int a = 0; a < dims; ++a) {
+            p[a] += (k >> a & 1) * size;
+        }
+        return p;
+    };
+
+    DesignBatch<double> lanes;
+    OutputBatch<double> out;
+    std::vector<detail::RefinementCell> boundary;
+    while (!active.empty()) {
+        // --- Evaluate every corner not seen yet as one batch ---
+        std::vector<std::uint64_t> pending;
+        lanes.resize(0);
+        for (const detail::RefinementCell& c : active) {
+            for (int k = 0; k < n_corners; ++k) {
+                const std::array<std::uint32_t, 3> p = cornerOf(c, k);
+                const std::uint64_t key = detail::latticeKey(p);
+                if (margin.emplace(key, 0.0).second) {
+                    pending.push_back(key);
+                    DesignInputs<double> d = nominal;
+                    lanes.push_back(d);
+                    for (int a = 0; a < dims; ++a) {
+                        (lanes.*(columns[a])).back() = coordinate(a, p[a]);
+                    }
+                }
+            }
+        }
+        evaluateBatch(lanes, out, fluid);
+        res.model_calls += pending.size();
+        for (std::size_t n = 0; n < pending.size(); ++n) {
+            margin[pending[n]] = out.dP_cap[n] - out.dP_total[n];
+        }
+
+        // --- Split cells whose corners disagree ---
+        std::vector<detail::RefinementCell> next;
+        for (const detail::RefinementCell& c : active) {
+            int passes = 0;
+            for (int k = 0; k < n_corners; ++k) {
+                passes += margin[detail::latticeKey(cornerOf(c, k))] >= 0;
+            }
+            if (passes == 0 || passes == n_corners) {
+                continue;
+            }
+            if (c.level == opt.max_level) {
+                boundary.push_back(c);
+                continue;
+            }
+            const std::uint32_t half = (coarse_size >> c.level) / 2;
+            for (int k = 0; k < n_corners; ++k) {
+                detail::RefinementCell child{c.origin, c.level + 1};
+                for (int a = 0; a < dims; ++a) {
+                    child.origin[a] += (k >> a & 1) * half;
+                }
+                next.push_back(child);
+            }
+        }
+        active.swap(next);
+    }
+    res.boundary_cells = boundary.size();
+
+    // --- Zero level set on the simplices of each boundary cell ---
+    std::vector<std::array<int, 4>> simplices;
+    if (dims == 2) {
+        simplices = {{0, 1, 3, -1}, {0, 2, 3, -1}};
+    } else {
+        // Kuhn triangulation: one tetrahedron per ordering of the axes along 0 -> 7
+        const int perms[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+        for (const auto& p : perms) {
+            const int v1 = 1 << p[0];
+            const int v2 = v1 | 1 << p[1];
+            simplices.push_back({0, v1, v2, 7});
+        }
+    }
+    const int simplex_size = dims + 1;
+    for (const detail::RefinementCell& c : boundary) {
+        std::array<std::array<double, 3>, 8> x{};
+        std::array<double, 8> m{};
+        for (int k = 0; k < n_corners; ++k) {
+            const std::array<std::uint32_t, 3> p = cornerOf(c, k);
+            m[k] = margin[detail::latticeKey(p)];
+            for (int a = 0; a < dims; ++a) {
+                x[k][a] = coordinate(a, p[a]);
+            }
+        }
+        const auto crossing = [&](int a, int b) {
+            // NaN margins (model outside its domain) cross at the edge midpoint
+            double t = m[a] / (m[a] - m[b]);
+            if (!(t >= 0 && t <= 1)) {
+                t = 0.5;
+            }
+            std::array<double, 3> q{};
+            for (int i = 0; i < dims; ++i) {
+                q[i] = x[a][i] + t * (x[b][i] - x[a][i]);
+            }
+            return q;
+        };
+        for (const std::array<int, 4>& s : simplices) {
+            std::array<int, 4> in{};
+            std::array<int, 4> outv{};
+            int n_in = 0;
+            int n_out = 0;
+            for (int v = 0; v < simplex_size; ++v) {
+                if (m[s[v]] >= 0) {
+                    in[n_in++] = s[v];
+                } else {
+                    outv[n_out++] = s[v];
+                }
+            }
+            if (n_in == 0 || n_out == 0) {
+                continue;
+            }
+            if (dims == 2) {
+                // One vertex on its own side: the segment joins its two edges
+                const int lone = n_in == 1 ? in[0] : outv[0];
+                const int* other = n_in == 1 ? outv.data() : in.data();
+                res.points.push_back(crossing(lone, other[0]));
+                res.points.push_back(crossing(lone, other[1]));
+            } else if (n_in == 1 || n_out == 1) {
+                const int lone = n_in == 1 ? in[0] : outv[0];
+                const int* other = n_in == 1 ? outv.data() : in.data();
+                res.points.push_back(crossing(lone, other[0]));
+                res.points.push_back(crossing(lone, other[1]));
+                res.points.push_back(crossing(lone, other[2]));
+            } else {
+                // Two on each side: quad a0b0, a0b1, a1b1, a1b0 as two triangles
+                const std::array<double, 3> q0 = crossing(in[0], outv[0]);
+                const std::array<double, 3> q1 = crossing(in[0], outv[1]);
+                const std::array<double, 3> q2 = crossing(in[1], outv[1]);
+                const std::array<double, 3> q3 = crossing(in[1], outv[0]);
+                res.points.insert(res.points.end(), {q0, q1, q2, q0, q2, q3});
+            }
+        }
+    }
+    return res;
+}
+
+}  // namespace vc
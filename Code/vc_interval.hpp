@@ -0,0 +1,448 @@
+#pragma once
+// Interval mode of the 1D model.
+// evaluateModel<Interval> maps an input box (tolerance stack) to enclosures of
+// every output. Each arithmetic result is widened outward by one ulp so the
+// enclosure stays rigorous under round-to-nearest. Sub-formulas that are
+// known to be monotone on their physical domain are evaluated at the box
+// corners instead of term by term, which removes the dependency blow-up of
+// naive interval arithmetic (e.g. epsilon appearing in both the numerator
+// and the denominator of the Kozeny-Carman permeability).
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+
+namespace vc {
+
+// std::nextafter(x, -inf) and std::nextafter(x, +inf), stepping the bit
+// pattern without a library call so the packed kernels below stay in
+// registers. NaN and the infinity in the step direction are returned as is.
+inline double roundDown(double x) {
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof u);
+    u = x == 0 ? 0x8000000000000001ull : x > 0 ? u - 1 : u + 1;
+    double r;
+    std::memcpy(&r, &u, sizeof r);
+    return x > -std::numeric_limits<double>::infinity() ? r : x;
+}
+
+inline double roundUp(double x) {
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof u);
+    u = x == 0 ? 1ull : x > 0 ? u + 1 : u - 1;
+    double r;
+    std::memcpy(&r, &u, sizeof r);
+    return x < std::numeric_limits<double>::infinity() ? r : x;
+}
+
+struct Interval {
+    double lo = 0;
+    double hi = 0;
+
+    Interval() = default;
+    Interval(double x) : lo(x), hi(x) {}
+    Interval(double l, double h) : lo(l), hi(h) {}
+
+    static Interval entire() {
+        const double inf = std::numeric_limits<double>::infinity();
+        return {-inf, inf};
+    }
+
+    double mid() const { return 0.5 * (lo + hi); }
+    double width() const { return hi - lo; }
+    bool contains(double x) const { return lo <= x && x <= hi; }
+    bool isDegenerate() const { return lo == hi; }
+};
+
+inline Interval operator+(const Interval& a, const Interval& b) {
+    return {roundDown(a.lo + b.lo), roundUp(a.hi + b.hi)};
+}
+
+inline Interval operator-(const Interval& a, const Interval& b) {
+    return {roundDown(a.lo - b.hi), roundUp(a.hi - b.lo)};
+}
+
+inline Interval operator-(const Interval& a) {
+    return {-a.hi, -a.lo};
+}
+
+inline Interval operator*(const Interval& a, const Interval& b) {
+    const double p1 = a.lo * b.lo;
+    const double p2 = a.lo * b.hi;
+    const double p3 = a.hi * b.lo;
+    const double p4 = a.hi * b.hi;
+    return {roundDown(std::min(std::min(p1, p2), std::min(p3, p4))),
+            roundUp(std::max(std::max(p1, p2), std::max(p3, p4)))};
+}
+
+// Entire when b contains zero; selected rather than branched on, so packed
+// division stays straight-line.
+inline Interval operator/(const Interval& a, const Interval& b) {
+    const double q1 = a.lo / b.lo;
+    const double q2 = a.lo / b.hi;
+    const double q3 = a.hi / b.lo;
+    const double q4 = a.hi / b.hi;
+    const bool spans_zero = b.lo <= 0 && b.hi >= 0;
+    const double inf = std::numeric_limits<double>::infinity();
+    return {spans_zero ? -inf : roundDown(std::min(std::min(q1, q2), std::min(q3, q4))),
+            spans_zero ? inf : roundUp(std::max(std::max(q1, q2), std::max(q3, q4)))};
+}
+
+inline Interval& operator+=(Interval& a, const Interval& b) { return a = a + b; }
+inline Interval& operator-=(Interval& a, const Interval& b) { return a = a - b; }
+inline Interval& operator*=(Interval& a, const Interval& b) { return a = a * b; }
+inline Interval& operator/=(Interval& a, const Interval& b) { return a = a / b; }
+
+// Hull of two intervals
+inline Interval hull(const Interval& a, const Interval& b) {
+    return {std::min(a.lo, b.lo), std::max(a.hi, b.hi)};
+}
+
+// sin over [lo, hi]: endpoints plus any interior extremum at pi/2 + k*pi.
+inline Interval sin(const Interval& x) {
+    if (!(x.width() < 2 * M_PI)) {
+        return {-1, 1};
+    }
+    const double s_lo = std::sin(x.lo);
+    const double s_hi = std::sin(x.hi);
+    double lo = roundDown(std::min(s_lo, s_hi));
+    double hi = roundUp(std::max(s_lo, s_hi));
+    // Maxima at pi/2 + 2k*pi, minima at -pi/2 + 2k*pi
+    const double k_max = std::ceil((x.lo - M_PI / 2) / (2 * M_PI));
+    if (M_PI / 2 + 2 * M_PI * k_max <= roundUp(x.hi)) {
+        hi = 1;
+    }
+    const double k_min = std::ceil((x.lo + M_PI / 2) / (2 * M_PI));
+    if (-M_PI / 2 + 2 * M_PI * k_min <= roundUp(x.hi)) {
+        lo = -1;
+    }
+    return {std::max(lo, -1.0), std::min(hi, 1.0)};
+}
+
+// cos over [lo, hi]: endpoints plus any interior extremum at k*pi.
+inline Interval cos(const Interval& x) {
+    if (!(x.width() < 2 * M_PI)) {
+        return {-1, 1};
+    }
+    const double c_lo = std::cos(x.lo);
+    const double c_hi = std::cos(x.hi);
+    double lo = roundDown(std::min(c_lo, c_hi));
+    double hi = roundUp(std::max(c_lo, c_hi));
+    // Maxima at 2k*pi, minima at pi + 2k*pi
+    const double k_max = std::ceil(x.lo / (2 * M_PI));
+    if (2 * M_PI * k_max <= roundUp(x.hi)) {
+        hi = 1;
+    }
+    const double k_min = std::ceil((x.lo - M_PI) / (2 * M_PI));
+    if (M_PI + 2 * M_PI * k_min <= roundUp(x.hi)) {
+        lo = -1;
+    }
+    return {std::max(lo, -1.0), std::min(hi, 1.0)};
+}
+
+// --- Monotonicity-aware overloads of the screen mesh correlations ---
+// Each is evaluated on degenerate corner intervals (so rounding stays
+// outward) and the enclosure is the hull of the extreme corners. Outside the
+// domain where monotonicity holds they fall back to term-by-term evaluation.
+
+// K(d, eps, C) = d^2 eps^3 / (C (1 - eps)^2) is increasing in d > 0 and in eps on (0, 1),
+// decreasing in C > 0.
+inline Interval screenPermeability(const Interval& d_w, const Interval& epsilon, const Interval& kc_constant) {
+    const auto eval = [](const Interval& d, const Interval& e, const Interval& c) {
+        return (sq(d) * cube(e)) / (c * sq(1 - e));
+    };
+    if (d_w.lo > 0 && epsilon.lo > 0 && epsilon.hi < 1 && kc_constant.lo > 0) {
+        return {eval(Interval(d_w.lo), Interval(epsilon.lo), Interval(kc_constant.hi)).lo,
+                eval(Interval(d_w.hi), Interval(epsilon.hi), Interval(kc_constant.lo)).hi};
+    }
+    return eval(d_w, epsilon, kc_constant);
+}
+
+// Maxwell-type k_eff is decreasing in eps and increasing in k_shell when k_shell > k_l.
+inline Interval effectiveWickConductivity(const Interval& epsilon, const Interval& k_shell, double k_l) {
+    const auto eval = [k_l](const Interval& e, const Interval& ks) {
+        return k_l * ((ks + k_l + (1 - e) * (ks - k_l)) / (ks + k_l - (1 - e) * (ks - k_l)));
+    };
+    if (epsilon.lo >= 0 && epsilon.hi <= 1 && k_shell.lo > k_l) {
+        return {eval(Interval(epsilon.hi), Interval(k_shell.lo)).lo,
+                eval(Interval(epsilon.lo), Interval(k_shell.hi)).hi};
+    }
+    return eval(epsilon, k_shell);
+}
+
+// d_h = 2 t w / (t + w) is increasing in both t > 0 and w > 0.
+inline Interval hydraulicDiameter(const Interval& t, const Interval& w) {
+    const auto eval = [](const Interval& a, const Interval& b) { return (2 * a * b) / (a + b); };
+    if (t.lo > 0 && w.lo > 0) {
+        return {eval(Interval(t.lo), Interval(w.lo)).lo, eval(Interval(t.hi), Interval(w.hi)).hi};
+    }
+    return eval(t, w);
+}
+
+// --- Interval packs ---
+
+// W boxes evaluated as one: the lower and upper bounds each form a Lanes pack
+// (structure of arrays). Every operation applies the Interval operation lane
+// by lane, so lane k gets exactly the enclosure evaluateModel<Interval> gives
+// it.
+template <std::size_t W>
+struct IntervalLanes {
+    Lanes<W> lo;
+    Lanes<W> hi;
+
+    IntervalLanes() = default;
+    IntervalLanes(double x) : lo(x), hi(x) {}
+
+    Interval lane(std::size_t k) const { return {lo.v[k], hi.v[k]}; }
+
+    void setLane(std::size_t k, const Interval& x) {
+        lo.v[k] = x.lo;
+        hi.v[k] = x.hi;
+    }
+
+#define VC_INTERVAL_LANES_BINARY_OP(op)                                                 \
+    friend IntervalLanes operator op(const IntervalLanes& a, const IntervalLanes& b) {  \
+        IntervalLanes r;                                                                \
+        for (std::size_t k = 0; k < W; ++k) {                                           \
+            r.setLane(k, a.lane(k) op b.lane(k));                                       \
+        }                                                                               \
+        return r;                                                                       \
+    }                                                                                   \
+    friend IntervalLanes& operator op##=(IntervalLanes& a, const IntervalLanes& b) { return a = a op b; }
+    VC_INTERVAL_LANES_BINARY_OP(+)
+    VC_INTERVAL_LANES_BINARY_OP(-)
+    VC_INTERVAL_LANES_BINARY_OP(*)
+    VC_INTERVAL_LANES_BINARY_OP(/)
+#undef VC_INTERVAL_LANES_BINARY_OP
+
+    friend IntervalLanes operator-(const IntervalLanes& a) {
+        IntervalLanes r;
+        r.lo = -a.hi;
+        r.hi = -a.lo;
+        return r;
+    }
+
+    friend IntervalLanes sin(const IntervalLanes& a) {
+        IntervalLanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.setLane(k, sin(a.lane(k)));
+        }
+        return r;
+    }
+
+    friend IntervalLanes cos(const IntervalLanes& a) {
+        IntervalLanes r;
+        for (std::size_t k = 0; k < W; ++k) {
+            r.setLane(k, cos(a.lane(k)));
+        }
+        return r;
+    }
+};
+
+template <std::size_t W>
+IntervalLanes<W> screenPermeability(const IntervalLanes<W>& d_w, const IntervalLanes<W>& epsilon,
+                                    const IntervalLanes<W>& kc_constant) {
+    IntervalLanes<W> r;
+    for (std::size_t k = 0; k < W; ++k) {
+        r.setLane(k, screenPermeability(d_w.lane(k), epsilon.lane(k), kc_constant.lane(k)));
+    }
+    return r;
+}
+
+template <std::size_t W>
+IntervalLanes<W> effectiveWickConductivity(const IntervalLanes<W>& epsilon, const IntervalLanes<W>& k_shell, double k_l) {
+    IntervalLanes<W> r;
+    for (std::size_t k = 0; k < W; ++k) {
+        r.setLane(k, effectiveWickConductivity(epsilon.lane(k), k_shell.lane(k), k_l));
+    }
+    return r;
+}
+
+template <std::size_t W>
+IntervalLanes<W> hydraulicDiameter(const IntervalLanes<W>& t, const IntervalLanes<W>& w) {
+    IntervalLanes<W> r;
+    for (std::size_t k = 0; k < W; ++k) {
+        r.setLane(k, hydraulicDiameter(t.lane(k), w.lane(k)));
+    }
+    return r;
+}
+
+// Column-wise kernel for interval batches: kBatchLanes boxes per model pass,
+// the remainder one at a time.
+inline void evaluateBatchRange(const DesignBatch<Interval>& in, OutputBatch<Interval>& out, std::size_t begin,
+                               std::size_t end, const FluidProperties& fluid = FluidProperties{}) {
+    using Pack = IntervalLanes<kBatchLanes>;
+    std::size_t i = begin;
+    for (; i + kBatchLanes <= end; i += kBatchLanes) {
+        DesignInputs<Pack> d;
+#define VC_LOAD_INPUT_BOXES(name, value)                \
+        for (std::size_t k = 0; k < kBatchLanes; ++k) { \
+            d.name.setLane(k, in.name[i + k]);          \
+        }
+        VC_DESIGN_FIELDS(VC_LOAD_INPUT_BOXES)
+#undef VC_LOAD_INPUT_BOXES
+        const ModelOutputs<Pack> o = evaluateModel(d, fluid);
+#define VC_STORE_OUTPUT_BOXES(name)                     \
+        for (std::size_t k = 0; k < kBatchLanes; ++k) { \
+            out.name[i + k] = o.name.lane(k);           \
+        }
+        VC_OUTPUT_FIELDS(VC_STORE_OUTPUT_BOXES)
+#undef VC_STORE_OUTPUT_BOXES
+    }
+    for (; i < end; ++i) {
+        out.set(i, evaluateModel(in.get(i), fluid));
+    }
+}
+
+// --- Boxes ---
+
+// Inputs that only take whole values. A box over one of them stands for the
+// integers it contains: midpoints round to one and bisection splits between
+// two.
+#define VC_INTEGER_DESIGN_FIELDS(X) \
+    X(mesh_number_evap_wpi)         \
+    X(num_layers_evap)              \
+    X(mesh_number_cond_wpi)         \
+    X(num_layers_cond)
+
+inline bool isIntegerInput(Interval DesignInputs<Interval>::*field) {
+#define VC_MATCH_INTEGER_FIELD(name)               \
+    if (field == &DesignInputs<Interval>::name) {  \
+        return true;                               \
+    }
+    VC_INTEGER_DESIGN_FIELDS(VC_MATCH_INTEGER_FIELD)
+#undef VC_MATCH_INTEGER_FIELD
+    return false;
+}
+
+// Input box around a point design: every field degenerate unless widened.
+inline DesignInputs<Interval> pointBox(const DesignInputs<double>& d) {
+    DesignInputs<Interval> box;
+#define VC_POINT_BOX_FIELD(name, value) box.name = Interval(d.name);
+    VC_DESIGN_FIELDS(VC_POINT_BOX_FIELD)
+#undef VC_POINT_BOX_FIELD
+    return box;
+}
+
+// Midpoint of every input; integer inputs take the whole value nearest to it
+// inside the box (the plain midpoint if the box holds none).
+inline DesignInputs<double> boxMidpoint(const DesignInputs<Interval>& box) {
+    DesignInputs<double> d;
+#define VC_BOX_MID_FIELD(name, value) d.name = box.name.mid();
+    VC_DESIGN_FIELDS(VC_BOX_MID_FIELD)
+#undef VC_BOX_MID_FIELD
+#define VC_BOX_MID_INTEGER_FIELD(name)                                    \
+    {                                                                     \
+        const double first = std::ceil(box.name.lo);                      \
+        const double last = std::floor(box.name.hi);                      \
+        if (first <= last) {                                              \
+            d.name = std::min(std::max(std::round(d.name), first), last); \
+        }                                                                 \
+    }
+    VC_INTEGER_DESIGN_FIELDS(VC_BOX_MID_INTEGER_FIELD)
+#undef VC_BOX_MID_INTEGER_FIELD
+    return d;
+}
+
+// Splits `box` in half along the input with the largest width relative to its
+// midpoint. An integer input's width is the span of the integers it holds, and
+// it splits between two of them, so both halves keep whole bounds.
+inline void bisectBox(const DesignInputs<Interval>& box, DesignInputs<Interval>& left, DesignInputs<Interval>& right) {
+    double best = -1;
+    Interval DesignInputs<Interval>::*split = nullptr;
+#define VC_WIDEST_FIELD(name, value)                                                           \
+    {                                                                                          \
+        const bool whole = isIntegerInput(&DesignInputs<Interval>::name);                      \
+        const double width = whole ? std::floor(box.name.hi) - std::ceil(box.name.lo)          \
+                                   : box.name.width();                                         \
+        const double scale = std::max(std::fabs(box.name.mid()), 1e-300);                     \
+        const double rel = whole && !(width >= 1) ? -1 : width / scale;                        \
+        if (rel > best) {                                                                      \
+            best = rel;                                                                        \
+            split = &DesignInputs<Interval>::name;                                             \
+        }                                                                                      \
+    }
+    VC_DESIGN_FIELDS(VC_WIDEST_FIELD)
+#undef VC_WIDEST_FIELD
+    left = box;
+    right = box;
+    const Interval& x = box.*split;
+    if (isIntegerInput(split)) {
+        const double m = std::floor((std::ceil(x.lo) + std::floor(x.hi)) / 2);
+        (left.*split).hi = m;
+        (right.*split).lo = m + 1;
+    } else {
+        const double m = x.mid();
+        (left.*split).hi = m;
+        (right.*split).lo = m;
+    }
+}
+
+// --- Branch-and-bound certification ---
+enum class CertificationResult { Certified, Violated, Undecided };
+
+struct CertificationRequirement {
+    double Q_max_min = 0;                                               // Require Q_max >= this [W]
+    double R_total_corrected_max = std::numeric_limits<double>::infinity();  // Require R_corrected <= this [K/W]
+};
+
+struct CertificationReport {
+    CertificationResult result = CertificationResult::Undecided;
+    DesignInputs<double> counterexample;  // Valid when result == Violated
+    std::size_t boxes_evaluated = 0;
+};
+
+// Proves the requirement over the whole box, or finds a violating midpoint.
+// Each round evaluates the whole open worklist as one interval batch.
+inline CertificationReport certifyBox(const DesignInputs<Interval>& box, const CertificationRequirement& req,
+                                      std::size_t max_boxes = 1 << 20,
+                                      const FluidProperties& fluid = FluidProperties{}) {
+    CertificationReport report;
+    DesignBatch<Interval> open;
+    open.push_back(box);
+    OutputBatch<Interval> out;
+    while (open.size() > 0) {
+        if (report.boxes_evaluated + open.size() > max_boxes) {
+            report.result = CertificationResult::Undecided;
+            return report;
+        }
+        evaluateBatch(open, out, fluid);
+        report.boxes_evaluated += open.size();
+
+        DesignBatch<Interval> next;
+        for (std::size_t i = 0; i < open.size(); ++i) {
+            const bool q_ok = out.Q_max[i].lo >= req.Q_max_min;
+            const bool r_ok = out.R_total_corrected[i].hi <= req.R_total_corrected_max;
+            if (q_ok && r_ok) {
+                continue;
+            }
+            const bool q_fail = out.Q_max[i].hi < req.Q_max_min;
+            const bool r_fail = out.R_total_corrected[i].lo > req.R_total_corrected_max;
+            const DesignInputs<Interval> b = open.get(i);
+            const DesignInputs<double> m = boxMidpoint(b);
+            const ModelOutputs<double> pm = evaluateModel(m, fluid);
+            if (q_fail || r_fail || pm.Q_max < req.Q_max_min || pm.R_total_corrected > req.R_total_corrected_max) {
+                report.result = CertificationResult::Violated;
+                report.counterexample = m;
+                return report;
+            }
+            DesignInputs<Interval> left;
+            DesignInputs<Interval> right;
+            bisectBox(b, left, right);
+            next.push_back(left);
+            next.push_back(right);
+        }
+        open = std::move(next);
+    }
+    report.result = CertificationResult::Certified;
+    return report;
+}
+
+}  // namespace vc
@@ -0,0 +1,455 @@
+#pragma once
+// Nearest feasible designs from a precomputed sweep.
+//
+// A design fails section 6 when dP_cap < dP_total. KdTree indexes the rows of
+// a sweep that pass, over a chosen set of design inputs, each normalized to
+// [0, 1] by the sweep's range (u = (x - lo) / (hi - lo)), so a distance mixes
+// wire diameters and heat loads on equal terms. nearest() returns the k rows
+// closest to a proposed design in that space.
+//
+// The tree is implicit and balanced: node n (children 2n + 1, 2n + 2) holds
+// points [b, e) of the tree-ordered arrays and splits them at the middle, on
+// the dimension of widest spread (estimated from a sample of the node's
+// points). All leaves sit at the same depth D, the smallest with at most
+// leaf_size points per leaf, so internal nodes need only a split dimension and
+// value (8 bytes) and every range follows from the point count. Construction
+// runs level by level, the nodes of a level in parallel (nth_element over a
+// point permutation).
+//
+// Search is the incremental-distance descent of Arya & Mount: the far child is
+// visited only if the squared distance to its cell is at most the current k-th
+// best (equal distances are ordered by ID, so a tie can still enter). Batched
+// queries run in parallel, one query per lane.
+//
+// save() writes header, axes, split nodes, row IDs and float coordinates as
+// one file that open() maps read-only (MappedFile) and queries in place, so a
+// 10^8-point index is usable without being read or rebuilt.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_mapped_file.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_sweep_file.hpp"
+
+namespace vc {
+
+// Normalization of the indexed design inputs.
+struct KdTreeAxes {
+    std::vector<std::string> names;
+    std::vector<double> lo;
+    std::vector<double> hi;
+
+    std::size_t size() const { return names.size(); }
+
+    double normalize(std::size_t a, double x) const {
+        const double range = hi[a] - lo[a];
+        return range > 0 ? (x - lo[a]) / range : 0.0;
+    }
+};
+
+struct Neighbor {
+    std::uint64_t id = std::numeric_limits<std::uint64_t>::max();   // Sweep row; max() when fewer than k points
+    double distance = std::numeric_limits<double>::infinity();      // In normalized input space
+};
+
+namespace detail {
+
+struct KdSplit {
+    std::uint32_t dim;
+    float value;
+};
+static_assert(sizeof(KdSplit) == 8, "KdSplit is a fixed on-disk layout");
+
+struct KdTreeHeader {
+    char magic[8];              // "VCKDTREE"
+    std::uint32_t version;
+    std::uint32_t byte_order;   // 0x01020304 as written
+    std::uint32_t dims;
+    std::uint32_t depth;
+    std::uint64_t point_count;
+    std::uint64_t reserved[4];
+};
+static_assert(sizeof(KdTreeHeader) == 64, "header is a fixed on-disk layout");
+
+constexpr std::uint32_t kKdTreeVersion = 1;
+constexpr std::uint32_t kKdByteOrderMark = 0x01020304;
+constexpr std::size_t kKdNameBytes = 32;
+
+inline std::size_t alignTo8(std::size_t n) {
+    return (n + 7) & ~std::size_t{7};
+}
+
+// Byte offsets of the sections after the header.
+struct KdTreeLayout {
+    std::size_t names, lo, hi, nodes, ids, coords, end;
+
+    KdTreeLayout(std::size_t dims, std::size_t depth, std::size_t points) {
+        names = sizeof(KdTreeHeader);
+        lo = names + dims * kKdNameBytes;
+        hi = lo + dims * sizeof(double);
+        nodes = hi + dims * sizeof(double);
+        ids = alignTo8(nodes + ((std::size_t{1} << depth) - 1) * sizeof(KdSplit));
+        coords = ids + points * sizeof(std::uint64_t);
+        end = coords + points * dims * sizeof(float);
+    }
+};
+
+}  // namespace detail
+
+class KdTree {
+public:
+    KdTree() = default;
+    explicit KdTree(const std::string& path) { open(path); }
+    KdTree(const KdTree&) = delete;
+    KdTree& operator=(const KdTree&) = delete;
+    KdTree(KdTree&&) = default;
+    KdTree& operator=(KdTree&&) = default;
+
+    // Builds from normalized coordinates (row-major, axes.size() per point)
+    // and one ID per point.
+    static KdTree build(const KdTreeAxes& axes, const std::vector<float>& coords, std::vector<std::uint64_t> ids,
+                        std::size_t leaf_size = 16) {
+        const std::size_t dims = axes.size();
+        const std::size_t n = ids.size();
+        if (dims == 0 || coords.size() != n * dims || leaf_size == 0) {
+            throw std::invalid_argument("KdTree::build: need dims > 0, dims coordinates per ID and leaf_size > 0");
+        }
+        if (n > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("KdTree::build: more than 2^32 - 1 points");
+        }
+        KdTree t;
+        t.axes_ = axes;
+        t.dims_ = dims;
+        t.count_ = n;
+        t.depth_ = 0;
+        while (((n + (std::size_t{1} << t.depth_) - 1) >> t.depth_) > leaf_size) {
+            ++t.depth_;
+        }
+        t.node_store_.resize((std::size_t{1} << t.depth_) - 1);
+
+        std::vector<std::uint32_t> perm(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            perm[i] = static_cast<std::uint32_t>(i);
+        }
+        for (std::size_t level = 0; level < t.depth_; ++level) {
+            const std::size_t first = (std::size_t{1} << level) - 1;
+            parallelFor(std::size_t{1} << level, [&](std::size_t begin, std::size_t end, unsigned) {
+                for (std::size_t j = begin; j < end; ++j) {
+                    const std::pair<std::size_t, std::size_t> r = t.nodeRange(first + j, level);
+                    t.node_store_[first + j] = splitNode(coords.data(), dims, perm.data() + r.first, r.second - r.first);
+                }
+            }, 1);
+        }
+
+        t.id_store_.resize(n);
+        t.coord_store_.resize(n * dims);
+        parallelFor(n, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t i = begin; i < end; ++i) {
+                t.id_store_[i] = ids[perm[i]];
+                std::copy_n(coords.data() + static_cast<std::size_t>(perm[i]) * dims, dims, t.coord_store_.data() + i * dims);
+            }
+        });
+        t.nodes_ = t.node_store_.data();
+        t.ids_ = t.id_store_.data();
+        t.coords_ = t.coord_store_.data();
+        return t;
+    }
+
+    std::size_t size() const { return count_; }
+    std::size_t dims() const { return dims_; }
+    std::size_t depth() const { return depth_; }
+    const KdTreeAxes& axes() const { return axes_; }
+
+    // --- Queries ---
+
+    // k nearest points to `d`, closest first (ties by ID).
+    std::vector<Neighbor> nearest(const DesignInputs<double>& d, std::size_t k) const {
+        std::vector<double> q(dims_);
+        for (std::size_t a = 0; a < dims_; ++a) {
+            q[a] = axes_.normalize(a, d.*designField(axes_.names[a]));
+        }
+        std::vector<Neighbor> result(k);
+        search(q.data(), k, result.data());
+        return result;
+    }
+
+    // k neighbors per query lane, row-major into `out` (queries.size() x k).
+    void nearestBatch(const DesignBatch<double>& queries, std::size_t k, std::vector<Neighbor>& out) const {
+        std::vector<const std::vector<double>*> columns;
+        for (const std::string& name : axes_.names) {
+            columns.push_back(&(queries.*designColumn<double>(name)));
+        }
+        out.assign(queries.size() * k, Neighbor{});
+        parallelFor(queries.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+            std::vector<double> q(dims_);
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t a = 0; a < dims_; ++a) {
+                    q[a] = axes_.normalize(a, (*columns[a])[i]);
+                }
+                search(q.data(), k, out.data() + i * k);
+            }
+        }, 64);
+    }
+
+    // --- Persistence ---
+
+    void save(const std::string& path) const {
+        const detail::KdTreeLayout layout(dims_, depth_, count_);
+        detail::KdTreeHeader h{};
+        std::memcpy(h.magic, "VCKDTREE", 8);
+        h.version = detail::kKdTreeVersion;
+        h.byte_order = detail::kKdByteOrderMark;
+        h.dims = static_cast<std::uint32_t>(dims_);
+        h.depth = static_cast<std::uint32_t>(depth_);
+        h.point_count = count_;
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (const std::string& name : axes_.names) {
+            char buf[detail::kKdNameBytes] = {};
+            std::strncpy(buf, name.c_str(), sizeof(buf) - 1);
+            f.write(buf, sizeof(buf));
+        }
+        f.write(reinterpret_cast<const char*>(axes_.lo.data()), static_cast<std::streamsize>(dims_ * sizeof(double)));
+        f.write(reinterpret_cast<const char*>(axes_.hi.data()), static_cast<std::streamsize>(dims_ * sizeof(double)));
+        const std::size_t node_bytes = ((std::size_t{1} << depth_) - 1) * sizeof(detail::KdSplit);
+        f.write(reinterpret_cast<const char*>(nodes_), static_cast<std::streamsize>(node_bytes));
+        const char pad[8] = {};
+        f.write(pad, static_cast<std::streamsize>(layout.ids - layout.nodes - node_bytes));
+        f.write(reinterpret_cast<const char*>(ids_), static_cast<std::streamsize>(count_ * sizeof(std::uint64_t)));
+        f.write(reinterpret_cast<const char*>(coords_), static_cast<std::streamsize>(count_ * dims_ * sizeof(float)));
+        if (!f) {
+            throw std::runtime_error("KdTree::save: cannot write " + path);
+        }
+    }
+
+    void open(const std::string& path) {
+        *this = KdTree();
+        file_.open(path);
+        detail::KdTreeHeader h{};
+        if (file_.size() >= sizeof(h)) {
+            std::memcpy(&h, file_.data(), sizeof(h));
+        }
+        if (file_.size() < sizeof(h) || std::memcmp(h.magic, "VCKDTREE", 8) != 0 || h.version != detail::kKdTreeVersion ||
+            h.byte_order != detail::kKdByteOrderMark || h.dims == 0 || h.depth >= 48 ||
+            file_.size() < detail::KdTreeLayout(h.dims, h.depth, h.point_count).end) {
+            file_.close();
+            throw std::runtime_error("KdTree: " + path + " is not a compatible k-d tree index");
+        }
+        const detail::KdTreeLayout layout(h.dims, h.depth, h.point_count);
+        const char* base = file_.data();
+        dims_ = h.dims;
+        depth_ = h.depth;
+        count_ = h.point_count;
+        axes_ = KdTreeAxes{};
+        for (std::size_t a = 0; a < dims_; ++a) {
+            const char* p = base + layout.names + a * detail::kKdNameBytes;
+            axes_.names.emplace_back(p, std::find(p, p + detail::kKdNameBytes, '\0'));
+        }
+        const double* lo = reinterpret_cast<const double*>(base + layout.lo);
+        const double* hi = reinterpret_cast<const double*>(base + layout.hi);
+        axes_.lo.assign(lo, lo + dims_);
+        axes_.hi.assign(hi, hi + dims_);
+        nodes_ = reinterpret_cast<const detail::KdSplit*>(base + layout.nodes);
+        ids_ = reinterpret_cast<const std::uint64_t*>(base + layout.ids);
+        coords_ = reinterpret_cast<const float*>(base + layout.coords);
+    }
+
+private:
+    // Points [b, e) of node n at `level`; children halve their parent's range.
+    std::pair<std::size_t, std::size_t> nodeRange(std::size_t n, std::size_t level) const {
+        std::size_t b = 0;
+        std::size_t e = count_;
+        for (std::size_t l = level; l > 0; --l) {
+            const std::size_t mid = b + (e - b) / 2;
+            if (((n + 1) >> (l - 1)) & 1) {
+                b = mid;
+            } else {
+                e = mid;
+            }
+        }
+        return {b, e};
+    }
+
+    // Partitions perm[0, n) at its middle on the dimension of widest spread.
+    static detail::KdSplit splitNode(const float* coords, std::size_t dims, std::uint32_t* perm, std::size_t n) {
+        if (n == 0) {
+            return {0, 0.0f};
+        }
+        std::uint32_t best_dim = 0;
+        float best_spread = -1;
+        std::vector<float> lo(dims, std::numeric_limits<float>::infinity());
+        std::vector<float> hi(dims, -std::numeric_limits<float>::infinity());
+        // Spread from at most ~1024 evenly strided points; the median split
+        // keeps the tree balanced whatever dimension this picks
+        const std::size_t stride = std::max<std::size_t>(1, n / 1024);
+        for (std::size_t i = 0; i < n; i += stride) {
+            const float* p = coords + static_cast<std::size_t>(perm[i]) * dims;
+            for (std::size_t a = 0; a < dims; ++a) {
+                lo[a] = std::min(lo[a], p[a]);
+                hi[a] = std::max(hi[a], p[a]);
+            }
+        }
+        for (std::size_t a = 0; a < dims; ++a) {
+            if (hi[a] - lo[a] > best_spread) {
+                best_spread = hi[a] - lo[a];
+                best_dim = static_cast<std::uint32_t>(a);
+            }
+        }
+        const std::size_t mid = n / 2;
+        std::nth_element(perm, perm + mid, perm + n, [&](std::uint32_t x, std::uint32_t y) {
+            const float cx = coords[static_cast<std::size_t>(x) * dims + best_dim];
+            const float cy = coords[static_cast<std::size_t>(y) * dims + best_dim];
+            return cx < cy || (cx == cy && x < y);
+        });
+        return {best_dim, coords[static_cast<std::size_t>(perm[mid]) * dims + best_dim]};
+    }
+
+    static bool closer(const Neighbor& a, const Neighbor& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+    }
+
+    // Fills best[0, k) closest first; squared distances during the search.
+    void search(const double* q, std::size_t k, Neighbor* best) const {
+        if (k == 0) {
+            return;
+        }
+        std::vector<Neighbor> heap;   // Max-heap on `closer`: the worst kept neighbor at the front
+        heap.reserve(k);
+        std::vector<double> off(dims_, 0.0);
+        descend(0, 0, 0, count_, q, 0.0, off.data(), k, heap);
+        std::sort_heap(heap.begin(), heap.end(), closer);
+        for (std::size_t i = 0; i < heap.size(); ++i) {
+            best[i] = {heap[i].id, std::sqrt(heap[i].distance)};
+        }
+        for (std::size_t i = heap.size(); i < k; ++i) {
+            best[i] = Neighbor{};
+        }
+    }
+
+    void descend(std::size_t node, std::size_t level, std::size_t b, std::size_t e, const double* q, double rd,
+                 double* off, std::size_t k, std::vector<Neighbor>& heap) const {
+        if (level == depth_) {
+            for (std::size_t i = b; i < e; ++i) {
+                const float* p = coords_ + i * dims_;
+                double d2 = 0;
+                for (std::size_t a = 0; a < dims_; ++a) {
+                    const double diff = q[a] - p[a];
+                    d2 += diff * diff;
+                }
+                const Neighbor cand{ids_[i], d2};
+                if (heap.size() < k) {
+                    heap.push_back(cand);
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                } else if (closer(cand, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), closer);
+                    heap.back() = cand;
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                }
+            }
+            return;
+        }
+        const detail::KdSplit s = nodes_[node];
+        const std::size_t mid = b + (e - b) / 2;
+        const double diff = q[s.dim] - s.value;
+        const bool left_first = diff < 0;
+        if (left_first) {
+            descend(2 * node + 1, level + 1, b, mid, q, rd, off, k, heap);
+        } else {
+            descend(2 * node + 2, level + 1, mid, e, q, rd, off, k, heap);
+        }
+        const double old = off[s.dim];
+        const double far_rd = rd - old * old + diff * diff;
+        // <=: a far point tied with the k-th best may still win on ID
+        if (heap.size() < k || far_rd <= heap.front().distance) {
+            off[s.dim] = diff;
+            if (left_first) {
+                descend(2 * node + 2, level + 1, mid, e, q, far_rd, off, k, heap);
+            } else {
+                descend(2 * node + 1, level + 1, b, mid, q, far_rd, off, k, heap);
+            }
+            off[s.dim] = old;
+        }
+    }
+
+    KdTreeAxes axes_;
+    std::size_t dims_ = 0;
+    std::size_t depth_ = 0;
+    std::size_t count_ = 0;
+    // Views of the tree: into the stores after build(), into file_ after open()
+    const detail::KdSplit* nodes_ = nullptr;
+    const std::uint64_t* ids_ = nullptr;
+    const float* coords_ = nullptr;
+    std::vector<detail::KdSplit> node_store_;
+    std::vector<std::uint64_t> id_store_;
+    std::vector<float> coord_store_;
+    MappedFile file_;
+};
+
+// Index over the rows of a sweep file that pass the section 6 check
+// (dP_cap >= dP_total), on the named design inputs. Axes are normalized by the
+// range of the whole sweep (from its zone maps); IDs are file rows.
+inline KdTree buildFeasibleDesignIndex(const SweepFile& file, const std::vector<std::string>& inputs,
+                                       std::size_t leaf_size = 16) {
+    KdTreeAxes axes;
+    std::vector<std::size_t> columns;
+    for (const std::string& name : inputs) {
+        designField(name);   // Must be a design input
+        const std::size_t k = file.columnIndex(name);
+        double lo = std::numeric_limits<double>::infinity();
+        double hi = -std::numeric_limits<double>::infinity();
+        for (std::size_t c = 0; c < file.chunkCount(); ++c) {
+            lo = std::min(lo, file.zone(c, k).min);
+            hi = std::max(hi, file.zone(c, k).max);
+        }
+        axes.names.push_back(name);
+        axes.lo.push_back(lo);
+        axes.hi.push_back(hi);
+        columns.push_back(k);
+    }
+    const std::size_t dims = inputs.size();
+    const std::size_t cap = file.columnIndex("dP_cap");
+    const std::size_t total = file.columnIndex("dP_total");
+
+    // Per-chunk feasible rows, gathered in parallel and concatenated in order
+    std::vector<std::vector<std::uint64_t>> chunk_rows(file.chunkCount());
+    std::vector<std::vector<float>> chunk_coords(file.chunkCount());
+    parallelFor(file.chunkCount(), [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t c = begin; c < end; ++c) {
+            const std::size_t n = file.rowsInChunk(c);
+            const double* dp_cap = file.column(c, cap);
+            const double* dp_total = file.column(c, total);
+            const std::uint64_t row0 = static_cast<std::uint64_t>(c) * file.chunkRows();
+            for (std::size_t i = 0; i < n; ++i) {
+                if (dp_cap[i] >= dp_total[i]) {
+                    chunk_rows[c].push_back(row0 + i);
+                    for (std::size_t a = 0; a < dims; ++a) {
+                        chunk_coords[c].push_back(static_cast<float>(axes.normalize(a, file.column(c, columns[a])[i])));
+                    }
+                }
+            }
+        }
+    }, 1);
+    std::vector<std::uint64_t> ids;
+    std::vector<float> coords;
+    for (std::size_t c = 0; c < file.chunkCount(); ++c) {
+        ids.insert(ids.end(), chunk_rows[c].begin(), chunk_rows[c].end());
+        coords.insert(coords.end(), chunk_coords[c].begin(), chunk_coords[c].end());
+        std::vector<std::uint64_t>().swap(chunk_rows[c]);
+        std::vector<float>().swap(chunk_coords[c]);
+    }
+    return KdTree::build(axes, coords, std::move(ids), leaf_size);
+}
+
+}  // namespace vc
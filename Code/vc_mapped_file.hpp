@@ -0,0 +1,99 @@
+#pragma once
+// Read-only file mapping for the binary catalog and result formats.
+//
+// POSIX builds map the file with mmap, so processes reading the same file
+// share its pages and nothing is read until touched. Elsewhere the file is
+// read into memory and the same interface is served from that copy.
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VC_MAPPED_FILE_MMAP 1
+#endif
+
+namespace vc {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            std::swap(base_, other.base_);
+            std::swap(bytes_, other.bytes_);
+            std::swap(fallback_, other.fallback_);
+        }
+        return *this;
+    }
+
+    void open(const std::string& path) {
+        close();
+#ifdef VC_MAPPED_FILE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        if (st.st_size == 0) {
+            ::close(fd);
+            return;
+        }
+        void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("MappedFile: cannot map " + path);
+        }
+        base_ = static_cast<const char*>(p);
+        bytes_ = static_cast<std::size_t>(st.st_size);
+#else
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        fallback_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        base_ = fallback_.data();
+        bytes_ = fallback_.size();
+#endif
+    }
+
+    void close() {
+#ifdef VC_MAPPED_FILE_MMAP
+        if (base_ && fallback_.empty()) {
+            ::munmap(const_cast<char*>(base_), bytes_);
+        }
+#endif
+        fallback_.clear();
+        base_ = nullptr;
+        bytes_ = 0;
+    }
+
+    // Page aligned when mapped.
+    const char* data() const { return base_; }
+    std::size_t size() const { return bytes_; }
+
+private:
+    const char* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::vector<char> fallback_;
+};
+
+}  // namespace vc
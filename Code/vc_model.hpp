@@ -0,0 +1,291 @@
+#pragma once
+// Scalar-generic form of the 1D vapor chamber model in vaporchamer1dcalcs.cpp.
+// evaluateModel<T> runs sections 3-5 of the original script for any scalar
+// type T that supports +, -, *, / and cos/sin (double, vc::Interval, ...).
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// Define PI if not already defined in <cmath>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace vc {
+
+// Design inputs with the thesis baseline as defaults: X(name, default). The
+// list is split so code that replaces the screen spec (a wick ID, say) can
+// declare the rest: operating point and chamber, screen wicks, then the
+// network parameters and calibration knobs.
+#define VC_CHAMBER_FIELDS(X)                     \
+    X(T_op, 70 + 273.15)                         \
+    X(Q_in, 150)                                 \
+    X(phi_deg, 0)                                \
+    X(filling_ratio, 0.30)                       \
+    X(experimental_correction_factor, 1.2)       \
+    X(vc_length, 0.070)                          \
+    X(vc_width, 0.070)                           \
+    X(t_evap_wall, 0.00225)                      \
+    X(t_cond_wall, 0.00225)                      \
+    X(t_vapor, 0.00192)                          \
+    X(evap_length, 0.020)                        \
+    X(evap_width, 0.020)                         \
+    X(k_shell, 380)
+
+#define VC_SCREEN_FIELDS(X)                      \
+    X(mesh_number_evap_wpi, 200)                 \
+    X(d_w_evap, 0.000051)                        \
+    X(num_layers_evap, 5)                        \
+    X(mesh_number_cond_wpi, 80)                  \
+    X(d_w_cond, 0.00015)                         \
+    X(num_layers_cond, 5)
+
+#define VC_PARAMETER_FIELDS(X)                   \
+    X(R_phase_change, 0.01)                      \
+    X(wick_resistance_multiplier, 1)             \
+    X(wall_resistance_multiplier, 1)             \
+    X(kozeny_carman_constant, 122)
+
+#define VC_DESIGN_FIELDS(X) VC_CHAMBER_FIELDS(X) VC_SCREEN_FIELDS(X) VC_PARAMETER_FIELDS(X)
+
+// Model outputs, in the order they are derived
+#define VC_OUTPUT_FIELDS(X)   \
+    X(t_evap_wick)            \
+    X(t_cond_wick)            \
+    X(epsilon_evap)           \
+    X(epsilon_cond)           \
+    X(rc_eff)                 \
+    X(K_evap)                 \
+    X(K_cond)                 \
+    X(L_eff)                  \
+    X(liquid_charge_volume_mL) \
+    X(A_evap)                 \
+    X(A_cond)                 \
+    X(A_wick_evap)            \
+    X(A_wick_cond)            \
+    X(A_vapor)                \
+    X(d_h_vapor)              \
+    X(dP_cap)                 \
+    X(dP_l)                   \
+    X(dP_v)                   \
+    X(dP_g)                   \
+    X(dP_total)               \
+    X(Q_max)                  \
+    X(k_wick_evap)            \
+    X(k_wick_cond)            \
+    X(R_evap_wall)            \
+    X(R_evap_wick)            \
+    X(R_evap_spreading)       \
+    X(R_cond_spreading)       \
+    X(R_cond_wick)            \
+    X(R_cond_wall)            \
+    X(R_total_ideal)          \
+    X(R_total_corrected)      \
+    X(delta_T)
+
+template <class T>
+struct DesignInputs {
+#define VC_DECLARE_INPUT(name, value) T name = T(value);
+    VC_DESIGN_FIELDS(VC_DECLARE_INPUT)
+#undef VC_DECLARE_INPUT
+};
+
+template <class T>
+struct ModelOutputs {
+#define VC_DECLARE_OUTPUT(name) T name;
+    VC_OUTPUT_FIELDS(VC_DECLARE_OUTPUT)
+#undef VC_DECLARE_OUTPUT
+};
+
+// Member pointer for a design input / model output by its field name.
+inline double DesignInputs<double>::*designField(const std::string& name) {
+#define VC_MATCH_INPUT(field, value)            \
+    if (name == #field) {                       \
+        return &DesignInputs<double>::field;    \
+    }
+    VC_DESIGN_FIELDS(VC_MATCH_INPUT)
+#undef VC_MATCH_INPUT
+    throw std::invalid_argument("unknown design input: " + name);
+}
+
+inline double ModelOutputs<double>::*outputField(const std::string& name) {
+#define VC_MATCH_OUTPUT(field)                  \
+    if (name == #field) {                       \
+        return &ModelOutputs<double>::field;    \
+    }
+    VC_OUTPUT_FIELDS(VC_MATCH_OUTPUT)
+#undef VC_MATCH_OUTPUT
+    throw std::invalid_argument("unknown model output: " + name);
+}
+
+// Working Fluid: Deionized Water at T_op
+struct FluidProperties {
+    double rho_l = 977.8;
+    double rho_v = 0.198;
+    double mu_l = 4.04e-4;
+    double mu_v = 1.09e-5;
+    double sigma = 0.0644;
+    double h_fg = 2.33e6;
+    double k_l = 0.668;
+    double theta_deg = 0;
+};
+
+// Function to convert degrees to radians
+template <class T>
+T toRadians(const T& degrees) {
+    return degrees * (M_PI / 180.0);
+}
+
+template <class T>
+T sq(const T& x) {
+    return x * x;
+}
+
+template <class T>
+T cube(const T& x) {
+    return x * x * x;
+}
+
+// --- Screen mesh correlations ---
+// Scalar versions; vc_interval.hpp overloads these with range-exact forms.
+template <class T>
+T screenPorosity(const T& mesh_number, const T& d_w) {
+    return 1 - (M_PI * mesh_number * d_w) / 4;
+}
+
+template <class T>
+T screenPermeability(const T& d_w, const T& epsilon, const T& kc_constant) {
+    return (sq(d_w) * cube(epsilon)) / (kc_constant * sq(1 - epsilon));
+}
+
+template <class T>
+T effectiveWickConductivity(const T& epsilon, const T& k_shell, double k_l) {
+    return k_l * ((k_shell + k_l + (1 - epsilon) * (k_shell - k_l)) /
+                  (k_shell + k_l - (1 - epsilon) * (k_shell - k_l)));
+}
+
+template <class T>
+T hydraulicDiameter(const T& t, const T& w) {
+    return (2 * t * w) / (t + w);
+}
+
+// Series network total and its corrected value, from the component resistances in `out`.
+template <class T>
+void sumResistanceNetwork(const DesignInputs<T>& in, ModelOutputs<T>& out) {
+    out.R_total_ideal = out.R_evap_wall + out.R_evap_spreading + out.R_evap_wick + in.R_phase_change +
+                        out.R_cond_wick + out.R_cond_spreading + out.R_cond_wall;
+
+    // --- Corrected Thermal Resistance ---
+    out.R_total_corrected = out.R_total_ideal * in.experimental_correction_factor;
+    out.delta_T = in.Q_in * out.R_total_corrected;
+}
+
+// Section 3 wick characterization from the screen-mesh correlations: fills
+// t_*_wick, epsilon_*, rc_eff and K_*.
+template <class T>
+void characterizeScreenWicks(const DesignInputs<T>& in, ModelOutputs<T>& out) {
+    // --- Unit Conversions ---
+    const double in_to_m = 0.0254;
+    const T mesh_number_evap = in.mesh_number_evap_wpi / in_to_m;
+    const T mesh_number_cond = in.mesh_number_cond_wpi / in_to_m;
+
+    // --- Total Wick Thickness ---
+    out.t_evap_wick = 2 * in.d_w_evap * in.num_layers_evap;
+    out.t_cond_wick = 2 * in.d_w_cond * in.num_layers_cond;
+
+    // --- Screen Mesh Wick Characterization ---
+    out.epsilon_evap = screenPorosity(mesh_number_evap, in.d_w_evap);
+    out.epsilon_cond = screenPorosity(mesh_number_cond, in.d_w_cond);
+    out.rc_eff = 1 / (2 * mesh_number_evap);
+    out.K_evap = screenPermeability(in.d_w_evap, out.epsilon_evap, in.kozeny_carman_constant);
+    out.K_cond = screenPermeability(in.d_w_cond, out.epsilon_cond, in.kozeny_carman_constant);
+}
+
+// Rest of sections 3-4, from the wick properties already in `out`.
+template <class T>
+void evaluateCapillaryLimit(const DesignInputs<T>& in, ModelOutputs<T>& out,
+                            const FluidProperties& fluid = FluidProperties{}) {
+    using std::cos;
+    using std::sin;
+
+    // --- Characteristic Flow Length & Volumes ---
+    out.L_eff = (in.vc_length + in.evap_length) / 4;
+    const T internal_area = in.vc_length * in.vc_width;
+    const T vol_vapor_space = internal_area * in.t_vapor;
+    const T vol_evap_wick_pore = internal_area * out.t_evap_wick * out.epsilon_evap;
+    const T vol_cond_wick_pore = internal_area * out.t_cond_wick * out.epsilon_cond;
+    const T vol_internal_total = vol_vapor_space + vol_evap_wick_pore + vol_cond_wick_pore;
+    out.liquid_charge_volume_mL = (vol_internal_total * in.filling_ratio) * 1e6;
+
+    // --- Cross-Sectional Areas ---
+    out.A_evap = in.evap_length * in.evap_width;
+    out.A_cond = (in.vc_length * in.vc_width) - out.A_evap;
+    out.A_wick_evap = out.t_evap_wick * in.vc_width;
+    out.A_wick_cond = out.t_cond_wick * in.vc_width;
+    out.A_vapor = in.t_vapor * in.vc_width;
+
+    // --- Hydraulic Diameter ---
+    out.d_h_vapor = hydraulicDiameter(in.t_vapor, in.vc_width);
+
+    // ============== 4. CAPILLARY PERFORMANCE ANALYSIS ======================
+    // --- Angle Conversions to Radians ---
+    const T phi = toRadians(in.phi_deg);
+    const double theta = toRadians(fluid.theta_deg);
+
+    // --- Pressure Terms Calculation ---
+    out.dP_cap = (2 * fluid.sigma * std::cos(theta)) / out.rc_eff;
+    const T vapor_pressure_term = (96 * fluid.mu_v * out.L_eff) /
+                                  (2 * fluid.rho_v * out.A_vapor * sq(out.d_h_vapor) * fluid.h_fg);
+    const T liquid_pressure_term = ((fluid.mu_l * (out.L_eff / 2)) / (fluid.rho_l * out.A_wick_cond * out.K_cond * fluid.h_fg)) +
+                                   ((fluid.mu_l * (out.L_eff / 2)) / (fluid.rho_l * out.A_wick_evap * out.K_evap * fluid.h_fg));
+    out.dP_l = in.Q_in * liquid_pressure_term;
+    out.dP_v = in.Q_in * vapor_pressure_term;
+    const double g = 9.81;
+    out.dP_g = fluid.rho_l * g * out.L_eff * sin(phi);
+    out.dP_total = out.dP_l + out.dP_v + out.dP_g;
+
+    // --- Maximum Heat Flux (Q_max) Calculation ---
+    out.Q_max = (out.dP_cap - out.dP_g) / (liquid_pressure_term + vapor_pressure_term);
+}
+
+// Section 5 from the areas, wick thicknesses and k_wick_* already in `out`.
+template <class T>
+void evaluateResistanceNetwork(const DesignInputs<T>& in, ModelOutputs<T>& out) {
+    // --- Component Thermal Resistances ---
+    // (multipliers are calibration knobs, 1 = uncalibrated; see vc_calibration.hpp)
+    out.R_evap_wall = in.wall_resistance_multiplier * in.t_evap_wall / (in.k_shell * out.A_evap);
+    out.R_evap_wick = in.wick_resistance_multiplier * out.t_evap_wick / (out.k_wick_evap * out.A_evap);
+    out.R_cond_wick = in.wick_resistance_multiplier * out.t_cond_wick / (out.k_wick_cond * out.A_cond);
+    out.R_cond_wall = in.wall_resistance_multiplier * in.t_cond_wall / (in.k_shell * out.A_cond);
+
+    // --- Spreading Resistances (1D model: none; see vc_spreading.hpp) ---
+    out.R_evap_spreading = T(0);
+    out.R_cond_spreading = T(0);
+    sumResistanceNetwork(in, out);
+}
+
+// Rest of sections 3-5, from the wick properties already in `out`, with the
+// screen-mesh k_wick.
+template <class T>
+void evaluateFromWickProperties(const DesignInputs<T>& in, ModelOutputs<T>& out,
+                                const FluidProperties& fluid = FluidProperties{}) {
+    evaluateCapillaryLimit(in, out, fluid);
+
+    // ============== 5. THERMAL RESISTANCE NETWORK ANALYSIS ================
+    // --- Effective Wick Conductivity ---
+    out.k_wick_evap = effectiveWickConductivity(out.epsilon_evap, in.k_shell, fluid.k_l);
+    out.k_wick_cond = effectiveWickConductivity(out.epsilon_cond, in.k_shell, fluid.k_l);
+    evaluateResistanceNetwork(in, out);
+}
+
+template <class T>
+ModelOutputs<T> evaluateModel(const DesignInputs<T>& in, const FluidProperties& fluid = FluidProperties{}) {
+    ModelOutputs<T> out;
+    // =================== 3. DERIVED PARAMETER CALCULATION ==================
+    characterizeScreenWicks(in, out);
+    evaluateFromWickProperties(in, out, fluid);
+    return out;
+}
+
+}  // namespace vc
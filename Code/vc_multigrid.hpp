@@ -0,0 +1,345 @@
+#pragma once
+// Cell-centered geometric multigrid for 2D plate problems of the form
+//
+//     -div(c grad u) + a u = f      on [0, Lx] x [0, Ly], zero-flux edges
+//
+// c is an in-plane conductance per cell (k*t for wall conduction, K*t/mu for
+// Darcy flow) and a is a per-area sink (out-of-plane conductance). The
+// hierarchy (rediscretized coefficients on every level) is built once in the
+// constructor and reused by every solve(), so sweeps over source strength
+// cost one solve each and nothing is re-assembled.
+//
+// Smoothing is red-black Gauss-Seidel fused into a single pass per band of
+// rows: red row j is updated, then black row j-1 while row j-1..j+1 are still
+// in cache. Bands run on separate threads; the two black rows on each band
+// edge are finished in a short second pass so no band reads a row another
+// band is writing.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+class MultigridSolver {
+public:
+    struct Options {
+        int pre_smooth = 2;
+        int post_smooth = 2;
+        int coarse_sweeps = 16;
+        int min_coarse_cells = 4;           // Stop coarsening at this many cells per side
+        std::size_t rows_per_thread = 64;   // Levels with fewer rows run single-threaded
+    };
+
+    MultigridSolver(int nx, int ny, double dx, double dy, const std::vector<double>& c, const std::vector<double>& a)
+        : MultigridSolver(nx, ny, dx, dy, c, a, Options{}) {}
+
+    MultigridSolver(int nx, int ny, double dx, double dy, const std::vector<double>& c, const std::vector<double>& a,
+                    const Options& options)
+        : options_(options) {
+        singular_ = std::all_of(a.begin(), a.end(), [](double v) { return v == 0; });
+        levels_.emplace_back();
+        buildLevel(levels_.back(), nx, ny, dx, dy, c, a);
+        std::vector<double> cc = c;
+        std::vector<double> ac = a;
+        while (levels_.back().nx % 2 == 0 && levels_.back().ny % 2 == 0 &&
+               levels_.back().nx / 2 >= options_.min_coarse_cells && levels_.back().ny / 2 >= options_.min_coarse_cells) {
+            const Level& f = levels_.back();
+            const int cnx = f.nx / 2;
+            const int cny = f.ny / 2;
+            std::vector<double> c2(static_cast<std::size_t>(cnx) * cny);
+            std::vector<double> a2(c2.size());
+            for (int J = 0; J < cny; ++J) {
+                for (int I = 0; I < cnx; ++I) {
+                    const std::size_t k00 = static_cast<std::size_t>(2 * J) * f.nx + 2 * I;
+                    const std::size_t k01 = k00 + f.nx;
+                    c2[static_cast<std::size_t>(J) * cnx + I] = 0.25 * (cc[k00] + cc[k00 + 1] + cc[k01] + cc[k01 + 1]);
+                    a2[static_cast<std::size_t>(J) * cnx + I] = 0.25 * (ac[k00] + ac[k00 + 1] + ac[k01] + ac[k01 + 1]);
+                }
+            }
+            const double cdx = 2 * f.dx;
+            const double cdy = 2 * f.dy;
+            levels_.emplace_back();
+            buildLevel(levels_.back(), cnx, cny, cdx, cdy, c2, a2);
+            cc.swap(c2);
+            ac.swap(a2);
+        }
+    }
+
+    int nx() const { return levels_[0].nx; }
+    int ny() const { return levels_[0].ny; }
+    std::size_t levelCount() const { return levels_.size(); }
+
+    // Solves A u = f (f per unit area, row-major nx*ny). `u` is used as the
+    // initial guess when it already has the right size. Returns the number of
+    // V-cycles taken to reach ||r|| <= tol * ||b||.
+    int solve(const std::vector<double>& f, std::vector<double>& u, double tol = 1e-8, int max_cycles = 50) {
+        Level& L = levels_[0];
+        const double area = L.dx * L.dy;
+        double mean_f = 0;
+        if (singular_) {
+            for (double v : f) {
+                mean_f += v;
+            }
+            mean_f /= static_cast<double>(f.size());
+        }
+        for (int j = 0; j < L.ny; ++j) {
+            for (int i = 0; i < L.nx; ++i) {
+                L.b[L.cell(i, j)] = (f[static_cast<std::size_t>(j) * L.nx + i] - mean_f) * area;
+            }
+        }
+        std::fill(L.x.begin(), L.x.end(), 0.0);
+        if (u.size() == f.size()) {
+            for (int j = 0; j < L.ny; ++j) {
+                for (int i = 0; i < L.nx; ++i) {
+                    L.x[L.pad(i, j)] = u[static_cast<std::size_t>(j) * L.nx + i];
+                }
+            }
+        }
+        double b_norm = 0;
+        for (double v : L.b) {
+            b_norm += v * v;
+        }
+        b_norm = std::sqrt(b_norm);
+        int cycles = 0;
+        if (b_norm > 0) {
+            while (cycles < max_cycles) {
+                vCycle(0);
+                ++cycles;
+                if (singular_) {
+                    removeMean(L);
+                }
+                if (residualNorm(L) <= tol * b_norm) {
+                    break;
+                }
+            }
+        }
+        u.resize(f.size());
+        for (int j = 0; j < L.ny; ++j) {
+            for (int i = 0; i < L.nx; ++i) {
+                u[static_cast<std::size_t>(j) * L.nx + i] = L.x[L.pad(i, j)];
+            }
+        }
+        return cycles;
+    }
+
+private:
+    struct Level {
+        int nx = 0;
+        int ny = 0;
+        double dx = 0;
+        double dy = 0;
+        // Face weights: we[cell] couples (i-1, j)-(i, j), sn[cell] couples (i, j-1)-(i, j).
+        // Edge faces carry zero weight (Neumann), so ghost cells never contribute.
+        std::vector<double> we;
+        std::vector<double> sn;
+        std::vector<double> diag;
+        std::vector<double> inv_diag;
+        std::vector<double> b;
+        std::vector<double> r;
+        std::vector<double> x;   // Padded with a one-cell ghost ring
+
+        std::size_t cell(int i, int j) const { return static_cast<std::size_t>(j) * (nx + 1) + i; }
+        std::size_t pad(int i, int j) const { return static_cast<std::size_t>(j + 1) * (nx + 2) + (i + 1); }
+    };
+
+    static double harmonic(double p, double q) { return (p + q) > 0 ? 2 * p * q / (p + q) : 0; }
+
+    static void buildLevel(Level& L, int nx, int ny, double dx, double dy, const std::vector<double>& c,
+                           const std::vector<double>& a) {
+        L.nx = nx;
+        L.ny = ny;
+        L.dx = dx;
+        L.dy = dy;
+        // Face arrays are (nx+1) x (ny+1) so the east/north neighbours index cleanly.
+        const std::size_t n_face = static_cast<std::size_t>(nx + 1) * (ny + 1);
+        L.we.assign(n_face, 0.0);
+        L.sn.assign(n_face, 0.0);
+        L.diag.assign(n_face, 0.0);
+        L.inv_diag.assign(n_face, 0.0);
+        L.b.assign(n_face, 0.0);
+        L.r.assign(n_face, 0.0);
+        L.x.assign(static_cast<std::size_t>(nx + 2) * (ny + 2), 0.0);
+        const auto at = [nx](const std::vector<double>& v, int i, int j) { return v[static_cast<std::size_t>(j) * nx + i]; };
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                if (i > 0) {
+                    L.we[L.cell(i, j)] = harmonic(at(c, i - 1, j), at(c, i, j)) * dy / dx;
+                }
+                if (j > 0) {
+                    L.sn[L.cell(i, j)] = harmonic(at(c, i, j - 1), at(c, i, j)) * dx / dy;
+                }
+            }
+        }
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                L.diag[L.cell(i, j)] = L.we[L.cell(i, j)] + L.we[L.cell(i + 1, j)] + L.sn[L.cell(i, j)] +
+                                       L.sn[L.cell(i, j + 1)] + at(a, i, j) * dx * dy;
+                L.inv_diag[L.cell(i, j)] = L.diag[L.cell(i, j)] > 0 ? 1 / L.diag[L.cell(i, j)] : 0;
+            }
+        }
+    }
+
+    // Gauss-Seidel update of the cells of one colour on row j.
+    static void relaxRow(Level& L, int j, int colour) {
+        const int stride = L.nx + 2;
+        double* x = L.x.data() + L.pad(0, j);
+        const double* we = L.we.data() + L.cell(0, j);
+        const double* sn = L.sn.data() + L.cell(0, j);
+        const double* sn_up = L.sn.data() + L.cell(0, j + 1);
+        const double* inv_diag = L.inv_diag.data() + L.cell(0, j);
+        const double* b = L.b.data() + L.cell(0, j);
+        for (int i = (j + colour) & 1; i < L.nx; i += 2) {
+            x[i] = (b[i] + we[i] * x[i - 1] + we[i + 1] * x[i + 1] + sn[i] * x[i - stride] + sn_up[i] * x[i + stride]) *
+                   inv_diag[i];
+        }
+    }
+
+    void smooth(Level& L, int sweeps) const {
+        const std::size_t rows = static_cast<std::size_t>(L.ny);
+        const std::size_t grain = std::max<std::size_t>(options_.rows_per_thread, 2);
+        for (int s = 0; s < sweeps; ++s) {
+            // Pass 1: fused red(j) / black(j-1) inside each band, band-edge black rows deferred.
+            parallelFor(
+                rows,
+                [&L](std::size_t b0, std::size_t b1, unsigned) {
+                    const int j0 = static_cast<int>(b0);
+                    const int j1 = static_cast<int>(b1);
+                    for (int j = j0; j < j1; ++j) {
+                        relaxRow(L, j, 0);
+                        if (j - 1 > j0) {
+                            relaxRow(L, j - 1, 1);
+                        }
+                    }
+                },
+                grain);
+            // Pass 2: black rows on band edges (the first and last row of every band).
+            parallelFor(
+                rows,
+                [&L](std::size_t b0, std::size_t b1, unsigned) {
+                    relaxRow(L, static_cast<int>(b0), 1);
+                    if (b1 - 1 > b0) {
+                        relaxRow(L, static_cast<int>(b1 - 1), 1);
+                    }
+                },
+                grain);
+        }
+    }
+
+    static double residualRow(Level& L, int j) {
+        const int stride = L.nx + 2;
+        const double* x = L.x.data() + L.pad(0, j);
+        const double* we = L.we.data() + L.cell(0, j);
+        const double* sn = L.sn.data() + L.cell(0, j);
+        const double* sn_up = L.sn.data() + L.cell(0, j + 1);
+        const double* diag = L.diag.data() + L.cell(0, j);
+        const double* b = L.b.data() + L.cell(0, j);
+        double* r = L.r.data() + L.cell(0, j);
+        double sum = 0;
+        for (int i = 0; i < L.nx; ++i) {
+            r[i] = b[i] - diag[i] * x[i] + we[i] * x[i - 1] + we[i + 1] * x[i + 1] + sn[i] * x[i - stride] +
+                   sn_up[i] * x[i + stride];
+            sum += r[i] * r[i];
+        }
+        return sum;
+    }
+
+    double residualNorm(Level& L) const {
+        double sum = 0;
+        for (int j = 0; j < L.ny; ++j) {
+            sum += residualRow(L, j);
+        }
+        return std::sqrt(sum);
+    }
+
+    static void removeMean(Level& L) {
+        double mean = 0;
+        for (int j = 0; j < L.ny; ++j) {
+            for (int i = 0; i < L.nx; ++i) {
+                mean += L.x[L.pad(i, j)];
+            }
+        }
+        mean /= static_cast<double>(L.nx) * L.ny;
+        for (int j = 0; j < L.ny; ++j) {
+            for (int i = 0; i < L.nx; ++i) {
+                L.x[L.pad(i, j)] -= mean;
+            }
+        }
+    }
+
+    // Residual on the fine level, summed 2x2 into the coarse right-hand side.
+    void restrictResidual(Level& F, Level& C) const {
+        parallelFor(
+            static_cast<std::size_t>(C.ny),
+            [&F, &C](std::size_t J0, std::size_t J1, unsigned) {
+                for (int J = static_cast<int>(J0); J < static_cast<int>(J1); ++J) {
+                    residualRow(F, 2 * J);
+                    residualRow(F, 2 * J + 1);
+                    const double* r0 = F.r.data() + F.cell(0, 2 * J);
+                    const double* r1 = F.r.data() + F.cell(0, 2 * J + 1);
+                    double* bc = C.b.data() + C.cell(0, J);
+                    for (int I = 0; I < C.nx; ++I) {
+                        bc[I] = r0[2 * I] + r0[2 * I + 1] + r1[2 * I] + r1[2 * I + 1];
+                    }
+                }
+            },
+            std::max<std::size_t>(options_.rows_per_thread / 2, 1));
+    }
+
+    // Bilinear interpolation of the coarse correction (mirror at the edges).
+    void prolongAdd(const Level& C, Level& F) const {
+        Level& Cm = const_cast<Level&>(C);
+        const int stride = C.nx + 2;
+        for (int J = 0; J < C.ny; ++J) {
+            Cm.x[C.pad(-1, J)] = C.x[C.pad(0, J)];
+            Cm.x[C.pad(C.nx, J)] = C.x[C.pad(C.nx - 1, J)];
+        }
+        for (int I = -1; I <= C.nx; ++I) {
+            Cm.x[C.pad(I, -1)] = C.x[C.pad(I, 0)];
+            Cm.x[C.pad(I, C.ny)] = C.x[C.pad(I, C.ny - 1)];
+        }
+        parallelFor(
+            static_cast<std::size_t>(F.ny),
+            [&C, &F, stride](std::size_t j0, std::size_t j1, unsigned) {
+                for (int j = static_cast<int>(j0); j < static_cast<int>(j1); ++j) {
+                    const int J = j / 2;
+                    const int dj = (j & 1) ? stride : -stride;
+                    const double* xc = C.x.data() + C.pad(0, J);
+                    double* xf = F.x.data() + F.pad(0, j);
+                    for (int i = 0; i < F.nx; ++i) {
+                        const int I = i / 2;
+                        const int di = (i & 1) ? 1 : -1;
+                        xf[i] += 0.5625 * xc[I] + 0.1875 * (xc[I + di] + xc[I + dj]) + 0.0625 * xc[I + di + dj];
+                    }
+                }
+            },
+            options_.rows_per_thread);
+    }
+
+    void vCycle(std::size_t level) {
+        Level& L = levels_[level];
+        if (level + 1 == levels_.size()) {
+            smooth(L, options_.coarse_sweeps);
+            if (singular_) {
+                removeMean(L);
+            }
+            return;
+        }
+        smooth(L, options_.pre_smooth);
+        Level& C = levels_[level + 1];
+        restrictResidual(L, C);
+        std::fill(C.x.begin(), C.x.end(), 0.0);
+        vCycle(level + 1);
+        prolongAdd(C, L);
+        smooth(L, options_.post_smooth);
+    }
+
+    Options options_;
+    bool singular_ = false;
+    std::vector<Level> levels_;
+};
+
+}  // namespace vc
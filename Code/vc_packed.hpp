@@ -0,0 +1,285 @@
+#pragma once
+// Bit-packed design records for catalog-scale enumeration.
+//
+// A catalog sweep varies a few inputs over short lists of levels (mesh and
+// wire of each wick, layer counts, wall gauge, envelope size, ...) and holds
+// the rest fixed. A DesignCodebook lists the levels of every design field; a
+// PackedDesign stores one level index per field in ceil(log2(levels)) bits,
+// 128 bits in all, against 23 doubles (184 bytes) for DesignInputs<double>.
+// Fields with a single level take no bits.
+//
+// The kernels decode 256 packed records at a time into a worker-local
+// DesignBatch (one column per field, a gather from the level table), evaluate
+// that block while it is still in cache, and hand inputs and outputs to a
+// visitor. Nothing per design is kept unless the visitor keeps it, so a full
+// Cartesian catalog is enumerated from its mixed-radix index without storing
+// any records at all.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+struct PackedDesign {
+    std::uint64_t lo = 0;   // Bits 0-63
+    std::uint64_t hi = 0;   // Bits 64-127
+
+    friend bool operator==(const PackedDesign& a, const PackedDesign& b) { return a.lo == b.lo && a.hi == b.hi; }
+};
+static_assert(sizeof(PackedDesign) == 16, "PackedDesign is 16 bytes");
+
+// Records decoded and evaluated per block.
+constexpr std::size_t kPackedBlockSize = 256;
+
+namespace detail {
+
+inline std::uint64_t extractBits(const PackedDesign& p, unsigned offset, unsigned width) {
+    const std::uint64_t mask = (std::uint64_t{1} << width) - 1;
+    if (offset >= 64) {
+        return (p.hi >> (offset - 64)) & mask;
+    }
+    std::uint64_t v = p.lo >> offset;
+    if (offset + width > 64) {
+        v |= p.hi << (64 - offset);
+    }
+    return v & mask;
+}
+
+inline void insertBits(PackedDesign& p, unsigned offset, unsigned width, std::uint64_t v) {
+    if (offset >= 64) {
+        p.hi |= v << (offset - 64);
+        return;
+    }
+    p.lo |= v << offset;
+    if (offset + width > 64) {
+        p.hi |= v >> (64 - offset);
+    }
+}
+
+inline unsigned bitsFor(std::size_t levels) {
+    unsigned bits = 0;
+    while ((std::size_t{1} << bits) < levels) {
+        ++bits;
+    }
+    return bits;
+}
+
+}  // namespace detail
+
+class DesignCodebook {
+public:
+    // Every field starts with the single level of `base`.
+    explicit DesignCodebook(const DesignInputs<double>& base = DesignInputs<double>{}) {
+#define VC_BASE_LEVEL(name, value) levels_.name = {base.name};
+        VC_DESIGN_FIELDS(VC_BASE_LEVEL)
+#undef VC_BASE_LEVEL
+        layout();
+    }
+
+    // Replaces the levels of one design input, e.g. setLevels("num_layers_evap", {2, 3, 4, 5}).
+    DesignCodebook& setLevels(const std::string& field, std::vector<double> levels) {
+        if (levels.empty()) {
+            throw std::invalid_argument("DesignCodebook: " + field + " needs at least one level");
+        }
+        std::vector<double>& column = levels_.*designColumn<double>(field);
+        column.swap(levels);
+        try {
+            layout();
+        } catch (...) {
+            column.swap(levels);
+            throw;
+        }
+        return *this;
+    }
+
+    const std::vector<double>& levels(const std::string& field) const { return levels_.*designColumn<double>(field); }
+
+    unsigned bitsUsed() const { return bits_used_; }
+
+    // Number of distinct designs (the Cartesian product of the level counts,
+    // saturating at 2^64 - 1).
+    std::uint64_t catalogSize() const { return catalog_size_; }
+
+    PackedDesign encode(const DesignInputs<double>& d) const {
+        PackedDesign p;
+#define VC_ENCODE_FIELD(name, value)                                                                      \
+        {                                                                                                 \
+            const auto it = std::find(levels_.name.begin(), levels_.name.end(), d.name);                  \
+            if (it == levels_.name.end()) {                                                               \
+                throw std::invalid_argument("DesignCodebook: " #name " is not one of its levels");        \
+            }                                                                                             \
+            detail::insertBits(p, code_.name.offset, code_.name.width,                                    \
+                               static_cast<std::uint64_t>(it - levels_.name.begin()));                    \
+        }
+        VC_DESIGN_FIELDS(VC_ENCODE_FIELD)
+#undef VC_ENCODE_FIELD
+        return p;
+    }
+
+    DesignInputs<double> decode(const PackedDesign& p) const {
+        DesignInputs<double> d;
+#define VC_DECODE_FIELD(name, value) d.name = levels_.name[detail::extractBits(p, code_.name.offset, code_.name.width)];
+        VC_DESIGN_FIELDS(VC_DECODE_FIELD)
+#undef VC_DECODE_FIELD
+        return d;
+    }
+
+    // Catalog entry `index` (mixed radix, first field fastest), index < catalogSize().
+    PackedDesign designAt(std::uint64_t index) const {
+        PackedDesign p;
+#define VC_INDEX_FIELD(name, value)                                                         \
+        if (code_.name.width > 0) {                                                         \
+            const std::uint64_t n = levels_.name.size();                                    \
+            detail::insertBits(p, code_.name.offset, code_.name.width, index % n);          \
+            index /= n;                                                                     \
+        }
+        VC_DESIGN_FIELDS(VC_INDEX_FIELD)
+#undef VC_INDEX_FIELD
+        return p;
+    }
+
+    // Expands p[0, n) into lanes [0, n) of `block`, which must hold n lanes.
+    void decodeBlock(const PackedDesign* p, std::size_t n, DesignBatch<double>& block) const {
+#define VC_DECODE_COLUMN(name, value)                                                                \
+        {                                                                                            \
+            const double* table = levels_.name.data();                                               \
+            double* column = block.name.data();                                                      \
+            if (code_.name.width == 0) {                                                             \
+                std::fill(column, column + n, table[0]);                                             \
+            } else {                                                                                 \
+                const unsigned offset = code_.name.offset;                                           \
+                const unsigned width = code_.name.width;                                             \
+                for (std::size_t i = 0; i < n; ++i) {                                                \
+                    column[i] = table[detail::extractBits(p[i], offset, width)];                     \
+                }                                                                                    \
+            }                                                                                        \
+        }
+        VC_DESIGN_FIELDS(VC_DECODE_COLUMN)
+#undef VC_DECODE_COLUMN
+    }
+
+private:
+    struct FieldCode {
+        unsigned offset = 0;
+        unsigned width = 0;
+    };
+    struct FieldCodes {
+#define VC_DECLARE_CODE(name, value) FieldCode name;
+        VC_DESIGN_FIELDS(VC_DECLARE_CODE)
+#undef VC_DECLARE_CODE
+    };
+
+    // Assigns bit ranges in field order and recomputes the catalog size.
+    void layout() {
+        FieldCodes code;
+        unsigned offset = 0;
+        std::uint64_t size = 1;
+        bool overflow = false;
+#define VC_LAYOUT_FIELD(name, value)                                                              \
+        code.name.width = detail::bitsFor(levels_.name.size());                                   \
+        code.name.offset = offset;                                                                \
+        offset += code.name.width;                                                                \
+        if (size > std::numeric_limits<std::uint64_t>::max() / levels_.name.size()) {             \
+            overflow = true;                                                                      \
+        }                                                                                         \
+        size *= levels_.name.size();
+        VC_DESIGN_FIELDS(VC_LAYOUT_FIELD)
+#undef VC_LAYOUT_FIELD
+        if (offset > 128) {
+            throw std::invalid_argument("DesignCodebook: levels need " + std::to_string(offset) +
+                                        " bits, more than the 128 of a PackedDesign");
+        }
+        code_ = code;
+        bits_used_ = offset;
+        catalog_size_ = overflow ? std::numeric_limits<std::uint64_t>::max() : size;
+    }
+
+    DesignBatch<double> levels_;   // Column `name` holds the levels of field `name`
+    FieldCodes code_;
+    unsigned bits_used_ = 0;
+    std::uint64_t catalog_size_ = 1;
+};
+
+// --- Kernels ---
+
+// Evaluates packed designs block by block and calls
+// visit(inputs, outputs, first, worker) for each block, where lane j of the
+// block is design first + j. Blocks of one worker arrive in order.
+template <class Visit>
+void evaluatePacked(const DesignCodebook& codebook, const PackedDesign* designs, std::size_t n, Visit&& visit,
+                    const FluidProperties& fluid = FluidProperties{}) {
+    parallelFor(n, [&](std::size_t begin, std::size_t end, unsigned worker) {
+        DesignBatch<double> block_in;
+        OutputBatch<double> block_out;
+        block_in.resize(kPackedBlockSize);
+        block_out.resize(kPackedBlockSize);
+        for (std::size_t first = begin; first < end; first += kPackedBlockSize) {
+            const std::size_t count = std::min(kPackedBlockSize, end - first);
+            if (count < kPackedBlockSize) {
+                block_in.resize(count);
+                block_out.resize(count);
+            }
+            codebook.decodeBlock(designs + first, count, block_in);
+            evaluateBatchRange(block_in, block_out, 0, count, fluid);
+            visit(static_cast<const DesignBatch<double>&>(block_in), static_cast<const OutputBatch<double>&>(block_out),
+                  first, worker);
+        }
+    }, kPackedBlockSize);
+}
+
+// Stores every output; for lists of packed designs that fit in memory.
+inline void evaluatePacked(const DesignCodebook& codebook, const std::vector<PackedDesign>& designs,
+                           OutputBatch<double>& out, const FluidProperties& fluid = FluidProperties{}) {
+    out.resize(designs.size());
+    evaluatePacked(
+        codebook, designs.data(), designs.size(),
+        [&](const DesignBatch<double>&, const OutputBatch<double>& block, std::size_t first, unsigned) {
+            for (std::size_t j = 0; j < block.size(); ++j) {
+                out.set(first + j, block.get(j));
+            }
+        },
+        fluid);
+}
+
+// Enumerates catalog entries [begin, end) without storing them: each block is
+// packed from its indices, then decoded and evaluated as in evaluatePacked.
+// `first` passed to the visitor is the catalog index of lane 0.
+template <class Visit>
+void enumerateCatalog(const DesignCodebook& codebook, std::uint64_t begin, std::uint64_t end, Visit&& visit,
+                      const FluidProperties& fluid = FluidProperties{}) {
+    if (end > codebook.catalogSize() || begin > end) {
+        throw std::out_of_range("enumerateCatalog: range exceeds the catalog");
+    }
+    parallelFor(static_cast<std::size_t>(end - begin), [&](std::size_t lo, std::size_t hi, unsigned worker) {
+        PackedDesign packed[kPackedBlockSize];
+        DesignBatch<double> block_in;
+        OutputBatch<double> block_out;
+        block_in.resize(kPackedBlockSize);
+        block_out.resize(kPackedBlockSize);
+        for (std::size_t first = lo; first < hi; first += kPackedBlockSize) {
+            const std::size_t count = std::min(kPackedBlockSize, hi - first);
+            if (count < kPackedBlockSize) {
+                block_in.resize(count);
+                block_out.resize(count);
+            }
+            for (std::size_t j = 0; j < count; ++j) {
+                packed[j] = codebook.designAt(begin + first + j);
+            }
+            codebook.decodeBlock(packed, count, block_in);
+            evaluateBatchRange(block_in, block_out, 0, count, fluid);
+            visit(static_cast<const DesignBatch<double>&>(block_in), static_cast<const OutputBatch<double>&>(block_out),
+                  begin + first, worker);
+        }
+    }, kPackedBlockSize);
+}
+
+}  // namespace vc
@@ -0,0 +1,65 @@
+#pragma once
+// Minimal std::thread fan-out used by the batch evaluators.
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace vc {
+
+namespace detail {
+
+inline unsigned& workerCountOverride() {
+    static unsigned n = 0;
+    return n;
+}
+
+}  // namespace detail
+
+// Caps parallelFor at `n` workers (0 = one per hardware thread). Set it
+// between parallel calls, not during one; tests use it to compare thread
+// counts.
+inline void setWorkerCount(unsigned n) {
+    detail::workerCountOverride() = n;
+}
+
+inline unsigned workerCount() {
+    if (detail::workerCountOverride() > 0) {
+        return detail::workerCountOverride();
+    }
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// Splits [0, n) into contiguous chunks of at least `grain` items and calls
+// fn(begin, end, worker) on each, one chunk per worker thread.
+template <class Fn>
+void parallelFor(std::size_t n, Fn&& fn, std::size_t grain = 256) {
+    if (n == 0) {
+        return;
+    }
+    const std::size_t max_workers = (n + grain - 1) / grain;
+    const std::size_t workers = std::min<std::size_t>(workerCount(), max_workers);
+    if (workers <= 1) {
+        fn(std::size_t{0}, n, 0u);
+        return;
+    }
+    const std::size_t chunk = (n + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; ++w) {
+        const std::size_t begin = w * chunk;
+        const std::size_t end = std::min(n, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        threads.emplace_back([&fn, begin, end, w] { fn(begin, end, w); });
+    }
+    fn(std::size_t{0}, std::min(n, chunk), 0u);
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+}  // namespace vc
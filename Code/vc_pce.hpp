@@ -0,0 +1,438 @@
+#pragma once
+// Polynomial-chaos surrogates of the 1D model.
+//
+// Each uncertain input is written as a function of a germ variable: a standard
+// normal for Normal / LogNormal inputs (Hermite polynomials) and a uniform on
+// [-1, 1] otherwise (Legendre polynomials, through the input CDF). Outputs are
+// expanded in products of these orthonormal polynomials over a hyperbolic
+// index set, sum_i alpha_i^q <= p^q, which keeps the main effects and low-order
+// interactions and drops most high-order cross terms.
+//
+// Coefficients are the least-squares fit on scrambled Sobol points evaluated
+// through the batch kernel. The Gram matrix is assembled in parallel and
+// factored once for all outputs. Because the basis is orthonormal, mean,
+// variance and Sobol indices are sums of squared coefficients, so a fitted
+// surrogate answers UQ questions without further model calls.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_distributions.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_qmc.hpp"
+
+namespace vc {
+
+struct PolynomialChaosOptions {
+    int degree = 4;                                                   // p
+    double q_norm = 0.75;                                             // Hyperbolic truncation, 1 = total degree
+    double oversampling = 3;                                          // Training points per basis term
+    std::vector<std::string> outputs{"Q_max", "R_total_corrected"};
+    double prune_tolerance = 0;                                       // Drop terms with c^2 < tol * variance in every output, then refit
+    unsigned long long seed = 1;
+};
+
+namespace detail {
+
+// Orthonormal 1D polynomials psi_0..psi_p at x; Hermite when `normal_germ`, else Legendre.
+inline void orthonormalPolynomials(double x, int p, bool normal_germ, double* psi) {
+    psi[0] = 1;
+    if (p == 0) {
+        return;
+    }
+    psi[1] = x;
+    for (int n = 1; n < p; ++n) {
+        psi[n + 1] = normal_germ ? x * psi[n] - n * psi[n - 1]
+                                 : ((2 * n + 1) * x * psi[n] - n * psi[n - 1]) / (n + 1);
+    }
+    double f = 1;
+    for (int n = 1; n <= p; ++n) {
+        if (normal_germ) {
+            f *= n;
+            psi[n] /= std::sqrt(f);   // ||He_n||^2 = n!
+        } else {
+            psi[n] *= std::sqrt(2.0 * n + 1);
+        }
+    }
+}
+
+// In-place Cholesky of an n x n SPD matrix (lower triangle).
+inline bool choleskyFactor(std::vector<double>& A, std::size_t n) {
+    for (std::size_t j = 0; j < n; ++j) {
+        double s = A[j * n + j];
+        for (std::size_t k = 0; k < j; ++k) {
+            s -= A[j * n + k] * A[j * n + k];
+        }
+        if (!(s > 0)) {
+            return false;
+        }
+        A[j * n + j] = std::sqrt(s);
+        for (std::size_t i = j + 1; i < n; ++i) {
+            double t = A[i * n + j];
+            for (std::size_t k = 0; k < j; ++k) {
+                t -= A[i * n + k] * A[j * n + k];
+            }
+            A[i * n + j] = t / A[j * n + j];
+        }
+    }
+    return true;
+}
+
+inline void choleskyForward(const std::vector<double>& L, std::size_t n, double* x) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double s = x[i];
+        for (std::size_t k = 0; k < i; ++k) {
+            s -= L[i * n + k] * x[k];
+        }
+        x[i] = s / L[i * n + i];
+    }
+}
+
+inline void choleskyBackward(const std::vector<double>& L, std::size_t n, double* x) {
+    for (std::size_t i = n; i-- > 0;) {
+        double s = x[i];
+        for (std::size_t k = i + 1; k < n; ++k) {
+            s -= L[k * n + i] * x[k];
+        }
+        x[i] = s / L[i * n + i];
+    }
+}
+
+}  // namespace detail
+
+class PolynomialChaos {
+public:
+    PolynomialChaos() = default;
+
+    std::size_t inputCount() const { return inputs_.size(); }
+    std::size_t termCount() const { return terms_; }
+    std::size_t outputCount() const { return outputs_.size(); }
+    const std::string& outputName(std::size_t k) const { return outputs_[k]; }
+    const std::vector<UncertainInput>& inputs() const { return inputs_; }
+
+    // Multi-index of term t (inputCount() degrees).
+    const int* term(std::size_t t) const { return &alpha_[t * inputs_.size()]; }
+    double coefficient(std::size_t k, std::size_t t) const { return coef_[k][t]; }
+
+    double mean(std::size_t k) const { return coef_[k][0]; }
+
+    double variance(std::size_t k) const {
+        double v = 0;
+        for (std::size_t t = 1; t < terms_; ++t) {
+            v += coef_[k][t] * coef_[k][t];
+        }
+        return v;
+    }
+
+    // Share of the variance from input i alone.
+    double firstOrderIndex(std::size_t k, std::size_t i) const {
+        double s = 0;
+        for (std::size_t t = 1; t < terms_; ++t) {
+            const int* a = term(t);
+            bool only_i = a[i] > 0;
+            for (std::size_t j = 0; j < inputs_.size() && only_i; ++j) {
+                only_i = j == i || a[j] == 0;
+            }
+            if (only_i) {
+                s += coef_[k][t] * coef_[k][t];
+            }
+        }
+        return s / variance(k);
+    }
+
+    // Share of the variance from every term that involves input i.
+    double totalIndex(std::size_t k, std::size_t i) const {
+        double s = 0;
+        for (std::size_t t = 1; t < terms_; ++t) {
+            if (term(t)[i] > 0) {
+                s += coef_[k][t] * coef_[k][t];
+            }
+        }
+        return s / variance(k);
+    }
+
+    // Leave-one-out error relative to the output variance (from the hat matrix).
+    double looError(std::size_t k) const { return loo_error_[k]; }
+
+    // Germ coordinates of a design (one per uncertain input).
+    void germ(const DesignInputs<double>& d, double* xi) const {
+        for (std::size_t i = 0; i < inputs_.size(); ++i) {
+            const double x = d.*(inputs_[i].field);
+            xi[i] = germFromUnit(i, inputs_[i].dist.cdf(x));
+        }
+    }
+
+    // Surrogate value of output k at germ coordinates xi.
+    double evaluateGerm(std::size_t k, const double* xi) const {
+        std::vector<double> psi;
+        basisTable(xi, psi);
+        double y = 0;
+        for (std::size_t t = 0; t < terms_; ++t) {
+            y += coef_[k][t] * product(t, psi);
+        }
+        return y;
+    }
+
+    double evaluate(std::size_t k, const DesignInputs<double>& d) const {
+        std::vector<double> xi(inputs_.size());
+        germ(d, xi.data());
+        return evaluateGerm(k, xi.data());
+    }
+
+private:
+    friend PolynomialChaos fitPolynomialChaos(const DesignInputs<double>&, const std::vector<UncertainInput>&,
+                                              const PolynomialChaosOptions&, const FluidProperties&);
+
+    bool normalGerm(std::size_t i) const {
+        const InputDistribution::Kind k = inputs_[i].dist.kind;
+        return k == InputDistribution::Normal || k == InputDistribution::LogNormal;
+    }
+
+    double germFromUnit(std::size_t i, double u) const {
+        return normalGerm(i) ? inverseNormalCdf(u) : 2 * u - 1;
+    }
+
+    // psi[i * (degree + 1) + n] = psi_n(xi_i)
+    void basisTable(const double* xi, std::vector<double>& psi) const {
+        const std::size_t stride = degree_ + 1;
+        psi.resize(inputs_.size() * stride);
+        for (std::size_t i = 0; i < inputs_.size(); ++i) {
+            detail::orthonormalPolynomials(xi[i], degree_, normalGerm(i), &psi[i * stride]);
+        }
+    }
+
+    double product(std::size_t t, const std::vector<double>& psi) const {
+        const std::size_t stride = degree_ + 1;
+        const int* a = term(t);
+        double v = 1;
+        for (std::size_t i = 0; i < inputs_.size(); ++i) {
+            v *= psi[i * stride + a[i]];
+        }
+        return v;
+    }
+
+    // Hyperbolic index set in graded order, constant term first.
+    void buildIndexSet(double q) {
+        const std::size_t d = inputs_.size();
+        alpha_.clear();
+        std::vector<int> a(d, 0);
+        const double limit = std::pow(static_cast<double>(degree_), q) * (1 + 1e-12);
+        for (int total = 0; total <= degree_; ++total) {
+            // Enumerate all a with sum == total
+            std::fill(a.begin(), a.end(), 0);
+            a[0] = total;
+            while (true) {
+                double norm = 0;
+                for (int v : a) {
+                    norm += std::pow(static_cast<double>(v), q);
+                }
+                if (norm <= limit) {
+                    alpha_.insert(alpha_.end(), a.begin(), a.end());
+                }
+                // Next composition of `total` into d parts
+                std::size_t j = 0;
+                while (j + 1 < d && a[j] == 0) {
+                    ++j;
+                }
+                if (j + 1 >= d) {
+                    break;
+                }
+                const int v = a[j];
+                a[j] = 0;
+                a[0] = v - 1;
+                ++a[j + 1];
+            }
+        }
+        terms_ = alpha_.size() / d;
+    }
+
+    std::vector<UncertainInput> inputs_;
+    std::vector<std::string> outputs_;
+    int degree_ = 0;
+    std::size_t terms_ = 0;
+    std::vector<int> alpha_;                     // terms_ x inputCount()
+    std::vector<std::vector<double>> coef_;      // outputs x terms_
+    std::vector<double> loo_error_;
+};
+
+// Fits surrogates of opt.outputs over `inputs` around `nominal`.
+inline PolynomialChaos fitPolynomialChaos(const DesignInputs<double>& nominal, const std::vector<UncertainInput>& inputs,
+                                          const PolynomialChaosOptions& opt = PolynomialChaosOptions{},
+                                          const FluidProperties& fluid = FluidProperties{}) {
+    const std::size_t d = inputs.size();
+    if (d == 0 || d > static_cast<std::size_t>(SobolSequence::kMaxDims) || opt.degree < 0) {
+        throw std::invalid_argument("fitPolynomialChaos needs 1.." + std::to_string(SobolSequence::kMaxDims) +
+                                    " inputs and a non-negative degree");
+    }
+    PolynomialChaos pce;
+    pce.inputs_ = inputs;
+    pce.outputs_ = opt.outputs;
+    pce.degree_ = opt.degree;
+    pce.buildIndexSet(opt.q_norm);
+    const std::size_t n_out = opt.outputs.size();
+    std::vector<std::vector<double> OutputBatch<double>::*> columns;
+    for (const std::string& name : opt.outputs) {
+        columns.push_back(outputColumn<double>(name));
+    }
+
+    // --- Training set: scrambled Sobol points through the batch kernel ---
+    const std::size_t n_points = static_cast<std::size_t>(std::ceil(opt.oversampling * pce.terms_)) + 1;
+    const SobolSequence sequence(static_cast<int>(d), Scrambling::Owen, opt.seed);
+    DesignBatch<double> lanes;
+    OutputBatch<double> out;
+    sampleDesignBatch(sequence, 0, n_points, nominal, inputs, lanes);
+    evaluateBatch(lanes, out, fluid);
+    std::vector<double> xi(n_points * d);
+    {
+        SobolSequence seq = sequence;
+        std::vector<double> u(n_points * d);
+        seq.fillBlock(n_points, u.data(), n_points);
+        for (std::size_t n = 0; n < n_points; ++n) {
+            for (std::size_t i = 0; i < d; ++i) {
+                xi[n * d + i] = pce.germFromUnit(i, u[i * n_points + n]);
+            }
+        }
+    }
+    std::vector<char> usable(n_points, 1);
+    for (std::size_t n = 0; n < n_points; ++n) {
+        for (std::size_t k = 0; k < n_out; ++k) {
+            usable[n] = usable[n] && std::isfinite((out.*(columns[k]))[n]);
+        }
+    }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const std::size_t P = pce.terms_;
+        // --- Normal equations, partial sums per worker ---
+        const unsigned workers = workerCount();
+        std::vector<std::vector<double>> gram(workers, std::vector<double>(P * P, 0.0));
+        std::vector<std::vector<double>> rhs(workers, std::vector<double>(n_out * P, 0.0));
+        parallelFor(n_points, [&](std::size_t begin, std::size_t end, unsigned w) {
+            std::vector<double> psi;
+            std::vector<double> row(P);
+            double* G = gram[w].data();
+            double* r = rhs[w].data();
+            for (std::size_t n = begin; n < end; ++n) {
+                if (!usable[n]) {
+                    continue;
+                }
+                pce.basisTable(&xi[n * d], psi);
+                for (std::size_t t = 0; t < P; ++t) {
+                    row[t] = pce.product(t, psi);
+                }
+                for (std::size_t a = 0; a < P; ++a) {
+                    for (std::size_t b = 0; b <= a; ++b) {
+                        G[a * P + b] += row[a] * row[b];
+                    }
+                }
+                for (std::size_t k = 0; k < n_out; ++k) {
+                    const double y = (out.*(columns[k]))[n];
+                    for (std::size_t t = 0; t < P; ++t) {
+                        r[k * P + t] += row[t] * y;
+                    }
+                }
+            }
+        }, 64);
+        std::vector<double> L(P * P, 0.0);
+        std::vector<double> b(n_out * P, 0.0);
+        for (unsigned w = 0; w < workers; ++w) {
+            for (std::size_t i = 0; i < P * P; ++i) {
+                L[i] += gram[w][i];
+            }
+            for (std::size_t i = 0; i < n_out * P; ++i) {
+                b[i] += rhs[w][i];
+            }
+        }
+        double trace = 0;
+        for (std::size_t a = 0; a < P; ++a) {
+            trace += L[a * P + a];
+        }
+        for (std::size_t a = 0; a < P; ++a) {
+            L[a * P + a] += 1e-12 * trace / P;   // Guards against exactly collinear columns
+        }
+        if (!detail::choleskyFactor(L, P)) {
+            throw std::runtime_error("fitPolynomialChaos: singular design matrix, increase oversampling");
+        }
+        pce.coef_.assign(n_out, std::vector<double>(P));
+        for (std::size_t k = 0; k < n_out; ++k) {
+            double* c = &b[k * P];
+            detail::choleskyForward(L, P, c);
+            detail::choleskyBackward(L, P, c);
+            pce.coef_[k].assign(c, c + P);
+        }
+
+        // --- Leave-one-out residuals e_n / (1 - h_n) ---
+        std::vector<std::vector<double>> loo(workers, std::vector<double>(n_out, 0.0));
+        std::vector<double> used(workers, 0.0);
+        parallelFor(n_points, [&](std::size_t begin, std::size_t end, unsigned w) {
+            std::vector<double> psi;
+            std::vector<double> row(P);
+            for (std::size_t n = begin; n < end; ++n) {
+                if (!usable[n]) {
+                    continue;
+                }
+                pce.basisTable(&xi[n * d], psi);
+                for (std::size_t t = 0; t < P; ++t) {
+                    row[t] = pce.product(t, psi);
+                }
+                std::vector<double> v = row;
+                detail::choleskyForward(L, P, v.data());
+                double h = 0;
+                for (double x : v) {
+                    h += x * x;
+                }
+                for (std::size_t k = 0; k < n_out; ++k) {
+                    double yhat = 0;
+                    for (std::size_t t = 0; t < P; ++t) {
+                        yhat += pce.coef_[k][t] * row[t];
+                    }
+                    const double e = ((out.*(columns[k]))[n] - yhat) / std::max(1 - h, 1e-12);
+                    loo[w][k] += e * e;
+                }
+                used[w] += 1;
+            }
+        }, 64);
+        pce.loo_error_.assign(n_out, 0.0);
+        double n_used = 0;
+        for (unsigned w = 0; w < workers; ++w) {
+            n_used += used[w];
+            for (std::size_t k = 0; k < n_out; ++k) {
+                pce.loo_error_[k] += loo[w][k];
+            }
+        }
+        for (std::size_t k = 0; k < n_out; ++k) {
+            const double v = pce.variance(k);
+            pce.loo_error_[k] = v > 0 ? pce.loo_error_[k] / n_used / v : 0;
+        }
+
+        if (pass == 1 || !(opt.prune_tolerance > 0)) {
+            break;
+        }
+        // --- Drop negligible terms everywhere and refit on the same points ---
+        std::vector<int> kept;
+        std::size_t n_kept = 0;
+        for (std::size_t t = 0; t < P; ++t) {
+            bool keep = t == 0;
+            for (std::size_t k = 0; k < n_out && !keep; ++k) {
+                keep = pce.coef_[k][t] * pce.coef_[k][t] >= opt.prune_tolerance * pce.variance(k);
+            }
+            if (keep) {
+                kept.insert(kept.end(), pce.term(t), pce.term(t) + d);
+                ++n_kept;
+            }
+        }
+        if (n_kept == P) {
+            break;
+        }
+        pce.alpha_ = std::move(kept);
+        pce.terms_ = n_kept;
+    }
+    return pce;
+}
+
+}  // namespace vc
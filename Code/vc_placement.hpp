@@ -0,0 +1,330 @@
+#pragma once
+// Placement of several dies on the evaporator plate.
+//
+// Wall conduction (vc_spectral.hpp) and Darcy liquid return are both linear
+// in the heat map, so the fields of any layout are sums of per-die unit
+// responses. Each die may sit at any corner position on a lattice of pitch
+// `step`. The wall-rise and liquid-pressure fields of a 1 W die at every
+// candidate position are solved once up front, in parallel over candidates;
+// dies with the same footprint share them. A layout is then scored by
+// adding power * response for each die. Moving one die is two vector
+// updates per field plus a max/min scan.
+//
+// The Darcy field uses the parallel-wick conductance of vc_wick_flow.hpp,
+// with condensation spread uniformly over the plate. That keeps the source
+// independent of the layout, so superposition is exact. The objective trades
+// the peak wall rise against the capillary margin:
+//
+//     J = theta_peak / theta_1D - margin_weight * (dP_cap - dP_total) / dP_cap
+//
+// theta_1D = Q / (h A_plate) is the rise with perfectly uniform spreading.
+// J is minimized by simulated annealing from several random non-overlapping
+// starts. The starts run in parallel and each has its own RNG stream, so the
+// result does not depend on the thread count.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_qmc.hpp"
+#include "vc_spectral.hpp"
+
+namespace vc {
+
+struct Die {
+    double length = 0.010;   // Along vc_length [m]
+    double width = 0.010;    // Along vc_width [m]
+    double power = 50;       // [W]
+};
+
+struct PlacementOptions {
+    int nx = 64;                   // Plate grid for the unit responses
+    int ny = 64;
+    double step = 0.0025;          // Candidate corner pitch [m]
+    double clearance = 0.001;      // Minimum gap between dies [m]
+    double margin_weight = 1;
+    int restarts = 8;
+    int iterations = 4000;         // Annealing moves per restart
+    double temperature_start = 0.05;
+    double temperature_end = 1e-4;
+    unsigned long long seed = 1;
+};
+
+struct PlacementResult {
+    std::vector<HeatSource> layout;   // One per die, same order
+    double theta_peak = 0;            // Peak evaporator wall rise above vapor [K]
+    double dP_l = 0;                  // Liquid pressure drop of the layout [Pa]
+    double capillary_margin = 0;      // dP_cap - dP_total [Pa]
+    double objective = 0;
+    std::size_t layouts_evaluated = 0;
+};
+
+namespace detail {
+
+// Unit wall-rise and pressure responses of one die footprint at every candidate corner.
+struct FootprintResponses {
+    double length = 0;
+    double width = 0;
+    int cx = 0;   // Candidates along x and y
+    int cy = 0;
+    std::vector<double> theta;      // (cx * cy) x cells
+    std::vector<double> pressure;   // (cx * cy) x cells
+};
+
+}  // namespace detail
+
+class DiePlacementProblem {
+public:
+    DiePlacementProblem(const DesignInputs<double>& in, const std::vector<Die>& dies,
+                        const PlacementOptions& opt = PlacementOptions{},
+                        const FluidProperties& fluid = FluidProperties{})
+        : dies_(dies), opt_(opt) {
+        cells_ = static_cast<std::size_t>(opt.nx) * opt.ny;
+        double total = 0;
+        for (const Die& d : dies) {
+            total += d.power;
+            if (d.length > in.vc_length || d.width > in.vc_width) {
+                throw std::invalid_argument("DiePlacementProblem: die larger than the plate");
+            }
+        }
+        DesignInputs<double> design = in;
+        design.Q_in = total;
+        const ModelOutputs<double> out = evaluateModel(design, fluid);
+        const SpectralSpreadingSolver wall(design, out, opt.nx, opt.ny);
+        const SpectralPlateSolver darcy(opt.nx, opt.ny, in.vc_length, in.vc_width,
+                                        (out.K_evap * out.t_evap_wick + out.K_cond * out.t_cond_wick) / fluid.mu_l, 0);
+        theta_1d_ = total / (wall.sinkConductance() * in.vc_length * in.vc_width);
+        dP_cap_ = out.dP_cap;
+        dP_other_ = out.dP_v + out.dP_g;
+        const double vol_rate = 1 / (fluid.rho_l * fluid.h_fg);
+        const double plate_area = in.vc_length * in.vc_width;
+
+        for (const Die& d : dies) {
+            std::size_t f = 0;
+            while (f < footprints_.size() && !(footprints_[f].length == d.length && footprints_[f].width == d.width)) {
+                ++f;
+            }
+            footprint_of_.push_back(f);
+            if (f < footprints_.size()) {
+                continue;
+            }
+            detail::FootprintResponses r;
+            r.length = d.length;
+            r.width = d.width;
+            r.cx = static_cast<int>(std::floor((in.vc_length - d.length) / opt.step + 1e-9)) + 1;
+            r.cy = static_cast<int>(std::floor((in.vc_width - d.width) / opt.step + 1e-9)) + 1;
+            const std::size_t n_cand = static_cast<std::size_t>(r.cx) * r.cy;
+            r.theta.resize(n_cand * cells_);
+            r.pressure.resize(n_cand * cells_);
+            parallelFor(n_cand, [&](std::size_t begin, std::size_t end, unsigned) {
+                std::vector<double> field;
+                std::vector<double> s(cells_);
+                for (std::size_t c = begin; c < end; ++c) {
+                    const HeatSource src{(c % r.cx) * opt.step, (c / r.cx) * opt.step, d.length, d.width, 1.0};
+                    const std::vector<double> q = rasterizePowerMap(opt.nx, opt.ny, in.vc_length, in.vc_width, {src});
+                    wall.solve(q, field, false);
+                    std::copy(field.begin(), field.end(), &r.theta[c * cells_]);
+                    for (std::size_t k = 0; k < cells_; ++k) {
+                        s[k] = vol_rate * (1 / plate_area - q[k]);
+                    }
+                    darcy.solve(s, field, false);
+                    std::copy(field.begin(), field.end(), &r.pressure[c * cells_]);
+                }
+            }, 1);
+            footprints_.push_back(std::move(r));
+        }
+    }
+
+    std::size_t dieCount() const { return dies_.size(); }
+    std::size_t candidateCount(std::size_t die) const {
+        const detail::FootprintResponses& r = footprints_[footprint_of_[die]];
+        return static_cast<std::size_t>(r.cx) * r.cy;
+    }
+
+    // Candidates along x; candidate c is at column c % cx, row c / cx.
+    std::size_t candidateColumns(std::size_t die) const {
+        return static_cast<std::size_t>(footprints_[footprint_of_[die]].cx);
+    }
+
+    HeatSource source(std::size_t die, std::size_t candidate) const {
+        const detail::FootprintResponses& r = footprints_[footprint_of_[die]];
+        return {(candidate % r.cx) * opt_.step, (candidate / r.cx) * opt_.step, dies_[die].length, dies_[die].width,
+                dies_[die].power};
+    }
+
+    // True when the two dies at these candidates keep the clearance.
+    bool separated(std::size_t a, std::size_t ca, std::size_t b, std::size_t cb) const {
+        const HeatSource p = source(a, ca);
+        const HeatSource q = source(b, cb);
+        const double g = opt_.clearance;
+        return p.x0 + p.length + g <= q.x0 + 1e-12 || q.x0 + q.length + g <= p.x0 + 1e-12 ||
+               p.y0 + p.width + g <= q.y0 + 1e-12 || q.y0 + q.width + g <= p.y0 + 1e-12;
+    }
+
+    // Adds power * unit response of `die` at `candidate` (times `sign`) to the fields.
+    void accumulate(std::size_t die, std::size_t candidate, double sign, std::vector<double>& theta,
+                    std::vector<double>& pressure) const {
+        const detail::FootprintResponses& r = footprints_[footprint_of_[die]];
+        const double w = sign * dies_[die].power;
+        const double* t = &r.theta[candidate * cells_];
+        const double* p = &r.pressure[candidate * cells_];
+        for (std::size_t k = 0; k < cells_; ++k) {
+            theta[k] += w * t[k];
+            pressure[k] += w * p[k];
+        }
+    }
+
+    // Scores summed fields; fills the physical quantities of `res`.
+    double score(const std::vector<double>& theta, const std::vector<double>& pressure, PlacementResult* res) const {
+        const double peak = *std::max_element(theta.begin(), theta.end());
+        const auto mm = std::minmax_element(pressure.begin(), pressure.end());
+        const double dP_l = *mm.second - *mm.first;
+        const double margin = dP_cap_ - (dP_l + dP_other_);
+        if (res) {
+            res->theta_peak = peak;
+            res->dP_l = dP_l;
+            res->capillary_margin = margin;
+        }
+        return peak / theta_1d_ - opt_.margin_weight * margin / dP_cap_;
+    }
+
+    std::size_t cells() const { return cells_; }
+
+private:
+    std::vector<Die> dies_;
+    PlacementOptions opt_;
+    std::size_t cells_ = 0;
+    double theta_1d_ = 1;
+    double dP_cap_ = 1;
+    double dP_other_ = 0;
+    std::vector<detail::FootprintResponses> footprints_;
+    std::vector<std::size_t> footprint_of_;
+};
+
+// Simulated annealing over candidate positions of every die.
+inline PlacementResult optimizeDiePlacement(const DesignInputs<double>& in, const std::vector<Die>& dies,
+                                            const PlacementOptions& opt = PlacementOptions{},
+                                            const FluidProperties& fluid = FluidProperties{}) {
+    if (dies.empty()) {
+        throw std::invalid_argument("optimizeDiePlacement needs at least one die");
+    }
+    const DiePlacementProblem problem(in, dies, opt, fluid);
+    const std::size_t n_dies = dies.size();
+    const std::size_t restarts = static_cast<std::size_t>(std::max(opt.restarts, 1));
+    std::vector<PlacementResult> best(restarts);
+    std::vector<std::vector<std::size_t>> best_pos(restarts);
+
+    parallelFor(restarts, [&](std::size_t begin, std::size_t end, unsigned) {
+        std::vector<double> theta(problem.cells());
+        std::vector<double> pressure(problem.cells());
+        for (std::size_t r = begin; r < end; ++r) {
+            std::mt19937_64 g(detail::splitMix64(opt.seed * 0x9E3779B97F4A7C15ULL + r));
+            std::uniform_real_distribution<double> U(0.0, 1.0);
+            const auto fits = [&](const std::vector<std::size_t>& pos, std::size_t die, std::size_t cand) {
+                for (std::size_t o = 0; o < n_dies; ++o) {
+                    if (o != die && !problem.separated(die, cand, o, pos[o])) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            // --- Random non-overlapping start ---
+            std::vector<std::size_t> pos(n_dies, 0);
+            bool placed = false;
+            for (int attempt = 0; attempt < 1000 && !placed; ++attempt) {
+                placed = true;
+                for (std::size_t k = 0; k < n_dies && placed; ++k) {
+                    pos[k] = static_cast<std::size_t>(U(g) * problem.candidateCount(k));
+                    for (std::size_t o = 0; o < k && placed; ++o) {
+                        placed = problem.separated(k, pos[k], o, pos[o]);
+                    }
+                }
+            }
+            PlacementResult& res = best[r];
+            if (!placed) {
+                res.objective = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            std::fill(theta.begin(), theta.end(), 0.0);
+            std::fill(pressure.begin(), pressure.end(), 0.0);
+            for (std::size_t k = 0; k < n_dies; ++k) {
+                problem.accumulate(k, pos[k], 1, theta, pressure);
+            }
+            double J = problem.score(theta, pressure, nullptr);
+            res.objective = J;
+            best_pos[r] = pos;
+            res.layouts_evaluated = 1;
+
+            // --- Anneal: move one die to a random candidate, or nudge it one pitch ---
+            for (int it = 0; it < opt.iterations; ++it) {
+                const double frac = static_cast<double>(it) / std::max(opt.iterations - 1, 1);
+                const double T = opt.temperature_start * std::pow(opt.temperature_end / opt.temperature_start, frac);
+                const std::size_t k = static_cast<std::size_t>(U(g) * n_dies) % n_dies;
+                const std::size_t n_cand = problem.candidateCount(k);
+                std::size_t cand;
+                if (U(g) < 0.3) {
+                    cand = static_cast<std::size_t>(U(g) * n_cand) % n_cand;
+                } else {
+                    const std::size_t cx = problem.candidateColumns(k);
+                    const long dx = static_cast<long>(U(g) * 3) - 1;
+                    const long dy = static_cast<long>(U(g) * 3) - 1;
+                    const long ix = static_cast<long>(pos[k] % cx) + dx;
+                    const long iy = static_cast<long>(pos[k] / cx) + dy;
+                    if (ix < 0 || iy < 0 || ix >= static_cast<long>(cx) || iy >= static_cast<long>(n_cand / cx)) {
+                        continue;
+                    }
+                    cand = static_cast<std::size_t>(iy) * cx + static_cast<std::size_t>(ix);
+                }
+                if (cand == pos[k] || !fits(pos, k, cand)) {
+                    continue;
+                }
+                problem.accumulate(k, pos[k], -1, theta, pressure);
+                problem.accumulate(k, cand, 1, theta, pressure);
+                const double J_new = problem.score(theta, pressure, nullptr);
+                ++res.layouts_evaluated;
+                if (J_new <= J || U(g) < std::exp((J - J_new) / T)) {
+                    pos[k] = cand;
+                    J = J_new;
+                    if (J < res.objective) {
+                        res.objective = J;
+                        best_pos[r] = pos;
+                    }
+                } else {
+                    problem.accumulate(k, cand, -1, theta, pressure);
+                    problem.accumulate(k, pos[k], 1, theta, pressure);
+                }
+            }
+        }
+    }, 1);
+
+    std::size_t winner = 0;
+    std::size_t evaluated = 0;
+    for (std::size_t r = 0; r < restarts; ++r) {
+        evaluated += best[r].layouts_evaluated;
+        if (best[r].objective < best[winner].objective) {
+            winner = r;
+        }
+    }
+    if (best_pos[winner].empty()) {
+        throw std::runtime_error("optimizeDiePlacement: could not place the dies without overlap");
+    }
+    // Rebuild the winning fields exactly (annealing updates accumulate rounding)
+    PlacementResult res;
+    std::vector<double> theta(problem.cells(), 0.0);
+    std::vector<double> pressure(problem.cells(), 0.0);
+    for (std::size_t k = 0; k < n_dies; ++k) {
+        problem.accumulate(k, best_pos[winner][k], 1, theta, pressure);
+        res.layout.push_back(problem.source(k, best_pos[winner][k]));
+    }
+    res.objective = problem.score(theta, pressure, &res);
+    res.layouts_evaluated = evaluated;
+    return res;
+}
+
+}  // namespace vc
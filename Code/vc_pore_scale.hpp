@@ -0,0 +1,455 @@
+#pragma once
+// Pore-scale permeability and capillary radius of screen-mesh stacks.
+//
+// The model's K (Kozeny-Carman, constant 122) and rc_eff = 1 / (2N) ignore how
+// the layers of a stack sit on each other. Here a stack is voxelized from its
+// geometry and the two properties are computed directly:
+//
+//   Geometry:  plain-weave layers of thickness 2 d, wire centerlines
+//              z = z_c +- (d / 2) sin(pi x / p) (p = 1 / N), over a periodic
+//              2p x 2p cell. Layer k is shifted in-plane by k * offset * p.
+//              The stack sits on the chamber wall (no slip) and is open on
+//              top (free slip, the liquid surface).
+//   K:         steady Stokes flow along the wires, driven by a uniform body
+//              force. It is solved by a D3Q19 two-relaxation-time lattice
+//              Boltzmann scheme with linear (Stokes) equilibria and the
+//              "magic" Lambda = 3/16, so K does not depend on the relaxation
+//              time. K = nu <u> / force, with <u> the superficial velocity.
+//   rc_eff:    vapor drying the evaporator wick has to push a meniscus from
+//              the top of the stack to the wall. The widest path through the
+//              pore space (maximin of the distance to the nearest wire) gives
+//              the bottleneck radius r_b. rc_eff = r_b + d / 2, which
+//              reproduces the single-screen (w + d) / 2 = 1 / (2N).
+//
+// A solve takes seconds, so results go in a WickTable keyed by (mesh number,
+// wire diameter, layers, layer offsets). The table is filled once per catalog
+// entry, in parallel over entries. evaluateModel(in, table) then uses table
+// K / rc_eff for any wick found there and the correlations for the rest.
+// DesignInputs has no offset fields, so the offsets to look up are given per
+// call (WickLayerOffsets, aligned stacks by default).
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+struct ScreenStack {
+    double mesh_number_wpi = 200;
+    double d_w = 0.000051;     // [m]
+    int layers = 5;
+    double offset_x = 0;       // In-plane shift between consecutive layers [fraction of pitch]
+    double offset_y = 0;
+};
+
+struct PoreScaleOptions {
+    int voxels_per_wire = 5;     // Voxels across d_w (the pitch is rounded to whole voxels)
+    double tau = 1.0;            // Symmetric relaxation time (K does not depend on it)
+    double tolerance = 1e-6;     // Relative change of <u> per check interval
+    int check_interval = 100;
+    int max_steps = 50000;
+};
+
+struct PoreScaleResult {
+    double K = 0;                // In-plane permeability along the wires [m^2]
+    double rc_eff = 0;           // [m]
+    double bottleneck_radius = 0;   // Widest-path pore radius, top to wall [m]
+    double porosity = 0;         // Voxel porosity of the stack
+    int steps = 0;
+    bool converged = false;
+    std::array<int, 3> grid{};   // nx, ny, nz
+};
+
+namespace detail {
+
+// Voxel geometry: distance from each voxel center to the nearest wire surface
+// (negative inside a wire), over an nx * ny * nz grid with x fastest.
+struct ScreenVoxels {
+    int nx = 0;
+    int ny = 0;
+    int nz = 0;
+    double dx = 0;                 // Voxel size [m]
+    std::vector<double> clearance;   // [m]
+
+    std::size_t index(int x, int y, int z) const {
+        return (static_cast<std::size_t>(z) * ny + y) * nx + x;
+    }
+};
+
+inline ScreenVoxels voxelizeScreenStack(const ScreenStack& s, int voxels_per_wire) {
+    if (s.mesh_number_wpi <= 0 || s.d_w <= 0 || s.layers < 1 || voxels_per_wire < 2) {
+        throw std::invalid_argument("voxelizeScreenStack: invalid stack");
+    }
+    const double p = 0.0254 / s.mesh_number_wpi;
+    const double d = s.d_w;
+    if (d >= p) {
+        throw std::invalid_argument("voxelizeScreenStack: wire diameter exceeds the pitch");
+    }
+    ScreenVoxels v;
+    const int per_pitch = std::max(3, static_cast<int>(std::lround(p / d * voxels_per_wire)));
+    v.dx = p / per_pitch;
+    v.nx = 2 * per_pitch;
+    v.ny = 2 * per_pitch;
+    const int per_layer = std::max(2, static_cast<int>(std::lround(2 * d / v.dx)));
+    v.nz = per_layer * s.layers;
+    const double layer_t = per_layer * v.dx;
+    const double cell = 2 * p;
+    const double k_wave = M_PI / p;
+    const auto wrap = [cell](double a) { return a - cell * std::floor(a / cell + 0.5); };
+
+    v.clearance.resize(static_cast<std::size_t>(v.nx) * v.ny * v.nz);
+    for (int z = 0; z < v.nz; ++z) {
+        const int layer = z / per_layer;
+        const double zc = (layer + 0.5) * layer_t;
+        const double ox = layer * s.offset_x * p;
+        const double oy = layer * s.offset_y * p;
+        const double pz = (z + 0.5) * v.dx;
+        for (int y = 0; y < v.ny; ++y) {
+            const double py = (y + 0.5) * v.dx - oy;
+            for (int x = 0; x < v.nx; ++x) {
+                const double px = (x + 0.5) * v.dx - ox;
+                double best = 1e300;
+                for (int k = 0; k < 2; ++k) {
+                    const double sign = k == 0 ? 1.0 : -1.0;
+                    // Warp k along x at y = (k + 1/2) p; weft k along y at x = (k + 1/2) p.
+                    // Distance to z = f(t) is approximated by |z - f| / sqrt(1 + f'^2).
+                    const double fw = zc + sign * d / 2 * std::sin(k_wave * px);
+                    const double sw = sign * d / 2 * k_wave * std::cos(k_wave * px);
+                    const double ew = wrap(py - (k + 0.5) * p);
+                    best = std::min(best, std::sqrt(ew * ew + (pz - fw) * (pz - fw) / (1 + sw * sw)));
+                    const double ff = zc - sign * d / 2 * std::sin(k_wave * py);
+                    const double sf = sign * d / 2 * k_wave * std::cos(k_wave * py);
+                    const double ef = wrap(px - (k + 0.5) * p);
+                    best = std::min(best, std::sqrt(ef * ef + (pz - ff) * (pz - ff) / (1 + sf * sf)));
+                }
+                v.clearance[v.index(x, y, z)] = best - d / 2;
+            }
+        }
+    }
+    return v;
+}
+
+// Widest path (maximin clearance) through fluid voxels from the top layer to the bottom one.
+inline double bottleneckRadius(const ScreenVoxels& v) {
+    const std::size_t n = v.clearance.size();
+    std::vector<double> best(n, -1.0);
+    std::priority_queue<std::pair<double, std::size_t>> open;
+    for (int y = 0; y < v.ny; ++y) {
+        for (int x = 0; x < v.nx; ++x) {
+            const std::size_t i = v.index(x, y, v.nz - 1);
+            if (v.clearance[i] > 0) {
+                best[i] = v.clearance[i];
+                open.push({best[i], i});
+            }
+        }
+    }
+    const std::size_t plane = static_cast<std::size_t>(v.nx) * v.ny;
+    while (!open.empty()) {
+        const auto [width, i] = open.top();
+        open.pop();
+        if (width < best[i]) {
+            continue;
+        }
+        const int z = static_cast<int>(i / plane);
+        if (z == 0) {
+            return width;   // Max-heap: the first bottom voxel popped is the widest path
+        }
+        const int y = static_cast<int>(i % plane) / v.nx;
+        const int x = static_cast<int>(i % v.nx);
+        const std::size_t neighbours[6] = {
+            v.index((x + 1) % v.nx, y, z), v.index((x + v.nx - 1) % v.nx, y, z),
+            v.index(x, (y + 1) % v.ny, z), v.index(x, (y + v.ny - 1) % v.ny, z),
+            v.index(x, y, z - 1),          z + 1 < v.nz ? v.index(x, y, z + 1) : i};
+        for (std::size_t j : neighbours) {
+            const double w = std::min(width, v.clearance[j]);
+            if (v.clearance[j] > 0 && w > best[j]) {
+                best[j] = w;
+                open.push({w, j});
+            }
+        }
+    }
+    return 0;   // No open path: the stack is sealed
+}
+
+// D3Q19 lattice
+constexpr int kQ = 19;
+constexpr int kCx[kQ] = {0, 1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0};
+constexpr int kCy[kQ] = {0, 0, 0, 1, -1, 0, 0, 1, -1, -1, 1, 0, 0, 0, 0, 1, -1, 1, -1};
+constexpr int kCz[kQ] = {0, 0, 0, 0, 0, 1, -1, 0, 0, 0, 0, 1, -1, -1, 1, 1, -1, -1, 1};
+constexpr int kOpposite[kQ] = {0, 2, 1, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 14, 13, 16, 15, 18, 17};
+constexpr double kWeight[kQ] = {1.0 / 3,  1.0 / 18, 1.0 / 18, 1.0 / 18, 1.0 / 18, 1.0 / 18, 1.0 / 18,
+                                1.0 / 36, 1.0 / 36, 1.0 / 36, 1.0 / 36, 1.0 / 36, 1.0 / 36, 1.0 / 36,
+                                1.0 / 36, 1.0 / 36, 1.0 / 36, 1.0 / 36, 1.0 / 36};
+
+// Direction with the z component flipped (specular reflection at the free surface).
+inline int mirrorZ(int i) {
+    for (int j = 0; j < kQ; ++j) {
+        if (kCx[j] == kCx[i] && kCy[j] == kCy[i] && kCz[j] == -kCz[i]) {
+            return j;
+        }
+    }
+    return i;
+}
+
+// Darcy permeability along x of a voxel geometry, in voxels^2, from the
+// superficial velocity of body-force-driven Stokes flow.
+inline double latticePermeability(const ScreenVoxels& v, const PoreScaleOptions& opt, bool threaded,
+                                  int& steps, bool& converged) {
+    const int nx = v.nx;
+    const int ny = v.ny;
+    const int nz = v.nz;
+    const std::size_t n = v.clearance.size();
+    std::vector<std::uint8_t> fluid(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        fluid[i] = v.clearance[i] > 0;
+    }
+
+    // Lattice units: dx = dt = 1, rho = 1
+    const double force = 1e-6;
+    const double omega_plus = 1 / opt.tau;
+    const double omega_minus = 1 / (0.5 + (3.0 / 16) / (opt.tau - 0.5));
+    const double nu = (opt.tau - 0.5) / 3;
+    std::vector<double> f(kQ * n);
+    std::vector<double> g(kQ * n, 0.0);
+    for (int q = 0; q < kQ; ++q) {
+        std::fill(&f[q * n], &f[q * n] + n, kWeight[q]);
+    }
+    int mirror[kQ];
+    for (int q = 0; q < kQ; ++q) {
+        mirror[q] = mirrorZ(q);
+    }
+    std::vector<double> slab_flux(nz);
+
+    const auto step = [&](std::size_t z_begin, std::size_t z_end, unsigned) {
+        for (std::size_t zz = z_begin; zz < z_end; ++zz) {
+            const int z = static_cast<int>(zz);
+            double flux = 0;
+            for (int y = 0; y < ny; ++y) {
+                for (int x = 0; x < nx; ++x) {
+                    const std::size_t i = v.index(x, y, z);
+                    if (!fluid[i]) {
+                        continue;
+                    }
+                    // Pull streaming with half-way bounce-back (wires, wall) and specular top
+                    double fi[kQ];
+                    for (int q = 0; q < kQ; ++q) {
+                        const int sz = z - kCz[q];
+                        if (sz < 0) {
+                            fi[q] = f[kOpposite[q] * n + i];
+                            continue;
+                        }
+                        const int sx = (x - kCx[q] + nx) % nx;
+                        const int sy = (y - kCy[q] + ny) % ny;
+                        if (sz >= nz) {
+                            // Reflected at the surface from the neighbour in the top layer
+                            const std::size_t src = v.index(sx, sy, z);
+                            fi[q] = fluid[src] ? f[mirror[q] * n + src] : f[kOpposite[q] * n + i];
+                            continue;
+                        }
+                        const std::size_t src = v.index(sx, sy, sz);
+                        fi[q] = fluid[src] ? f[q * n + src] : f[kOpposite[q] * n + i];
+                    }
+                    double rho = 0;
+                    double jx = 0;
+                    double jy = 0;
+                    double jz = 0;
+                    for (int q = 0; q < kQ; ++q) {
+                        rho += fi[q];
+                        jx += kCx[q] * fi[q];
+                        jy += kCy[q] * fi[q];
+                        jz += kCz[q] * fi[q];
+                    }
+                    jx += force / 2;
+                    flux += jx;
+                    // TRT collision with linear equilibria; the force enters the odd part
+                    for (int q = 0; q < kQ; ++q) {
+                        const int o = kOpposite[q];
+                        const double cj = kCx[q] * jx + kCy[q] * jy + kCz[q] * jz;
+                        const double eq_plus = kWeight[q] * rho;
+                        const double eq_minus = 3 * kWeight[q] * cj;
+                        const double f_plus = (fi[q] + fi[o]) / 2;
+                        const double f_minus = (fi[q] - fi[o]) / 2;
+                        g[q * n + i] = fi[q] - omega_plus * (f_plus - eq_plus) - omega_minus * (f_minus - eq_minus) +
+                                       3 * kWeight[q] * kCx[q] * force * (1 - omega_minus / 2);
+                    }
+                }
+            }
+            slab_flux[z] = flux;
+        }
+    };
+
+    double u = 0;
+    converged = false;
+    for (steps = 1; steps <= opt.max_steps; ++steps) {
+        if (threaded) {
+            parallelFor(static_cast<std::size_t>(nz), step, 2);
+        } else {
+            step(0, nz, 0u);
+        }
+        f.swap(g);
+        if (steps % opt.check_interval == 0) {
+            double total = 0;
+            for (double s : slab_flux) {
+                total += s;
+            }
+            const double previous = u;
+            u = total / n;
+            if (std::fabs(u - previous) <= opt.tolerance * std::fabs(u)) {
+                converged = true;
+                break;
+            }
+        }
+    }
+    steps = std::min(steps, opt.max_steps);
+    return nu * u / force;
+}
+
+}  // namespace detail
+
+// Permeability along x and capillary radius of one stack. `threaded` = false
+// keeps the solve on the calling thread (for callers that parallelize over stacks).
+inline PoreScaleResult solveScreenStack(const ScreenStack& stack, const PoreScaleOptions& opt = PoreScaleOptions{},
+                                        bool threaded = true) {
+    const detail::ScreenVoxels v = detail::voxelizeScreenStack(stack, opt.voxels_per_wire);
+    PoreScaleResult res;
+    res.grid = {v.nx, v.ny, v.nz};
+    std::size_t fluid_cells = 0;
+    for (double c : v.clearance) {
+        fluid_cells += c > 0;
+    }
+    res.porosity = static_cast<double>(fluid_cells) / v.clearance.size();
+    res.bottleneck_radius = detail::bottleneckRadius(v);
+    res.rc_eff = res.bottleneck_radius + stack.d_w / 2;
+    res.K = detail::latticePermeability(v, opt, threaded, res.steps, res.converged) * v.dx * v.dx;
+    return res;
+}
+
+// --- Wick characterization table ---
+struct WickTableEntry {
+    ScreenStack stack;
+    PoreScaleResult result;
+};
+
+class WickTable {
+public:
+    // Solves every stack not already in the table, in parallel over stacks.
+    void characterize(const std::vector<ScreenStack>& stacks, const PoreScaleOptions& opt = PoreScaleOptions{}) {
+        std::vector<ScreenStack> pending;
+        for (const ScreenStack& s : stacks) {
+            if (!find(s) &&
+                std::none_of(pending.begin(), pending.end(), [&](const ScreenStack& p) { return key(p) == key(s); })) {
+                pending.push_back(s);
+            }
+        }
+        std::vector<PoreScaleResult> results(pending.size());
+        parallelFor(pending.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t k = begin; k < end; ++k) {
+                results[k] = solveScreenStack(pending[k], opt, false);
+            }
+        }, 1);
+        for (std::size_t k = 0; k < pending.size(); ++k) {
+            insert(pending[k], results[k]);
+        }
+    }
+
+    // Adds a precomputed or measured entry, replacing any with the same key.
+    void insert(const ScreenStack& stack, const PoreScaleResult& result) {
+        entries_[key(stack)] = WickTableEntry{stack, result};
+    }
+
+    // Entry for a wick, or nullptr. Safe to call concurrently once filled.
+    const WickTableEntry* find(double mesh_number_wpi, double d_w, double layers, double offset_x = 0,
+                               double offset_y = 0) const {
+        const auto it = entries_.find(key(mesh_number_wpi, d_w, layers, offset_x, offset_y));
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    const WickTableEntry* find(const ScreenStack& s) const {
+        return find(s.mesh_number_wpi, s.d_w, s.layers, s.offset_x, s.offset_y);
+    }
+
+    std::size_t size() const { return entries_.size(); }
+
+    std::vector<WickTableEntry> entries() const {
+        std::vector<WickTableEntry> all;
+        for (const auto& e : entries_) {
+            all.push_back(e.second);
+        }
+        return all;
+    }
+
+private:
+    // Mesh number to 1e-3 wpi, wire diameter to 1 nm, whole layers, offsets to 1e-4 pitch
+    using Key = std::tuple<long long, long long, long long, long long, long long>;
+
+    static Key key(double mesh_number_wpi, double d_w, double layers, double offset_x, double offset_y) {
+        return Key{std::llround(mesh_number_wpi * 1e3), std::llround(d_w * 1e9), std::llround(layers),
+                   std::llround(offset_x * 1e4), std::llround(offset_y * 1e4)};
+    }
+    static Key key(const ScreenStack& s) { return key(s.mesh_number_wpi, s.d_w, s.layers, s.offset_x, s.offset_y); }
+
+    std::map<Key, WickTableEntry> entries_;
+};
+
+// Layer offsets of the evaporator and condenser stacks [fraction of pitch].
+struct WickLayerOffsets {
+    double evap_x = 0;
+    double evap_y = 0;
+    double cond_x = 0;
+    double cond_y = 0;
+};
+
+// Model with K_evap / K_cond / rc_eff from the table where the wick, with
+// the given layer offsets, is listed.
+inline ModelOutputs<double> evaluateModel(const DesignInputs<double>& in, const WickTable& table,
+                                          const WickLayerOffsets& offsets,
+                                          const FluidProperties& fluid = FluidProperties{}) {
+    ModelOutputs<double> out;
+    characterizeScreenWicks(in, out);
+    if (const WickTableEntry* e = table.find(in.mesh_number_evap_wpi, in.d_w_evap, in.num_layers_evap, offsets.evap_x,
+                                             offsets.evap_y)) {
+        out.K_evap = e->result.K;
+        out.rc_eff = e->result.rc_eff;
+    }
+    if (const WickTableEntry* e = table.find(in.mesh_number_cond_wpi, in.d_w_cond, in.num_layers_cond, offsets.cond_x,
+                                             offsets.cond_y)) {
+        out.K_cond = e->result.K;
+    }
+    evaluateFromWickProperties(in, out, fluid);
+    return out;
+}
+
+// Aligned stacks (zero offsets).
+inline ModelOutputs<double> evaluateModel(const DesignInputs<double>& in, const WickTable& table,
+                                          const FluidProperties& fluid = FluidProperties{}) {
+    return evaluateModel(in, table, WickLayerOffsets{}, fluid);
+}
+
+inline void evaluateBatch(const DesignBatch<double>& in, OutputBatch<double>& out, const WickTable& table,
+                          const WickLayerOffsets& offsets, const FluidProperties& fluid = FluidProperties{}) {
+    out.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t i = begin; i < end; ++i) {
+            out.set(i, evaluateModel(in.get(i), table, offsets, fluid));
+        }
+    });
+}
+
+inline void evaluateBatch(const DesignBatch<double>& in, OutputBatch<double>& out, const WickTable& table,
+                          const FluidProperties& fluid = FluidProperties{}) {
+    evaluateBatch(in, out, table, WickLayerOffsets{}, fluid);
+}
+
+}  // namespace vc
@@ -0,0 +1,397 @@
+#pragma once
+// Quasi-random point sets for sampling studies.
+//
+// SobolSequence is the Antonov-Saleev (Gray code) Sobol generator with
+// Joe-Kuo direction numbers for up to kMaxDims dimensions, optionally
+// randomized by a digital shift or by hash-based Owen (nested uniform)
+// scrambling. HaltonSequence is the radical-inverse sequence in the first
+// prime bases, optionally with random digit permutations.
+//
+// Both can be positioned at any point with seek(n), so each thread can
+// generate its own disjoint block, and both fill blocks dimension-major
+// (fillBlock) so the inner loops run over points and map straight onto SoA
+// columns. A sequence has maxPoints() points (2^32 for Sobol, whose digits
+// are 32 bits); seeking or drawing past them throws, and callers that split
+// a range across threads check it up front with checkSequenceRange().
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vc {
+
+enum class Scrambling { None, DigitalShift, Owen };
+
+namespace detail {
+
+inline std::uint32_t reverseBits(std::uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Owen scrambling of a 32-bit fraction via the Laine-Karras hash (Burley 2020):
+// each output bit depends only on the input bits above it.
+inline std::uint32_t owenScramble(std::uint32_t x, std::uint32_t seed) {
+    x = reverseBits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverseBits(x);
+}
+
+inline std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+}  // namespace detail
+
+class SobolSequence {
+public:
+    static constexpr int kBits = 32;
+    static constexpr int kMaxDims = 37;
+    static constexpr std::uint64_t kMaxPoints = std::uint64_t{1} << kBits;
+
+    explicit SobolSequence(int dims, Scrambling scrambling = Scrambling::None, std::uint64_t seed = 0)
+        : dims_(dims), scrambling_(scrambling), v_(static_cast<std::size_t>(dims) * kBits), x_(dims, 0), seed_(dims, 0) {
+        if (dims < 1 || dims > kMaxDims) {
+            throw std::invalid_argument("SobolSequence supports 1.." + std::to_string(kMaxDims) + " dimensions");
+        }
+        for (int d = 0; d < dims; ++d) {
+            seed_[d] = static_cast<std::uint32_t>(detail::splitMix64(seed * kMaxDims + d) >> 32);
+        }
+        // Dimension 0: van der Corput in base 2
+        for (int k = 0; k < kBits; ++k) {
+            v_[k] = 1u << (kBits - 1 - k);
+        }
+        for (int d = 1; d < dims; ++d) {
+            const Primitive& p = kPrimitives[d - 1];
+            std::uint32_t* v = &v_[static_cast<std::size_t>(d) * kBits];
+            for (int k = 0; k < p.s && k < kBits; ++k) {
+                v[k] = p.m[k] << (kBits - 1 - k);
+            }
+            for (int k = p.s; k < kBits; ++k) {
+                v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+                for (int j = 1; j < p.s; ++j) {
+                    v[k] ^= ((p.a >> (p.s - 1 - j)) & 1u) * v[k - j];
+                }
+            }
+        }
+    }
+
+    int dims() const { return dims_; }
+    std::uint64_t index() const { return n_; }
+    std::uint64_t maxPoints() const { return kMaxPoints; }
+
+    // Positions the sequence so the next point returned is point n.
+    void seek(std::uint64_t n) {
+        if (n >= kMaxPoints) {
+            throw std::out_of_range("SobolSequence::seek: point " + std::to_string(n) + " is past 2^32");
+        }
+        n_ = n;
+        const std::uint64_t gray = n ^ (n >> 1);
+        for (int d = 0; d < dims_; ++d) {
+            std::uint32_t x = 0;
+            for (int k = 0; k < kBits; ++k) {
+                if (gray >> k & 1u) {
+                    x ^= v_[static_cast<std::size_t>(d) * kBits + k];
+                }
+            }
+            x_[d] = x;
+        }
+    }
+
+    // Writes the current point (dims values in [0, 1)) and advances.
+    void next(double* out) {
+        if (n_ >= kMaxPoints) {
+            throw std::out_of_range("SobolSequence::next: past the last point");
+        }
+        for (int d = 0; d < dims_; ++d) {
+            out[d] = toUnit(scramble(x_[d], d));
+        }
+        advance();
+    }
+
+    // Writes the next `count` points dimension-major, out[d * stride + i],
+    // and advances past them.
+    void fillBlock(std::size_t count, double* out, std::size_t stride) {
+        if (count > kMaxPoints - n_) {
+            throw std::out_of_range("SobolSequence::fillBlock: block runs past the last point");
+        }
+        flip_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            flip_[i] = lowestZeroBit(n_ + i);
+        }
+        for (int d = 0; d < dims_; ++d) {
+            const std::uint32_t* v = &v_[static_cast<std::size_t>(d) * kBits];
+            double* col = out + static_cast<std::size_t>(d) * stride;
+            std::uint32_t x = x_[d];
+            const std::uint32_t s = seed_[d];
+            switch (scrambling_) {
+                case Scrambling::None:
+                    for (std::size_t i = 0; i < count; ++i) {
+                        col[i] = toUnit(x);
+                        x ^= v[flip_[i]];
+                    }
+                    break;
+                case Scrambling::DigitalShift:
+                    for (std::size_t i = 0; i < count; ++i) {
+                        col[i] = toUnit(x ^ s);
+                        x ^= v[flip_[i]];
+                    }
+                    break;
+                case Scrambling::Owen:
+                    for (std::size_t i = 0; i < count; ++i) {
+                        col[i] = toUnit(detail::owenScramble(x, s));
+                        x ^= v[flip_[i]];
+                    }
+                    break;
+            }
+            x_[d] = x;
+        }
+        n_ += count;
+    }
+
+    // Unscrambled 32-bit digits of the current point.
+    const std::uint32_t* digits() const { return x_.data(); }
+
+    void advance() {
+        const int c = lowestZeroBit(n_);
+        for (int d = 0; d < dims_; ++d) {
+            x_[d] ^= v_[static_cast<std::size_t>(d) * kBits + c];
+        }
+        ++n_;
+    }
+
+private:
+    // Gray code step n -> n + 1 flips the direction number of the lowest zero
+    // bit of n. The step past the last point (n = 2^32 - 1) would need bit 32;
+    // it flips bit 31 instead, and the state it leaves is never read.
+    static int lowestZeroBit(std::uint64_t n) {
+        int c = 0;
+        while (c < kBits - 1 && ((n >> c) & 1u)) {
+            ++c;
+        }
+        return c;
+    }
+
+    // Maps 32 digits to the cell midpoint in (0, 1), so inverse CDFs stay finite.
+    static double toUnit(std::uint32_t x) { return (x + 0.5) * (1.0 / 4294967296.0); }
+
+    std::uint32_t scramble(std::uint32_t x, int d) const {
+        switch (scrambling_) {
+            case Scrambling::DigitalShift:
+                return x ^ seed_[d];
+            case Scrambling::Owen:
+                return detail::owenScramble(x, seed_[d]);
+            default:
+                return x;
+        }
+    }
+
+    struct Primitive {
+        int s;                 // Degree of the primitive polynomial
+        std::uint32_t a;       // Its interior coefficients
+        std::uint32_t m[8];    // Initial direction integers
+    };
+
+    // Joe & Kuo (2008), new-joe-kuo-6.21201, dimensions 2..37
+    static constexpr Primitive kPrimitives[kMaxDims - 1] = {
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}},
+        {5, 14, {1, 3, 5, 5, 31}},
+        {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}},
+        {6, 16, {1, 3, 1, 13, 27, 49}},
+        {6, 19, {1, 1, 1, 15, 7, 5}},
+        {6, 22, {1, 3, 1, 15, 13, 25}},
+        {6, 25, {1, 1, 5, 5, 19, 61}},
+        {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+        {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+        {7, 7, {1, 1, 3, 13, 7, 35, 63}},
+        {7, 8, {1, 3, 5, 9, 1, 25, 53}},
+        {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+        {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+        {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+        {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+        {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+        {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+        {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+        {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+        {7, 42, {1, 3, 7, 3, 13, 59, 17}},
+        {7, 50, {1, 3, 1, 3, 5, 53, 69}},
+        {7, 55, {1, 1, 5, 5, 23, 33, 13}},
+        {7, 56, {1, 1, 7, 7, 1, 61, 123}},
+        {7, 59, {1, 1, 7, 9, 13, 61, 49}},
+        {7, 62, {1, 3, 3, 5, 3, 55, 33}},
+    };
+
+    int dims_;
+    Scrambling scrambling_;
+    std::vector<std::uint32_t> v_;
+    std::vector<std::uint32_t> x_;
+    std::vector<std::uint32_t> seed_;
+    std::vector<int> flip_;
+    std::uint64_t n_ = 0;
+};
+
+class HaltonSequence {
+public:
+    static constexpr int kMaxDims = 64;
+
+    // With `scrambled`, every digit position of every base gets its own random
+    // permutation of {0, .., b - 1} drawn from `seed`.
+    explicit HaltonSequence(int dims, bool scrambled = false, std::uint64_t seed = 0) : dims_(dims), bases_(dims) {
+        static constexpr int kPrimes[kMaxDims] = {
+            2,   3,   5,   7,   11,  13,  17,  19,  23,  29,  31,  37,  41,  43,  47,  53,
+            59,  61,  67,  71,  73,  79,  83,  89,  97,  101, 103, 107, 109, 113, 127, 131,
+            137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+            227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311};
+        if (dims < 1 || dims > kMaxDims) {
+            throw std::invalid_argument("HaltonSequence supports 1.." + std::to_string(kMaxDims) + " dimensions");
+        }
+        for (int d = 0; d < dims; ++d) {
+            Base& B = bases_[d];
+            B.b = kPrimes[d];
+            // As many digits as keep b^digits <= 2^53, so the integer value converts exactly
+            std::uint64_t bk = 1;
+            while (bk <= (std::uint64_t{1} << 53) / B.b) {
+                bk *= B.b;
+                ++B.digits;
+            }
+            B.scale = 1.0 / static_cast<double>(bk);
+            max_points_ = std::min(max_points_, bk);
+            B.weight.assign(B.digits, 1);
+            for (int k = B.digits - 2; k >= 0; --k) {
+                B.weight[k] = B.weight[k + 1] * B.b;
+            }
+            B.perm.resize(static_cast<std::size_t>(B.digits) * B.b);
+            std::mt19937_64 g(detail::splitMix64(seed * kMaxDims + d));
+            for (int k = 0; k < B.digits; ++k) {
+                std::uint32_t* p = &B.perm[static_cast<std::size_t>(k) * B.b];
+                for (int j = 0; j < B.b; ++j) {
+                    p[j] = j;
+                }
+                if (scrambled) {
+                    for (int j = B.b - 1; j > 0; --j) {
+                        std::swap(p[j], p[std::uniform_int_distribution<int>(0, j)(g)]);
+                    }
+                }
+            }
+            B.digit.assign(B.digits, 0);
+        }
+        seek(0);
+    }
+
+    int dims() const { return dims_; }
+    std::uint64_t index() const { return n_; }
+    std::uint64_t maxPoints() const { return max_points_; }
+
+    void seek(std::uint64_t n) {
+        if (n >= max_points_) {
+            throw std::out_of_range("HaltonSequence::seek: point " + std::to_string(n) + " is past the period");
+        }
+        n_ = n;
+        for (Base& B : bases_) {
+            B.value = 0;
+            std::uint64_t m = n;
+            for (int k = 0; k < B.digits; ++k) {
+                B.digit[k] = static_cast<std::uint32_t>(m % B.b);
+                m /= B.b;
+                B.value += B.perm[static_cast<std::size_t>(k) * B.b + B.digit[k]] * B.weight[k];
+            }
+        }
+    }
+
+    void next(double* out) {
+        if (n_ >= max_points_) {
+            throw std::out_of_range("HaltonSequence::next: past the period");
+        }
+        for (int d = 0; d < dims_; ++d) {
+            out[d] = bases_[d].unit();
+            bases_[d].increment();
+        }
+        ++n_;
+    }
+
+    // Same layout as SobolSequence::fillBlock.
+    void fillBlock(std::size_t count, double* out, std::size_t stride) {
+        if (count > max_points_ - n_) {
+            throw std::out_of_range("HaltonSequence::fillBlock: block runs past the period");
+        }
+        for (int d = 0; d < dims_; ++d) {
+            Base& B = bases_[d];
+            double* col = out + static_cast<std::size_t>(d) * stride;
+            for (std::size_t i = 0; i < count; ++i) {
+                col[i] = B.unit();
+                B.increment();
+            }
+        }
+        n_ += count;
+    }
+
+private:
+    // Radical inverse kept as an exact integer over b^digits and updated
+    // digit by digit, so stepping is O(1) amortized and never drifts.
+    struct Base {
+        int b = 2;
+        int digits = 0;
+        double scale = 1;
+        std::vector<std::uint64_t> weight;   // b^(digits - 1 - k)
+        std::vector<std::uint32_t> perm;     // digits x b
+        std::vector<std::uint32_t> digit;
+        std::uint64_t value = 0;
+
+        double unit() const { return (value + 0.5) * scale; }
+
+        void increment() {
+            for (int k = 0; k < digits; ++k) {
+                const std::uint32_t* p = &perm[static_cast<std::size_t>(k) * b];
+                const std::uint32_t old = digit[k];
+                const std::uint32_t nxt = old + 1 == static_cast<std::uint32_t>(b) ? 0 : old + 1;
+                value += (static_cast<std::uint64_t>(p[nxt]) - p[old]) * weight[k];
+                digit[k] = nxt;
+                if (nxt != 0) {
+                    return;
+                }
+            }
+        }
+    };
+
+    int dims_;
+    std::vector<Base> bases_;
+    std::uint64_t max_points_ = ~std::uint64_t{0};   // Shortest digit period over the bases
+    std::uint64_t n_ = 0;
+};
+
+// Throws unless points first .. first + count - 1 all exist in `seq`.
+template <class Sequence>
+void checkSequenceRange(const Sequence& seq, std::uint64_t first, std::uint64_t count, const char* caller) {
+    if (first > seq.maxPoints() || count > seq.maxPoints() - first) {
+        throw std::out_of_range(std::string(caller) + ": points " + std::to_string(first) + " + " +
+                                std::to_string(count) + " run past the end of the sequence");
+    }
+}
+
+}  // namespace vc
@@ -0,0 +1,278 @@
+#pragma once
+// Conjunctive filter queries over sweep files (vc_sweep_file.hpp).
+//
+// A query is a list of predicates `column op value`, all of which must hold,
+// e.g. parseQuery("Q_max > 150 && R_total_corrected < 0.05 &&
+// mesh_number_evap_wpi == 200"). Chunks are scanned in parallel. For each
+// chunk the zone maps decide every predicate first:
+//
+//   none   no row can match (e.g. max <= 150 for Q_max > 150): skip the chunk
+//   all    every row matches and none is NaN: drop the predicate here
+//   some   evaluate it
+//
+// The remaining predicates are evaluated column by column into a byte mask
+// with comparison-only loops the compiler vectorizes, reading nothing but the
+// tested columns of the mapped file. Matching rows are then compacted
+// branch-free, as in vc_validity.hpp. NaN never matches.
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_parallel.hpp"
+#include "vc_sweep_file.hpp"
+
+namespace vc {
+
+enum class CompareOp : std::uint8_t { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+struct Predicate {
+    std::string column;
+    CompareOp op;
+    double value;
+};
+
+struct QueryStats {
+    std::uint64_t chunks = 0;           // Chunks in the file
+    std::uint64_t chunks_skipped = 0;   // Ruled out by the zone maps
+    std::uint64_t chunks_scanned = 0;   // With at least one predicate evaluated
+    std::uint64_t rows_matched = 0;
+};
+
+struct QueryResult {
+    std::vector<std::uint64_t> rows;    // Ascending file rows; empty for countQuery
+    QueryStats stats;
+};
+
+namespace detail {
+
+enum class ZoneVerdict { None, Some, All };
+
+inline ZoneVerdict zoneVerdict(const SweepZone& z, CompareOp op, double v, std::size_t rows) {
+    if (z.nan_rows == rows) {
+        return ZoneVerdict::None;
+    }
+    bool none = false;
+    bool all = false;
+    switch (op) {
+        case CompareOp::Less:         none = z.min >= v; all = z.max < v; break;
+        case CompareOp::LessEqual:    none = z.min > v;  all = z.max <= v; break;
+        case CompareOp::Greater:      none = z.max <= v; all = z.min > v; break;
+        case CompareOp::GreaterEqual: none = z.max < v;  all = z.min >= v; break;
+        case CompareOp::Equal:        none = v < z.min || v > z.max; all = z.min == v && z.max == v; break;
+        case CompareOp::NotEqual:     none = z.min == v && z.max == v; all = v < z.min || v > z.max; break;
+    }
+    if (none) {
+        return ZoneVerdict::None;
+    }
+    return all && z.nan_rows == 0 ? ZoneVerdict::All : ZoneVerdict::Some;
+}
+
+// mask[i] (&)= col[i] op v over n rows; one tight loop per operator.
+template <class Cmp>
+void applyCompare(const double* col, std::size_t n, double v, std::uint8_t* mask, bool first, Cmp cmp) {
+    if (first) {
+        for (std::size_t i = 0; i < n; ++i) {
+            mask[i] = cmp(col[i], v);
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            mask[i] &= cmp(col[i], v);
+        }
+    }
+}
+
+inline void applyPredicate(const double* col, std::size_t n, CompareOp op, double v, std::uint8_t* mask, bool first) {
+    switch (op) {
+        case CompareOp::Less:
+            applyCompare(col, n, v, mask, first, [](double x, double y) { return static_cast<std::uint8_t>(x < y); });
+            break;
+        case CompareOp::LessEqual:
+            applyCompare(col, n, v, mask, first, [](double x, double y) { return static_cast<std::uint8_t>(x <= y); });
+            break;
+        case CompareOp::Greater:
+            applyCompare(col, n, v, mask, first, [](double x, double y) { return static_cast<std::uint8_t>(x > y); });
+            break;
+        case CompareOp::GreaterEqual:
+            applyCompare(col, n, v, mask, first, [](double x, double y) { return static_cast<std::uint8_t>(x >= y); });
+            break;
+        case CompareOp::Equal:
+            applyCompare(col, n, v, mask, first, [](double x, double y) { return static_cast<std::uint8_t>(x == y); });
+            break;
+        case CompareOp::NotEqual:
+            // x == x excludes NaN, which != would accept
+            applyCompare(col, n, v, mask, first,
+                         [](double x, double y) { return static_cast<std::uint8_t>((x != y) & (x == x)); });
+            break;
+    }
+}
+
+struct QueryPartial {
+    std::vector<std::uint64_t> rows;
+    QueryStats stats;
+};
+
+inline QueryResult scanSweepFile(const SweepFile& file, const std::vector<Predicate>& predicates, bool keep_rows) {
+    std::vector<std::size_t> columns;
+    for (const Predicate& p : predicates) {
+        columns.push_back(file.columnIndex(p.column));
+    }
+    std::vector<QueryPartial> partials(workerCount());
+    parallelFor(file.chunkCount(), [&](std::size_t begin, std::size_t end, unsigned worker) {
+        QueryPartial& part = partials[worker];
+        std::vector<std::uint8_t> mask(file.chunkRows());
+        std::vector<std::size_t> active;
+        for (std::size_t c = begin; c < end; ++c) {
+            const std::size_t n = file.rowsInChunk(c);
+            active.clear();
+            bool skip = false;
+            for (std::size_t p = 0; p < predicates.size() && !skip; ++p) {
+                const ZoneVerdict v = zoneVerdict(file.zone(c, columns[p]), predicates[p].op, predicates[p].value, n);
+                skip = v == ZoneVerdict::None;
+                if (v == ZoneVerdict::Some) {
+                    active.push_back(p);
+                }
+            }
+            if (skip) {
+                ++part.stats.chunks_skipped;
+                continue;
+            }
+            const std::uint64_t row0 = static_cast<std::uint64_t>(c) * file.chunkRows();
+            if (active.empty()) {
+                part.stats.rows_matched += n;
+                for (std::size_t i = 0; keep_rows && i < n; ++i) {
+                    part.rows.push_back(row0 + i);
+                }
+                continue;
+            }
+            ++part.stats.chunks_scanned;
+            for (std::size_t a = 0; a < active.size(); ++a) {
+                const Predicate& p = predicates[active[a]];
+                applyPredicate(file.column(c, columns[active[a]]), n, p.op, p.value, mask.data(), a == 0);
+            }
+            std::size_t matched = 0;
+            if (keep_rows) {
+                const std::size_t base = part.rows.size();
+                part.rows.resize(base + n);
+                std::uint64_t* out = part.rows.data() + base;
+                for (std::size_t i = 0; i < n; ++i) {
+                    out[matched] = row0 + i;
+                    matched += mask[i];
+                }
+                part.rows.resize(base + matched);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) {
+                    matched += mask[i];
+                }
+            }
+            part.stats.rows_matched += matched;
+        }
+    }, 1);
+
+    // Worker chunk ranges ascend with the worker number
+    QueryResult result;
+    result.stats.chunks = file.chunkCount();
+    for (QueryPartial& part : partials) {
+        result.rows.insert(result.rows.end(), part.rows.begin(), part.rows.end());
+        result.stats.chunks_skipped += part.stats.chunks_skipped;
+        result.stats.chunks_scanned += part.stats.chunks_scanned;
+        result.stats.rows_matched += part.stats.rows_matched;
+    }
+    return result;
+}
+
+}  // namespace detail
+
+inline QueryResult runQuery(const SweepFile& file, const std::vector<Predicate>& predicates) {
+    return detail::scanSweepFile(file, predicates, true);
+}
+
+inline QueryStats countQuery(const SweepFile& file, const std::vector<Predicate>& predicates) {
+    return detail::scanSweepFile(file, predicates, false).stats;
+}
+
+// Parses "name op number" clauses joined by "&&", "and" or ",". Operators:
+// < <= > >= == = !=.
+inline std::vector<Predicate> parseQuery(const std::string& text) {
+    std::vector<Predicate> predicates;
+    std::size_t i = 0;
+    const auto skip_space = [&] {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+    };
+    const auto fail = [&](const std::string& what) {
+        throw std::invalid_argument("parseQuery: " + what + " at position " + std::to_string(i) + " in \"" + text + "\"");
+    };
+    while (true) {
+        skip_space();
+        const std::size_t name_begin = i;
+        while (i < text.size() && (std::isalnum(static_cast<unsigned char>(text[i])) || text[i] == '_')) {
+            ++i;
+        }
+        if (i == name_begin) {
+            fail("expected a column name");
+        }
+        Predicate p{text.substr(name_begin, i - name_begin), CompareOp::Equal, 0};
+        skip_space();
+        const std::string two = text.substr(i, 2);
+        if (two == "<=") {
+            p.op = CompareOp::LessEqual;
+            i += 2;
+        } else if (two == ">=") {
+            p.op = CompareOp::GreaterEqual;
+            i += 2;
+        } else if (two == "==") {
+            p.op = CompareOp::Equal;
+            i += 2;
+        } else if (two == "!=") {
+            p.op = CompareOp::NotEqual;
+            i += 2;
+        } else if (i < text.size() && text[i] == '<') {
+            p.op = CompareOp::Less;
+            ++i;
+        } else if (i < text.size() && text[i] == '>') {
+            p.op = CompareOp::Greater;
+            ++i;
+        } else if (i < text.size() && text[i] == '=') {
+            p.op = CompareOp::Equal;
+            ++i;
+        } else {
+            fail("expected a comparison operator");
+        }
+        skip_space();
+        const char* start = text.c_str() + i;
+        char* stop = nullptr;
+        p.value = std::strtod(start, &stop);
+        if (stop == start) {
+            fail("expected a number");
+        }
+        i += static_cast<std::size_t>(stop - start);
+        predicates.push_back(p);
+        skip_space();
+        if (i == text.size()) {
+            return predicates;
+        }
+        if (text.compare(i, 2, "&&") == 0) {
+            i += 2;
+        } else if (text[i] == ',') {
+            ++i;
+        } else if (text.compare(i, 3, "and") == 0 && i + 3 < text.size() &&
+                   std::isspace(static_cast<unsigned char>(text[i + 3]))) {
+            i += 3;
+        } else {
+            fail("expected &&, \"and\" or \",\"");
+        }
+    }
+}
+
+inline QueryResult runQuery(const SweepFile& file, const std::string& query) {
+    return runQuery(file, parseQuery(query));
+}
+
+}  // namespace vc
@@ -0,0 +1,208 @@
+#pragma once
+// Axisymmetric form of the capillary and resistance analysis for a centered
+// heat source.
+//
+// A square plate and die are mapped to a disk and a concentric source of the
+// same areas:
+//
+//     R   = sqrt(vc_length vc_width / pi),   r_s = sqrt(evap_length evap_width / pi)
+//
+// Evaporation is uniform over r < r_s and condensation uniform over the disk,
+// as in vc_spreading.hpp. The net mass flow crossing radius r inward is then
+//
+//     F(r) = m (r^2 / r_s^2 - r^2 / R^2)   for r < r_s,     m (1 - r^2 / R^2)   beyond,
+//
+// with m = Q_in / h_fg. It returns through a cylinder of height t and
+// circumference 2 pi r instead of the rectangle t * vc_width. Under the source
+// the liquid runs in the evaporator wick alone; beyond it the two wicks are in
+// parallel (as in vc_axial.hpp). Integrating Darcy and parallel-plate vapor
+// flow (d_h = 2 t_vapor) from the center to the rim gives
+//
+//     dP_l = mu_l m / (2 pi rho_l) [G_in / (K_evap t_evap_wick) + G_out / (K_evap t_evap_wick + K_cond t_cond_wick)]
+//     dP_v = 12 mu_v m / (2 pi rho_v t_vapor^3) (G_in + G_out)
+//     G_in = (1 - r_s^2 / R^2) / 2,   G_out = ln(R / r_s) - (1 - r_s^2 / R^2) / 2
+//
+// and dP_g = rho_l g R sin(phi) over the center-to-rim path.
+//
+// The evaporator wall is a radial fin (in-plane k_shell t_evap_wall, sink h =
+// half wall plus evaporator wick) with a uniform disk source and an adiabatic
+// rim. The source-averaged rise has a Bessel-function closed form. Its excess
+// over 1 / (h pi r_s^2) = 1 / (h A_evap), the part the network already counts
+// as R_evap_wall / 2 + R_evap_wick, is the axisymmetric R_evap_spreading, so
+// it is negative whenever the wall spreads heat beyond the source. The
+// remaining resistances are through the thickness and do not depend on the
+// geometry.
+//
+// The closed form evaporates everything under the source, as the lumped model
+// does. The conducting wall actually spreads evaporation over a fin length
+// sqrt(k_shell t_evap_wall / h) (about 18 mm at the default design) beyond the
+// source, which shortens the liquid path: solveAxialBatch() with
+// AxialEvaporation::WallFin gives about 6x this Q_max at the default design,
+// and AxialEvaporation::UnderSource reproduces it.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+enum class FlowGeometry : std::uint8_t {
+    Planar,   // Lumped model: flow through t * vc_width over L_eff
+    Radial,   // Equivalent-radius disk with a concentric source
+};
+
+// Disk radius with the same area as a rectangle.
+template <class T>
+T equivalentRadius(const T& length, const T& width) {
+    using std::sqrt;
+    return sqrt(length * width / M_PI);
+}
+
+namespace detail {
+
+// e^-x I1(x) and e^x K1(x) for x > 0 (Abramowitz & Stegun 9.8.3-9.8.4 and
+// 9.8.7-9.8.8, |relative error| < 1e-7). Scaled so spreading products of
+// large arguments do not overflow.
+inline double besselI1Scaled(double x) {
+    if (x < 3.75) {
+        const double t = (x / 3.75) * (x / 3.75);
+        return std::exp(-x) * x *
+               (0.5 + t * (0.87890594 + t * (0.51498869 + t * (0.15084934 + t * (0.02658733 + t * (0.00301532 + t * 0.00032411))))));
+    }
+    const double t = 3.75 / x;
+    return (0.39894228 + t * (-0.03988024 + t * (-0.00362018 + t * (0.00163801 + t * (-0.01031555 + t * (0.02282967 +
+            t * (-0.02895312 + t * (0.01787654 - t * 0.00420059)))))))) / std::sqrt(x);
+}
+
+inline double besselK1Scaled(double x) {
+    if (x <= 2) {
+        const double t = (x / 2) * (x / 2);
+        const double I1 = besselI1Scaled(x) * std::exp(x);
+        return std::exp(x) * (x * std::log(x / 2) * I1 +
+                              (1 + t * (0.15443144 + t * (-0.67278579 + t * (-0.18156897 + t * (-0.01919402 +
+                               t * (-0.00110404 - t * 0.00004686))))))) / x;
+    }
+    const double t = 2 / x;
+    return (1.25331414 + t * (0.23498619 + t * (-0.03655620 + t * (0.01504268 + t * (-0.00780353 +
+            t * (0.00325614 - t * 0.00068245)))))) / std::sqrt(x);
+}
+
+}  // namespace detail
+
+// Source-averaged rise [K/W] of a disk of radius R (in-plane conductance kt,
+// sink h) under a uniform source of radius r_s, minus the rise 1 / (h pi r_s^2)
+// the source would have without spreading.
+inline double radialSpreadingResistance(double kt, double h, double r_s, double R) {
+    const double m = std::sqrt(h / kt);
+    const double a = m * r_s;
+    const double b = m * R;
+    const double I1a = detail::besselI1Scaled(a);
+    // 1 + 2 I1(a) [K1(b) / I1(b) I1(a) - K1(a)], scaled by e^(+-x)
+    const double shape = 1 + 2 * (detail::besselK1Scaled(b) / detail::besselI1Scaled(b) * I1a * I1a * std::exp(2 * (a - b)) -
+                                  I1a * detail::besselK1Scaled(a));
+    return (shape - 1) / (h * M_PI * r_s * r_s);
+}
+
+// Per lane: the Bessel forms branch on their argument.
+template <std::size_t W>
+Lanes<W> radialSpreadingResistance(const Lanes<W>& kt, const Lanes<W>& h, const Lanes<W>& r_s, const Lanes<W>& R) {
+    Lanes<W> r;
+    for (std::size_t k = 0; k < W; ++k) {
+        r.v[k] = radialSpreadingResistance(kt.v[k], h.v[k], r_s.v[k], R.v[k]);
+    }
+    return r;
+}
+
+// Replaces the capillary terms and evaporator spreading in the planar outputs
+// `out` (from evaluateModel) with those of the equivalent disk.
+template <class T>
+void applyRadialGeometry(const DesignInputs<T>& in, ModelOutputs<T>& out,
+                         const FluidProperties& fluid = FluidProperties{}) {
+    using std::log;
+    using std::min;
+    using std::sin;
+
+    const T R = equivalentRadius(in.vc_length, in.vc_width);
+    const T r_s = min(equivalentRadius(in.evap_length, in.evap_width), R);
+    const T area_ratio = (r_s * r_s) / (R * R);
+    const T G_in = (1 - area_ratio) / 2;
+    const T G_out = log(R / r_s) - (1 - area_ratio) / 2;
+    const double per_watt = 1 / (2 * M_PI * fluid.h_fg);   // m / (2 pi) for 1 W
+
+    const T liquid_pressure_term =
+        fluid.mu_l / fluid.rho_l * per_watt *
+        (G_in / (out.K_evap * out.t_evap_wick) + G_out / (out.K_evap * out.t_evap_wick + out.K_cond * out.t_cond_wick));
+    const T vapor_pressure_term = 12 * fluid.mu_v / (fluid.rho_v * cube(in.t_vapor)) * per_watt * (G_in + G_out);
+    out.dP_l = in.Q_in * liquid_pressure_term;
+    out.dP_v = in.Q_in * vapor_pressure_term;
+    out.dP_g = fluid.rho_l * 9.81 * R * sin(toRadians(in.phi_deg));
+    out.dP_total = out.dP_l + out.dP_v + out.dP_g;
+    out.Q_max = (out.dP_cap - out.dP_g) / (liquid_pressure_term + vapor_pressure_term);
+
+    const T h = 1 / (in.t_evap_wall / (2 * in.k_shell) + out.t_evap_wick / out.k_wick_evap);
+    out.R_evap_spreading = radialSpreadingResistance(in.k_shell * in.t_evap_wall, h, r_s, R);
+    sumResistanceNetwork(in, out);
+}
+
+// Lumped model with the capillary terms and evaporator spreading of the
+// equivalent disk; every other output is as evaluateModel().
+template <class T>
+ModelOutputs<T> evaluateRadialModel(const DesignInputs<T>& in, const FluidProperties& fluid = FluidProperties{}) {
+    ModelOutputs<T> out = evaluateModel(in, fluid);
+    applyRadialGeometry(in, out, fluid);
+    return out;
+}
+
+// evaluateBatch with the geometry chosen per lane. Runs of all-planar packs go
+// through evaluateBatchRange. A pack with radial lanes gets one planar pass,
+// then the disk terms on a copy, and each lane stores the one its geometry
+// selects.
+inline void evaluateBatch(const DesignBatch<double>& in, const std::vector<FlowGeometry>& geometry,
+                          OutputBatch<double>& out, const FluidProperties& fluid = FluidProperties{}) {
+    using Pack = Lanes<kBatchLanes>;
+    if (geometry.size() != in.size()) {
+        throw std::invalid_argument("evaluateBatch: one geometry per lane required");
+    }
+    out.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        std::size_t i = begin;
+        std::size_t planar_run = begin;   // First lane of the pending run of planar packs
+        for (; i + kBatchLanes <= end; i += kBatchLanes) {
+            bool radial[kBatchLanes];
+            bool any_radial = false;
+            for (std::size_t k = 0; k < kBatchLanes; ++k) {
+                radial[k] = geometry[i + k] == FlowGeometry::Radial;
+                any_radial |= radial[k];
+            }
+            if (!any_radial) {
+                continue;
+            }
+            evaluateBatchRange(in, out, planar_run, i, fluid);
+            planar_run = i + kBatchLanes;
+
+            const DesignInputs<Pack> d = detail::loadDesignLanes<kBatchLanes>(in, i);
+            const ModelOutputs<Pack> planar = evaluateModel(d, fluid);
+            ModelOutputs<Pack> disk = planar;
+            applyRadialGeometry(d, disk, fluid);
+#define VC_STORE_SELECTED_LANES(name)                                            \
+            for (std::size_t k = 0; k < kBatchLanes; ++k) {                      \
+                out.name[i + k] = radial[k] ? disk.name.v[k] : planar.name.v[k]; \
+            }
+            VC_OUTPUT_FIELDS(VC_STORE_SELECTED_LANES)
+#undef VC_STORE_SELECTED_LANES
+        }
+        evaluateBatchRange(in, out, planar_run, i, fluid);
+        for (; i < end; ++i) {
+            const DesignInputs<double> d = in.get(i);
+            out.set(i, geometry[i] == FlowGeometry::Radial ? evaluateRadialModel(d, fluid) : evaluateModel(d, fluid));
+        }
+    });
+}
+
+}  // namespace vc
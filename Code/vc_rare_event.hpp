@@ -0,0 +1,269 @@
+#pragma once
+// Rare-event failure probability by subset simulation (Au & Beck 2001).
+//
+// The uncertain inputs are driven from independent standard normals z, mapped
+// through Phi and the input inverse CDFs (vc_distributions.hpp). Failure is
+// g = Q_max - Q_in <= 0; a design the model cannot evaluate (non-finite
+// Q_max) counts as failed. P(F) is written as a product of conditional
+// probabilities p0 of nested events g <= b_1 > b_2 > ... > 0, each level
+// populated by Markov chains seeded at the previous level's best samples.
+//
+// Chains use the preconditioned Crank-Nicolson move z' = rho z + sqrt(1 - rho^2) xi,
+// which leaves N(0, I) invariant, so a proposal is accepted exactly when it
+// stays in the current intermediate domain. The n_seeds = N p0 chains of a
+// level (200 at the defaults) are split into contiguous groups of at least
+// kChainsPerTask, one group per worker thread. Each group draws its own
+// proposals and advances in lockstep, one DesignBatch per chain step
+// evaluated on its thread. Each chain owns its RNG stream, so results do not
+// depend on the thread count.
+//
+// The coefficient of variation follows Au & Beck: per level
+// (1 - p_j) / (N p_j) * (1 + gamma_j), with gamma_j from the chain
+// autocorrelation of the level indicator.
+//
+// If max_levels runs out before a threshold reaches 0, the result is flagged
+// !converged. The last level's failure fraction is then usually 0, and
+// `probability_bound` (the product down to the last threshold reached, whose
+// domain contains the failure domain) is the useful number: an upper bound.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_distributions.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_qmc.hpp"
+
+namespace vc {
+
+struct SubsetSimulationOptions {
+    std::size_t samples_per_level = 2000;   // N
+    double p0 = 0.1;                        // Conditional probability per level
+    int max_levels = 20;
+    double rho = 0.8;                       // Initial pCN correlation
+    double target_acceptance = 0.44;        // rho is adapted between levels towards this
+    unsigned long long seed = 1;
+};
+
+struct SubsetLevel {
+    double threshold = 0;          // b_j
+    double probability = 0;        // Conditional probability of this level
+    double acceptance = 0;         // Chain acceptance rate that produced it (0 for level 0)
+    double gamma = 0;              // Chain correlation factor
+};
+
+struct SubsetSimulationResult {
+    double probability = 0;
+    double cov = 0;                // Coefficient of variation of `probability` (inf when it is 0)
+    bool converged = false;        // A threshold reached g = 0 within max_levels
+    double probability_bound = 1;  // Estimate of P(g <= b) at the last threshold b > 0; >= P(F)
+    std::vector<SubsetLevel> levels;
+    std::size_t model_calls = 0;
+    std::vector<DesignInputs<double>> failure_samples;   // Final-level samples with g <= 0
+};
+
+namespace detail {
+
+constexpr std::size_t kChainsPerTask = 8;
+
+// Writes the designs for the standard-normal rows z (count x d) into lanes.
+inline void standardNormalToBatch(const std::vector<double>& z, std::size_t count,
+                                  const DesignInputs<double>& nominal, const std::vector<UncertainInput>& inputs,
+                                  DesignBatch<double>& lanes) {
+    const std::size_t d = inputs.size();
+    lanes.resize(0);
+    lanes.resize(count, nominal);
+    for (std::size_t i = 0; i < d; ++i) {
+        std::vector<double>& col = lanes.*(inputs[i].column);
+        for (std::size_t n = 0; n < count; ++n) {
+            col[n] = inputs[i].dist.quantile(normalCdf(z[n * d + i]));
+        }
+    }
+}
+
+inline void failureMargin(const DesignBatch<double>& lanes, const OutputBatch<double>& out, std::vector<double>& g) {
+    g.resize(lanes.size());
+    for (std::size_t n = 0; n < g.size(); ++n) {
+        const double m = out.Q_max[n] - lanes.Q_in[n];
+        g[n] = std::isfinite(m) ? m : -std::numeric_limits<double>::infinity();
+    }
+}
+
+// Au & Beck gamma for chains laid out chain-major (n_chains x length).
+inline double chainCorrelationFactor(const std::vector<double>& g, double b, std::size_t n_chains, std::size_t length) {
+    const std::size_t N = n_chains * length;
+    if (length < 2 || N == 0) {
+        return 0;
+    }
+    double p = 0;
+    for (double v : g) {
+        p += v <= b;
+    }
+    p /= N;
+    const double r0 = p * (1 - p);
+    if (!(r0 > 0)) {
+        return 0;
+    }
+    double gamma = 0;
+    for (std::size_t k = 1; k < length; ++k) {
+        double s = 0;
+        for (std::size_t c = 0; c < n_chains; ++c) {
+            const double* gc = &g[c * length];
+            for (std::size_t l = 0; l + k < length; ++l) {
+                s += (gc[l] <= b) * (gc[l + k] <= b);
+            }
+        }
+        const double rk = s / (N - k * n_chains) - p * p;
+        gamma += 2 * (1 - static_cast<double>(k) / length) * rk / r0;
+    }
+    return std::max(gamma, 0.0);
+}
+
+}  // namespace detail
+
+// Estimates P(Q_max < Q_in) when the listed inputs vary around `nominal`.
+inline SubsetSimulationResult subsetSimulation(const DesignInputs<double>& nominal,
+                                               const std::vector<UncertainInput>& inputs,
+                                               const SubsetSimulationOptions& opt = SubsetSimulationOptions{},
+                                               const FluidProperties& fluid = FluidProperties{}) {
+    const std::size_t d = inputs.size();
+    const std::size_t N = opt.samples_per_level;
+    const std::size_t n_seeds = static_cast<std::size_t>(std::lround(N * opt.p0));
+    if (d == 0 || n_seeds < 1 || n_seeds >= N || N % n_seeds != 0) {
+        throw std::invalid_argument("subsetSimulation needs inputs and samples_per_level * p0 dividing samples_per_level");
+    }
+    const std::size_t chain_length = N / n_seeds;
+    SubsetSimulationResult res;
+
+    // --- Level 0: crude Monte Carlo ---
+    std::vector<double> z(N * d);
+    {
+        std::mt19937_64 g(detail::splitMix64(opt.seed));
+        std::normal_distribution<double> normal;
+        for (double& v : z) {
+            v = normal(g);
+        }
+    }
+    DesignBatch<double> lanes;
+    OutputBatch<double> out;
+    std::vector<double> g;
+    detail::standardNormalToBatch(z, N, nominal, inputs, lanes);
+    evaluateBatch(lanes, out, fluid);
+    detail::failureMargin(lanes, out, g);
+    res.model_calls += N;
+
+    double probability = 1;
+    double cov_sq = 0;
+    double rho = opt.rho;
+    double acceptance = 0;
+    bool chained = false;   // Samples are chains (from level 1 on) rather than i.i.d.
+    std::vector<std::size_t> order(N);
+    std::vector<double> z_next(N * d);
+    std::vector<double> g_next(N);
+    std::vector<std::size_t> chain_accepted(n_seeds);
+
+    for (int level = 0;; ++level) {
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return g[a] < g[b]; });
+        double b = 0.5 * (g[order[n_seeds - 1]] + g[order[n_seeds]]);
+        res.converged = !(b > 0);
+        const bool last = res.converged || level == opt.max_levels;
+        if (last) {
+            // Out of levels: P(g <= b) still bounds P(F) from above
+            res.probability_bound = probability * (res.converged ? 1 : opt.p0);
+            b = 0;
+        }
+        SubsetLevel lv;
+        lv.threshold = b;
+        lv.acceptance = acceptance;
+        lv.gamma = chained ? detail::chainCorrelationFactor(g, b, n_seeds, chain_length) : 0;
+        double hits = 0;
+        for (double v : g) {
+            hits += v <= b;
+        }
+        lv.probability = last ? hits / N : opt.p0;
+        probability *= lv.probability;
+        if (lv.probability > 0) {
+            cov_sq += (1 - lv.probability) / (N * lv.probability) * (1 + lv.gamma);
+        }
+        res.levels.push_back(lv);
+        if (last) {
+            std::vector<double> zf;
+            for (std::size_t n = 0; n < N; ++n) {
+                if (g[n] <= 0) {
+                    zf.insert(zf.end(), &z[n * d], &z[n * d] + d);
+                }
+            }
+            detail::standardNormalToBatch(zf, zf.size() / d, nominal, inputs, lanes);
+            for (std::size_t n = 0; n < lanes.size(); ++n) {
+                res.failure_samples.push_back(lanes.get(n));
+            }
+            break;
+        }
+
+        // --- Grow one chain from each of the n_seeds best samples, in groups across threads ---
+        const double sigma = std::sqrt(1 - rho * rho);
+        parallelFor(n_seeds, [&](std::size_t begin, std::size_t end, unsigned) {
+            const std::size_t count = end - begin;
+            std::vector<double> current(count * d);
+            std::vector<double> g_current(count);
+            std::vector<double> proposal(count * d);
+            std::vector<double> g_proposal;
+            DesignBatch<double> group;
+            OutputBatch<double> group_out;
+            for (std::size_t c = begin; c < end; ++c) {
+                const std::size_t s = order[c];
+                std::copy(&z[s * d], &z[s * d] + d, &current[(c - begin) * d]);
+                g_current[c - begin] = g[s];
+                std::copy(&z[s * d], &z[s * d] + d, &z_next[(c * chain_length) * d]);
+                g_next[c * chain_length] = g[s];
+                chain_accepted[c] = 0;
+            }
+            for (std::size_t l = 1; l < chain_length; ++l) {
+                for (std::size_t c = begin; c < end; ++c) {
+                    std::mt19937_64 rng(detail::splitMix64(opt.seed ^ detail::splitMix64((level * N + c) * chain_length + l)));
+                    std::normal_distribution<double> normal;
+                    for (std::size_t i = 0; i < d; ++i) {
+                        proposal[(c - begin) * d + i] = rho * current[(c - begin) * d + i] + sigma * normal(rng);
+                    }
+                }
+                detail::standardNormalToBatch(proposal, count, nominal, inputs, group);
+                group_out.resize(count);
+                evaluateBatchRange(group, group_out, 0, count, fluid);
+                detail::failureMargin(group, group_out, g_proposal);
+                for (std::size_t c = begin; c < end; ++c) {
+                    const std::size_t k = c - begin;
+                    if (g_proposal[k] <= b) {
+                        std::copy(&proposal[k * d], &proposal[k * d] + d, &current[k * d]);
+                        g_current[k] = g_proposal[k];
+                        ++chain_accepted[c];
+                    }
+                    std::copy(&current[k * d], &current[k * d] + d, &z_next[(c * chain_length + l) * d]);
+                    g_next[c * chain_length + l] = g_current[k];
+                }
+            }
+        }, detail::kChainsPerTask);
+        res.model_calls += n_seeds * (chain_length - 1);
+        const std::size_t accepted = std::accumulate(chain_accepted.begin(), chain_accepted.end(), std::size_t{0});
+        acceptance = static_cast<double>(accepted) / (n_seeds * (chain_length - 1));
+        // Smaller steps when chains stall, larger when they accept too easily
+        const double new_sigma = std::min(1.0, std::max(0.05, sigma * std::exp(acceptance - opt.target_acceptance)));
+        rho = std::sqrt(1 - new_sigma * new_sigma);
+        z.swap(z_next);
+        g.swap(g_next);
+        chained = true;
+    }
+    res.probability = probability;
+    res.cov = probability > 0 ? std::sqrt(cov_sq) : std::numeric_limits<double>::infinity();
+    return res;
+}
+
+}  // namespace vc
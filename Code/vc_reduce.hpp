@@ -0,0 +1,317 @@
+#pragma once
+// Streaming reductions over sweep blocks: top-K and Pareto skyline.
+//
+// A reducer takes the SoA blocks a sweep kernel hands its visitor
+// (evaluatePacked / enumerateCatalog in vc_packed.hpp), reads only the
+// objective columns, and copies a design out of the block only when it
+// enters the kept set. Memory is bounded by K, or by the size of the Pareto
+// front, however many designs stream through.
+//
+// Each worker owns a reducer (the visitor indexes them by its worker number),
+// so adding never locks. At the end mergeReducers() folds them pairwise in a
+// tree, merging disjoint pairs in parallel.
+//
+// Results do not depend on the thread count: ties in score are broken by the
+// design's sweep index, and of two designs with identical objectives the
+// Pareto set keeps the one with the lower index.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_packed.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+// One model output to rank by; scores are oriented so that lower is better.
+struct Objective {
+    Objective(const std::string& output, bool maximized = false)
+        : name(output), field(outputField(output)), column(outputColumn<double>(output)), larger_is_better(maximized) {}
+
+    static Objective minimize(const std::string& output) { return Objective(output, false); }
+    static Objective maximize(const std::string& output) { return Objective(output, true); }
+
+    double score(double value) const { return larger_is_better ? -value : value; }
+
+    std::string name;
+    double ModelOutputs<double>::*field;
+    std::vector<double> OutputBatch<double>::*column;
+    bool larger_is_better;
+};
+
+struct RankedDesign {
+    std::uint64_t index = 0;   // Position in the sweep
+    DesignInputs<double> design;
+    ModelOutputs<double> outputs;
+};
+
+// --- Top-K ---
+
+class TopK {
+public:
+    TopK(const Objective& objective, std::size_t k) : objective_(objective), k_(k) {
+        if (k == 0) {
+            throw std::invalid_argument("TopK: k must be positive");
+        }
+        heap_.reserve(k);
+    }
+
+    std::size_t size() const { return heap_.size(); }
+    std::size_t capacity() const { return k_; }
+    const Objective& objective() const { return objective_; }
+
+    // Lane j of the block is sweep index first + j.
+    void add(const DesignBatch<double>& in, const OutputBatch<double>& out, std::uint64_t first) {
+        const std::vector<double>& column = out.*objective_.column;
+        for (std::size_t j = 0; j < out.size(); ++j) {
+            const double s = objective_.score(column[j]);
+            if (admits(s, first + j)) {
+                push({s, {first + j, in.get(j), out.get(j)}});
+            }
+        }
+    }
+
+    void add(const RankedDesign& d) {
+        const double s = objective_.score(d.outputs.*objective_.field);
+        if (admits(s, d.index)) {
+            push({s, d});
+        }
+    }
+
+    void merge(const TopK& other) {
+        for (const Entry& e : other.heap_) {
+            if (admits(e.score, e.design.index)) {
+                push(e);
+            }
+        }
+    }
+
+    // Best first.
+    std::vector<RankedDesign> sorted() const {
+        std::vector<Entry> entries = heap_;
+        std::sort(entries.begin(), entries.end(), better);
+        std::vector<RankedDesign> result;
+        result.reserve(entries.size());
+        for (Entry& e : entries) {
+            result.push_back(std::move(e.design));
+        }
+        return result;
+    }
+
+private:
+    struct Entry {
+        double score;
+        RankedDesign design;
+    };
+
+    static bool better(const Entry& a, const Entry& b) {
+        return a.score < b.score || (a.score == b.score && a.design.index < b.design.index);
+    }
+
+    // Heap ordered by `better` keeps the worst entry at the front.
+    bool admits(double score, std::uint64_t index) const {
+        if (std::isnan(score)) {
+            return false;
+        }
+        if (heap_.size() < k_) {
+            return true;
+        }
+        const Entry& worst = heap_.front();
+        return score < worst.score || (score == worst.score && index < worst.design.index);
+    }
+
+    void push(Entry e) {
+        if (heap_.size() == k_) {
+            std::pop_heap(heap_.begin(), heap_.end(), better);
+            heap_.back() = std::move(e);
+        } else {
+            heap_.push_back(std::move(e));
+        }
+        std::push_heap(heap_.begin(), heap_.end(), better);
+    }
+
+    Objective objective_;
+    std::size_t k_;
+    std::vector<Entry> heap_;
+};
+
+// --- Pareto skyline ---
+
+class ParetoSet {
+public:
+    explicit ParetoSet(std::vector<Objective> objectives) : objectives_(std::move(objectives)) {
+        if (objectives_.empty()) {
+            throw std::invalid_argument("ParetoSet: at least one objective required");
+        }
+        candidate_.resize(objectives_.size());
+    }
+
+    std::size_t size() const { return members_.size(); }
+    const std::vector<Objective>& objectives() const { return objectives_; }
+
+    void add(const DesignBatch<double>& in, const OutputBatch<double>& out, std::uint64_t first) {
+        const std::size_t m = objectives_.size();
+        for (std::size_t j = 0; j < out.size(); ++j) {
+            bool finite = true;
+            for (std::size_t o = 0; o < m; ++o) {
+                candidate_[o] = objectives_[o].score((out.*objectives_[o].column)[j]);
+                finite = finite && !std::isnan(candidate_[o]);
+            }
+            if (finite && insert(first + j)) {
+                members_.push_back({first + j, in.get(j), out.get(j)});
+            }
+        }
+    }
+
+    void add(const RankedDesign& d) {
+        bool finite = true;
+        for (std::size_t o = 0; o < objectives_.size(); ++o) {
+            candidate_[o] = objectives_[o].score(d.outputs.*objectives_[o].field);
+            finite = finite && !std::isnan(candidate_[o]);
+        }
+        if (finite && insert(d.index)) {
+            members_.push_back(d);
+        }
+    }
+
+    void merge(const ParetoSet& other) {
+        const std::size_t m = objectives_.size();
+        for (std::size_t i = 0; i < other.members_.size(); ++i) {
+            std::copy(other.scores_.begin() + i * m, other.scores_.begin() + (i + 1) * m, candidate_.begin());
+            if (insert(other.members_[i].index)) {
+                members_.push_back(other.members_[i]);
+            }
+        }
+    }
+
+    // Front ordered by the first objective (best first).
+    std::vector<RankedDesign> sorted() const {
+        const std::size_t m = objectives_.size();
+        std::vector<std::size_t> order(members_.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return scores_[a * m] < scores_[b * m] ||
+                   (scores_[a * m] == scores_[b * m] && members_[a].index < members_[b].index);
+        });
+        std::vector<RankedDesign> result;
+        result.reserve(order.size());
+        for (std::size_t i : order) {
+            result.push_back(members_[i]);
+        }
+        return result;
+    }
+
+private:
+    // a dominates b: no worse in every objective and better in one, or equal
+    // throughout with the lower sweep index.
+    bool dominates(const double* a, std::uint64_t a_index, const double* b, std::uint64_t b_index) const {
+        bool strictly = false;
+        for (std::size_t o = 0; o < objectives_.size(); ++o) {
+            if (a[o] > b[o]) {
+                return false;
+            }
+            strictly = strictly || a[o] < b[o];
+        }
+        return strictly || a_index < b_index;
+    }
+
+    // Tests candidate_ against the front. If it survives, drops the members it
+    // dominates, appends its scores and returns true; the caller appends the
+    // member itself.
+    bool insert(std::uint64_t index) {
+        const std::size_t m = objectives_.size();
+        for (std::size_t i = 0; i < members_.size(); ++i) {
+            if (dominates(&scores_[i * m], members_[i].index, candidate_.data(), index)) {
+                // Move the dominating member forward; the next candidate is
+                // usually rejected by the same one
+                if (i > 0) {
+                    std::swap(members_[i], members_[i / 2]);
+                    std::swap_ranges(scores_.begin() + i * m, scores_.begin() + (i + 1) * m, scores_.begin() + (i / 2) * m);
+                }
+                return false;
+            }
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < members_.size(); ++i) {
+            if (!dominates(candidate_.data(), index, &scores_[i * m], members_[i].index)) {
+                if (kept != i) {
+                    members_[kept] = std::move(members_[i]);
+                    std::copy(scores_.begin() + i * m, scores_.begin() + (i + 1) * m, scores_.begin() + kept * m);
+                }
+                ++kept;
+            }
+        }
+        members_.resize(kept);
+        scores_.resize(kept * m);
+        scores_.insert(scores_.end(), candidate_.begin(), candidate_.end());
+        return true;
+    }
+
+    std::vector<Objective> objectives_;
+    std::vector<RankedDesign> members_;
+    std::vector<double> scores_;       // members_.size() x objectives, row-major
+    std::vector<double> candidate_;    // Scratch scores of the design being added
+};
+
+// --- Merging and sweep drivers ---
+
+// Folds parts[1..] into parts[0] in a binary tree, merging disjoint pairs in
+// parallel, and returns parts[0].
+template <class Reducer>
+Reducer mergeReducers(std::vector<Reducer>& parts) {
+    if (parts.empty()) {
+        throw std::invalid_argument("mergeReducers: nothing to merge");
+    }
+    for (std::size_t stride = 1; stride < parts.size(); stride *= 2) {
+        const std::size_t pairs = (parts.size() + 2 * stride - 1) / (2 * stride);
+        parallelFor(pairs, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t p = begin; p < end; ++p) {
+                const std::size_t i = p * 2 * stride;
+                if (i + stride < parts.size()) {
+                    parts[i].merge(parts[i + stride]);
+                }
+            }
+        }, 1);
+    }
+    return std::move(parts[0]);
+}
+
+// Best k designs of catalog entries [begin, end) by one objective.
+inline std::vector<RankedDesign> sweepTopK(const DesignCodebook& codebook, std::uint64_t begin, std::uint64_t end,
+                                           const Objective& objective, std::size_t k,
+                                           const FluidProperties& fluid = FluidProperties{}) {
+    std::vector<TopK> parts(workerCount(), TopK(objective, k));
+    enumerateCatalog(
+        codebook, begin, end,
+        [&](const DesignBatch<double>& in, const OutputBatch<double>& out, std::uint64_t first, unsigned worker) {
+            parts[worker].add(in, out, first);
+        },
+        fluid);
+    return mergeReducers(parts).sorted();
+}
+
+// Pareto front of catalog entries [begin, end).
+inline std::vector<RankedDesign> sweepPareto(const DesignCodebook& codebook, std::uint64_t begin, std::uint64_t end,
+                                             const std::vector<Objective>& objectives,
+                                             const FluidProperties& fluid = FluidProperties{}) {
+    std::vector<ParetoSet> parts(workerCount(), ParetoSet(objectives));
+    enumerateCatalog(
+        codebook, begin, end,
+        [&](const DesignBatch<double>& in, const OutputBatch<double>& out, std::uint64_t first, unsigned worker) {
+            parts[worker].add(in, out, first);
+        },
+        fluid);
+    return mergeReducers(parts).sorted();
+}
+
+}  // namespace vc
@@ -0,0 +1,277 @@
+#pragma once
+// Global sensitivity analysis: first-order and total Sobol indices.
+//
+// Saltelli design: two independent point sets A and B are the first and last
+// d coordinates of a 2d-dimensional Sobol sequence, mapped through the input
+// distributions. For every row the model is evaluated at A, B and the d mixed
+// points AB_i (A with column i taken from B), so a study costs N (d + 2) calls.
+//
+//   S_i  = mean(f_B (f_ABi - f_A)) / V      (Saltelli et al. 2010)
+//   ST_i = mean((f_A - f_ABi)^2) / (2 V)    (Jansen 1999)
+//
+// Rows are processed in fixed blocks. Each block is generated, evaluated and
+// reduced on one worker into its own partial sums, so nothing of size N is
+// kept in memory and the result does not depend on the thread count.
+// Confidence intervals come from a bootstrap over those blocks.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_distributions.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_qmc.hpp"
+
+namespace vc {
+
+struct SensitivityOptions {
+    std::size_t base_samples = 1 << 14;                               // N rows of A / B
+    std::vector<std::string> outputs{"Q_max", "R_total_corrected"};
+    std::size_t block_rows = 512;                                     // Rows per work item / bootstrap unit
+    int bootstrap = 500;                                              // Resamples; 0 disables the CIs
+    double confidence = 0.95;
+    std::uint64_t skip = 1;                                           // Leading Sobol points skipped (point 0 is all zeros)
+    Scrambling scrambling = Scrambling::None;                         // Randomized QMC when not None
+    unsigned long long seed = 1;                                      // Scrambling and bootstrap streams
+};
+
+struct SobolIndex {
+    double value = 0;
+    double lo = 0;   // Bootstrap percentile interval
+    double hi = 0;
+};
+
+struct OutputSensitivity {
+    std::string output;
+    double mean = 0;
+    double variance = 0;
+    std::size_t rows_used = 0;             // Rows where every evaluation was finite
+    std::vector<SobolIndex> first_order;   // One per uncertain input, same order
+    std::vector<SobolIndex> total;
+};
+
+struct SensitivityResult {
+    std::vector<OutputSensitivity> outputs;
+    std::size_t model_calls = 0;
+};
+
+namespace detail {
+
+// Partial sums of one block for one output. Values are shifted by a reference
+// level first so the sums of squares do not cancel.
+struct SaltelliSums {
+    double n = 0;
+    double sum = 0;      // Over f_A and f_B
+    double sum_sq = 0;
+    std::vector<double> first;   // sum f_B (f_ABi - f_A)
+    std::vector<double> total;   // sum (f_A - f_ABi)^2
+
+    void reset(std::size_t d) {
+        n = sum = sum_sq = 0;
+        first.assign(d, 0.0);
+        total.assign(d, 0.0);
+    }
+
+    void add(const SaltelliSums& o) {
+        n += o.n;
+        sum += o.sum;
+        sum_sq += o.sum_sq;
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            first[i] += o.first[i];
+            total[i] += o.total[i];
+        }
+    }
+};
+
+inline void saltelliIndices(const SaltelliSums& s, double& mean, double& var, std::vector<double>& S,
+                            std::vector<double>& ST) {
+    const std::size_t d = s.first.size();
+    S.assign(d, std::nan(""));
+    ST.assign(d, std::nan(""));
+    if (s.n < 2) {
+        mean = var = std::nan("");
+        return;
+    }
+    const double m = s.sum / (2 * s.n);
+    mean = m;
+    var = s.sum_sq / (2 * s.n) - m * m;
+    if (!(var > 0)) {
+        return;
+    }
+    for (std::size_t i = 0; i < d; ++i) {
+        S[i] = s.first[i] / s.n / var;
+        ST[i] = s.total[i] / (2 * s.n * var);
+    }
+}
+
+}  // namespace detail
+
+// Sobol indices of `opt.outputs` with respect to `inputs` around `nominal`
+// (fields not listed in `inputs` stay at their nominal values).
+inline SensitivityResult sobolSensitivity(const DesignInputs<double>& nominal,
+                                          const std::vector<UncertainInput>& inputs,
+                                          const SensitivityOptions& opt = SensitivityOptions{},
+                                          const FluidProperties& fluid = FluidProperties{}) {
+    const std::size_t d = inputs.size();
+    if (d == 0 || 2 * d > static_cast<std::size_t>(SobolSequence::kMaxDims)) {
+        throw std::invalid_argument("sobolSensitivity supports 1.." + std::to_string(SobolSequence::kMaxDims / 2) +
+                                    " uncertain inputs");
+    }
+    const std::size_t n_out = opt.outputs.size();
+    std::vector<std::vector<double> OutputBatch<double>::*> columns;
+    for (const std::string& name : opt.outputs) {
+        columns.push_back(outputColumn<double>(name));
+    }
+
+    // Reference level: the model at the input medians
+    std::vector<double> shift(n_out);
+    {
+        DesignInputs<double> mid = nominal;
+        const std::vector<double> half(d, 0.5);
+        applyUncertainInputs(inputs, half.data(), mid);
+        const ModelOutputs<double> m = evaluateModel(mid, fluid);
+        for (std::size_t k = 0; k < n_out; ++k) {
+            shift[k] = m.*(outputField(opt.outputs[k]));
+            if (!std::isfinite(shift[k])) {
+                shift[k] = 0;
+            }
+        }
+    }
+
+    const std::size_t N = opt.base_samples;
+    const std::size_t rows_per_block = std::max<std::size_t>(opt.block_rows, 1);
+    const std::size_t n_blocks = (N + rows_per_block - 1) / rows_per_block;
+    const std::size_t lanes_per_row = d + 2;
+    checkSequenceRange(SobolSequence(static_cast<int>(2 * d)), opt.skip, N, "sobolSensitivity");
+    std::vector<std::vector<detail::SaltelliSums>> block_sums(n_blocks, std::vector<detail::SaltelliSums>(n_out));
+
+    parallelFor(n_blocks, [&](std::size_t b_begin, std::size_t b_end, unsigned) {
+        SobolSequence seq(static_cast<int>(2 * d), opt.scrambling, opt.seed);
+        std::vector<double> u(2 * d);
+        DesignBatch<double> lanes;
+        OutputBatch<double> out;
+        for (std::size_t b = b_begin; b < b_end; ++b) {
+            const std::size_t row0 = b * rows_per_block;
+            const std::size_t rows = std::min(N, row0 + rows_per_block) - row0;
+            seq.seek(opt.skip + row0);
+            lanes.resize(rows * lanes_per_row);
+            out.resize(rows * lanes_per_row);
+            for (std::size_t r = 0; r < rows; ++r) {
+                seq.next(u.data());
+                DesignInputs<double> a = nominal;
+                DesignInputs<double> bb = nominal;
+                applyUncertainInputs(inputs, u.data(), a);
+                applyUncertainInputs(inputs, u.data() + d, bb);
+                const std::size_t lane = r * lanes_per_row;
+                lanes.set(lane, a);
+                lanes.set(lane + 1, bb);
+                for (std::size_t i = 0; i < d; ++i) {
+                    DesignInputs<double> ab = a;
+                    ab.*(inputs[i].field) = bb.*(inputs[i].field);
+                    lanes.set(lane + 2 + i, ab);
+                }
+            }
+            evaluateBatchRange(lanes, out, 0, lanes.size(), fluid);
+
+            for (std::size_t k = 0; k < n_out; ++k) {
+                const std::vector<double>& f = out.*(columns[k]);
+                detail::SaltelliSums& s = block_sums[b][k];
+                s.reset(d);
+                for (std::size_t r = 0; r < rows; ++r) {
+                    const double* fr = &f[r * lanes_per_row];
+                    bool finite = true;
+                    for (std::size_t j = 0; j < lanes_per_row; ++j) {
+                        finite = finite && std::isfinite(fr[j]);
+                    }
+                    if (!finite) {
+                        continue;
+                    }
+                    const double fa = fr[0] - shift[k];
+                    const double fb = fr[1] - shift[k];
+                    s.n += 1;
+                    s.sum += fa + fb;
+                    s.sum_sq += fa * fa + fb * fb;
+                    for (std::size_t i = 0; i < d; ++i) {
+                        const double fab = fr[2 + i] - shift[k];
+                        s.first[i] += fb * (fab - fa);
+                        s.total[i] += (fa - fab) * (fa - fab);
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    SensitivityResult res;
+    res.model_calls = N * lanes_per_row;
+    res.outputs.resize(n_out);
+    const int B = std::max(opt.bootstrap, 0);
+    for (std::size_t k = 0; k < n_out; ++k) {
+        OutputSensitivity& os = res.outputs[k];
+        os.output = opt.outputs[k];
+        detail::SaltelliSums total;
+        total.reset(d);
+        for (std::size_t b = 0; b < n_blocks; ++b) {
+            total.add(block_sums[b][k]);
+        }
+        std::vector<double> S;
+        std::vector<double> ST;
+        detail::saltelliIndices(total, os.mean, os.variance, S, ST);
+        os.mean += shift[k];
+        os.rows_used = static_cast<std::size_t>(total.n);
+        os.first_order.resize(d);
+        os.total.resize(d);
+        for (std::size_t i = 0; i < d; ++i) {
+            os.first_order[i] = {S[i], S[i], S[i]};
+            os.total[i] = {ST[i], ST[i], ST[i]};
+        }
+        if (B == 0 || n_blocks < 2) {
+            continue;
+        }
+
+        // --- Block bootstrap, one RNG stream per resample ---
+        std::vector<double> boot_S(static_cast<std::size_t>(B) * d);
+        std::vector<double> boot_ST(static_cast<std::size_t>(B) * d);
+        parallelFor(static_cast<std::size_t>(B), [&](std::size_t begin, std::size_t end, unsigned) {
+            detail::SaltelliSums acc;
+            std::vector<double> s_b;
+            std::vector<double> st_b;
+            double m_b;
+            double v_b;
+            for (std::size_t rep = begin; rep < end; ++rep) {
+                std::mt19937_64 g(opt.seed * 0x9E3779B97F4A7C15ULL + rep * 0xBF58476D1CE4E5B9ULL + k);
+                std::uniform_int_distribution<std::size_t> pick(0, n_blocks - 1);
+                acc.reset(d);
+                for (std::size_t b = 0; b < n_blocks; ++b) {
+                    acc.add(block_sums[pick(g)][k]);
+                }
+                detail::saltelliIndices(acc, m_b, v_b, s_b, st_b);
+                for (std::size_t i = 0; i < d; ++i) {
+                    boot_S[i * B + rep] = s_b[i];
+                    boot_ST[i * B + rep] = st_b[i];
+                }
+            }
+        }, 16);
+        const double alpha = 0.5 * (1 - opt.confidence);
+        const auto percentile = [B](double* v, double p) {
+            const std::size_t idx = std::min<std::size_t>(B - 1, static_cast<std::size_t>(p * (B - 1) + 0.5));
+            std::nth_element(v, v + idx, v + B);
+            return v[idx];
+        };
+        for (std::size_t i = 0; i < d; ++i) {
+            os.first_order[i].lo = percentile(&boot_S[i * B], alpha);
+            os.first_order[i].hi = percentile(&boot_S[i * B], 1 - alpha);
+            os.total[i].lo = percentile(&boot_ST[i * B], alpha);
+            os.total[i].hi = percentile(&boot_ST[i * B], 1 - alpha);
+        }
+    }
+    return res;
+}
+
+}  // namespace vc
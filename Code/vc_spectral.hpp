@@ -0,0 +1,363 @@
+#pragma once
+// Spectral (DCT) solver for the evaporator wall under arbitrary power maps.
+//
+// On the evaporator wall both the in-plane conductance k_shell * t_evap_wall
+// and the out-of-plane conductance h are uniform, so the cell-centered
+// five-point operator -k t lap + h with zero-flux edges is diagonalized by a
+// DCT-II along each axis:
+//
+//     lambda_pq = k t (2 - 2 cos(pi p / nx)) / dx^2 + k t (2 - 2 cos(pi q / ny)) / dy^2 + h
+//
+// The solve is: forward DCT of the flux map, divide by lambda, inverse DCT.
+// This is the same discrete problem the multigrid path in vc_spreading.hpp
+// solves. Plans (twiddles, bit reversal) and the eigenvalue table are built
+// once per plate geometry, so each further power map costs one transform
+// pair. DCTs go through Makhoul's length-n complex FFT for power-of-two n and
+// through a cached cosine table otherwise.
+//
+// evaluateModelWithPowerMap() sets Q_in to the total map power. Its
+// R_evap_spreading has the definition of vc_spreading.hpp: the power-weighted
+// mean wall rise per watt minus 1 / (h A_evap), the part of the rise the
+// network already counts, so for a single centered source both solvers agree.
+// The hot-spot value, peak rise per watt minus the same baseline, is always
+// returned as PowerMapResult::R_evap_spreading_peak. With
+// SpreadingOptions::evap_reference = Peak it is also the R_evap_spreading the
+// network sums, so R_total_corrected and delta_T follow the hot spot.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_spreading.hpp"
+
+namespace vc {
+
+// A rectangular heat source on the plate; (x0, y0) is its corner measured
+// from the plate corner along vc_length / vc_width [m].
+struct HeatSource {
+    double x0 = 0;
+    double y0 = 0;
+    double length = 0;
+    double width = 0;
+    double power = 0;   // [W]
+};
+
+// Heat flux per cell [W/m^2] of a list of sources.
+inline std::vector<double> rasterizePowerMap(int nx, int ny, double plate_length, double plate_width,
+                                             const std::vector<HeatSource>& sources) {
+    std::vector<double> q(static_cast<std::size_t>(nx) * ny, 0.0);
+    const double cell_area = (plate_length / nx) * (plate_width / ny);
+    for (const HeatSource& s : sources) {
+        const std::vector<double> cover = rectangleFootprint(nx, ny, plate_length, plate_width, s.x0, s.y0, s.length, s.width);
+        double covered = 0;
+        for (double c : cover) {
+            covered += c * cell_area;
+        }
+        if (covered <= 0) {
+            continue;
+        }
+        for (std::size_t k = 0; k < q.size(); ++k) {
+            q[k] += cover[k] * s.power / covered;
+        }
+    }
+    return q;
+}
+
+// Unnormalized DCT-II (forward) and its inverse, on contiguous length-n arrays.
+class DctPlan {
+public:
+    explicit DctPlan(int n) : n_(n) {
+        if (n < 1) {
+            throw std::invalid_argument("DctPlan needs n >= 1");
+        }
+        fft_ = (n & (n - 1)) == 0 && n >= 2;
+        const double pi = M_PI;
+        if (fft_) {
+            twiddle_.resize(n / 2);
+            for (int k = 0; k < n / 2; ++k) {
+                twiddle_[k] = std::polar(1.0, -2 * pi * k / n);
+            }
+            shift_.resize(n);
+            for (int k = 0; k < n; ++k) {
+                shift_[k] = std::polar(1.0, -pi * k / (2.0 * n));
+            }
+            bitrev_.resize(n);
+            int bits = 0;
+            while ((1 << bits) < n) {
+                ++bits;
+            }
+            for (int i = 0; i < n; ++i) {
+                int r = 0;
+                for (int b = 0; b < bits; ++b) {
+                    r |= ((i >> b) & 1) << (bits - 1 - b);
+                }
+                bitrev_[i] = r;
+            }
+        } else {
+            cos_.resize(static_cast<std::size_t>(n) * n);
+            for (int k = 0; k < n; ++k) {
+                for (int i = 0; i < n; ++i) {
+                    cos_[static_cast<std::size_t>(k) * n + i] = std::cos(pi * (i + 0.5) * k / n);
+                }
+            }
+        }
+    }
+
+    int size() const { return n_; }
+
+    // X_k = sum_i x_i cos(pi (i + 1/2) k / n)
+    void forward(double* x, std::vector<std::complex<double>>& work) const {
+        const int n = n_;
+        if (!fft_) {
+            std::vector<double> y(n, 0.0);
+            for (int k = 0; k < n; ++k) {
+                const double* c = &cos_[static_cast<std::size_t>(k) * n];
+                for (int i = 0; i < n; ++i) {
+                    y[k] += c[i] * x[i];
+                }
+            }
+            std::copy(y.begin(), y.end(), x);
+            return;
+        }
+        work.resize(n);
+        for (int i = 0; i < n / 2; ++i) {
+            work[i] = x[2 * i];
+            work[n - 1 - i] = x[2 * i + 1];
+        }
+        fft(work, false);
+        for (int k = 0; k < n; ++k) {
+            x[k] = (shift_[k] * work[k]).real();
+        }
+    }
+
+    // Inverse of forward(): x_i = (2 / n) (X_0 / 2 + sum_k>0 X_k cos(pi (i + 1/2) k / n))
+    void inverse(double* X, std::vector<std::complex<double>>& work) const {
+        const int n = n_;
+        if (!fft_) {
+            std::vector<double> y(n, 0.0);
+            for (int k = 0; k < n; ++k) {
+                const double* c = &cos_[static_cast<std::size_t>(k) * n];
+                const double w = (k == 0 ? 1.0 : 2.0) / n;
+                for (int i = 0; i < n; ++i) {
+                    y[i] += w * c[i] * X[k];
+                }
+            }
+            std::copy(y.begin(), y.end(), X);
+            return;
+        }
+        work.resize(n);
+        for (int k = 0; k < n; ++k) {
+            const double xr = X[k];
+            const double xi = k == 0 ? 0.0 : -X[n - k];
+            work[k] = std::conj(shift_[k]) * std::complex<double>(xr, xi);
+        }
+        fft(work, true);
+        for (int i = 0; i < n / 2; ++i) {
+            X[2 * i] = work[i].real();
+            X[2 * i + 1] = work[n - 1 - i].real();
+        }
+    }
+
+private:
+    // Iterative radix-2; the inverse includes the 1/n scaling.
+    void fft(std::vector<std::complex<double>>& a, bool inverse) const {
+        const int n = n_;
+        for (int i = 0; i < n; ++i) {
+            if (i < bitrev_[i]) {
+                std::swap(a[i], a[bitrev_[i]]);
+            }
+        }
+        for (int len = 2; len <= n; len <<= 1) {
+            const int step = n / len;
+            for (int i = 0; i < n; i += len) {
+                for (int k = 0; k < len / 2; ++k) {
+                    const std::complex<double> w = inverse ? std::conj(twiddle_[k * step]) : twiddle_[k * step];
+                    const std::complex<double> u = a[i + k];
+                    const std::complex<double> v = a[i + k + len / 2] * w;
+                    a[i + k] = u + v;
+                    a[i + k + len / 2] = u - v;
+                }
+            }
+        }
+        if (inverse) {
+            for (std::complex<double>& v : a) {
+                v /= n;
+            }
+        }
+    }
+
+    int n_;
+    bool fft_;
+    std::vector<std::complex<double>> twiddle_;
+    std::vector<std::complex<double>> shift_;
+    std::vector<int> bitrev_;
+    std::vector<double> cos_;
+};
+
+// -c lap(u) + h u = f on an nx x ny cell-centered plate with zero-flux edges,
+// c and h uniform. With h = 0 the problem is singular and the zero-mean
+// solution is returned (f should then sum to zero).
+class SpectralPlateSolver {
+public:
+    SpectralPlateSolver(int nx, int ny, double plate_length, double plate_width, double c, double h)
+        : nx_(nx), ny_(ny), plan_x_(nx), plan_y_(ny), plate_length_(plate_length), plate_width_(plate_width) {
+        const double dx = plate_length / nx;
+        const double dy = plate_width / ny;
+        inv_lambda_.resize(static_cast<std::size_t>(nx) * ny);
+        for (int q = 0; q < ny; ++q) {
+            const double ly = c * (2 - 2 * std::cos(M_PI * q / ny)) / (dy * dy);
+            for (int p = 0; p < nx; ++p) {
+                const double lx = c * (2 - 2 * std::cos(M_PI * p / nx)) / (dx * dx);
+                const double lambda = lx + ly + h;
+                inv_lambda_[static_cast<std::size_t>(q) * nx + p] = lambda > 0 ? 1 / lambda : 0;
+            }
+        }
+    }
+
+    int nx() const { return nx_; }
+    int ny() const { return ny_; }
+    double plateLength() const { return plate_length_; }
+    double plateWidth() const { return plate_width_; }
+
+    // u for a source map f, both row-major nx*ny. `threaded` = false keeps the
+    // solve on the calling thread (for callers that parallelize over maps).
+    void solve(const std::vector<double>& f, std::vector<double>& u, bool threaded = true) const {
+        u = f;
+        transformRows(u, true, threaded);
+        transformColumns(u, true, threaded);
+        for (std::size_t k = 0; k < u.size(); ++k) {
+            u[k] *= inv_lambda_[k];
+        }
+        transformColumns(u, false, threaded);
+        transformRows(u, false, threaded);
+    }
+
+private:
+    void transformRows(std::vector<double>& f, bool forward, bool threaded) const {
+        const auto rows = [&](std::size_t begin, std::size_t end, unsigned) {
+            std::vector<std::complex<double>> work;
+            for (std::size_t j = begin; j < end; ++j) {
+                double* row = &f[j * nx_];
+                forward ? plan_x_.forward(row, work) : plan_x_.inverse(row, work);
+            }
+        };
+        threaded ? parallelFor(static_cast<std::size_t>(ny_), rows, 32) : rows(0, ny_, 0u);
+    }
+
+    void transformColumns(std::vector<double>& f, bool forward, bool threaded) const {
+        const auto cols = [&](std::size_t begin, std::size_t end, unsigned) {
+            std::vector<std::complex<double>> work;
+            std::vector<double> col(ny_);
+            for (std::size_t i = begin; i < end; ++i) {
+                for (int j = 0; j < ny_; ++j) {
+                    col[j] = f[static_cast<std::size_t>(j) * nx_ + i];
+                }
+                forward ? plan_y_.forward(col.data(), work) : plan_y_.inverse(col.data(), work);
+                for (int j = 0; j < ny_; ++j) {
+                    f[static_cast<std::size_t>(j) * nx_ + i] = col[j];
+                }
+            }
+        };
+        threaded ? parallelFor(static_cast<std::size_t>(nx_), cols, 32) : cols(0, nx_, 0u);
+    }
+
+    int nx_;
+    int ny_;
+    DctPlan plan_x_;
+    DctPlan plan_y_;
+    double plate_length_;
+    double plate_width_;
+    std::vector<double> inv_lambda_;
+};
+
+// Evaporator wall of a design: c = k_shell * t_evap_wall, h = half wall plus
+// evaporator wick, as in solveEvaporatorSpreading().
+class SpectralSpreadingSolver : public SpectralPlateSolver {
+public:
+    SpectralSpreadingSolver(const DesignInputs<double>& in, const ModelOutputs<double>& out, int nx = 128, int ny = 128)
+        : SpectralPlateSolver(nx, ny, in.vc_length, in.vc_width, in.k_shell * in.t_evap_wall, evaporatorSink(in, out)),
+          h_(evaporatorSink(in, out)) {}
+
+    double sinkConductance() const { return h_; }   // Out-of-plane h [W/m^2K]
+
+    using SpectralPlateSolver::solve;
+
+    // Wall rise above the vapor [K] for a list of sources.
+    void solve(const std::vector<HeatSource>& sources, std::vector<double>& theta) const {
+        solve(rasterizePowerMap(nx(), ny(), plateLength(), plateWidth(), sources), theta);
+    }
+
+private:
+    static double evaporatorSink(const DesignInputs<double>& in, const ModelOutputs<double>& out) {
+        return 1 / (in.t_evap_wall / (2 * in.k_shell) + out.t_evap_wick / out.k_wick_evap);
+    }
+
+    double h_;
+};
+
+struct PowerMapResult {
+    std::vector<double> theta_evap;   // Evaporator wall rise above vapor [K], row-major nx*ny
+    double theta_mean = 0;            // Power-weighted mean rise [K]
+    double theta_peak = 0;            // [K]
+    int peak_i = 0;
+    int peak_j = 0;
+    double R_evap_spreading_peak = 0; // theta_peak / Q_in - 1 / (h A_evap) [K/W]
+};
+
+// evaluateModel for a multi-source power map: Q_in = total power and
+// R_evap_spreading from the power-weighted mean wall rise, or from the peak
+// per opt.evap_reference. R_cond_spreading
+// comes from the condenser solve of vc_spreading.hpp when opt names a partial
+// cold plate.
+inline ModelOutputs<double> evaluateModelWithPowerMap(DesignInputs<double> in, const std::vector<HeatSource>& sources,
+                                                      const FluidProperties& fluid = FluidProperties{},
+                                                      const SpreadingOptions& opt = SpreadingOptions{},
+                                                      PowerMapResult* detail = nullptr) {
+    double total = 0;
+    for (const HeatSource& s : sources) {
+        total += s.power;
+    }
+    in.Q_in = total;
+    ModelOutputs<double> out = evaluateModel(in, fluid);
+    const SpectralSpreadingSolver solver(in, out, opt.nx, opt.ny);
+    PowerMapResult res;
+    const std::vector<double> q = rasterizePowerMap(opt.nx, opt.ny, in.vc_length, in.vc_width, sources);
+    solver.solve(q, res.theta_evap);
+    double weighted = 0;
+    double weight = 0;
+    for (int j = 0; j < opt.ny; ++j) {
+        for (int i = 0; i < opt.nx; ++i) {
+            const std::size_t k = static_cast<std::size_t>(j) * opt.nx + i;
+            const double t = res.theta_evap[k];
+            weighted += t * q[k];
+            weight += q[k];
+            if (t > res.theta_peak) {
+                res.theta_peak = t;
+                res.peak_i = i;
+                res.peak_j = j;
+            }
+        }
+    }
+    res.theta_mean = weight > 0 ? weighted / weight : 0;
+    const double baseline = 1 / (solver.sinkConductance() * out.A_evap);
+    const double R_mean = total > 0 ? res.theta_mean / total - baseline : 0;
+    res.R_evap_spreading_peak = total > 0 ? res.theta_peak / total - baseline : 0;
+    out.R_evap_spreading = opt.evap_reference == SpreadingReference::Peak ? res.R_evap_spreading_peak : R_mean;
+    if (opt.cold_plate_length > 0 || opt.cold_plate_width > 0) {
+        SpreadingResult cond;
+        solveCondenserSpreading(in, out, opt, cond);
+        out.R_cond_spreading = cond.R_cond_spreading;
+    }
+    sumResistanceNetwork(in, out);
+    if (detail) {
+        *detail = std::move(res);
+    }
+    return out;
+}
+
+}  // namespace vc
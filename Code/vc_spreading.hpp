@@ -0,0 +1,181 @@
+#pragma once
+// 2D in-plane spreading conduction in the evaporator and condenser walls.
+//
+// Each wall is treated as a thin plate (in-plane conductance k_shell * t_wall)
+// coupled out of plane to an isothermal sink through a per-area conductance h:
+//
+//     -k t lap(theta) + h(x, y) theta = q(x, y),   zero-flux plate edges
+//
+// Evaporator: q = Q / A_evap over the (centered) heat-source footprint, h is the
+//             half wall plus the evaporator wick over the whole plate.
+// Condenser:  q = Q / (vc_length * vc_width) (uniform condensation), h is the
+//             half wall into the cold plate over the cold-plate footprint.
+//
+// The spreading resistance is the 2D field minus the 1D terms of the network
+// that describe the same conduction path, so adding it to the series network
+// (as R_evap_spreading / R_cond_spreading) replaces those terms by the field:
+//
+//   evaporator: source-averaged rise - 1/(h A_evap); the network's
+//               R_evap_wall + R_evap_wick + R_evap_spreading is then
+//               t_evap_wall/(2 k_shell A_evap) + source-averaged rise
+//   condenser:  plate-averaged rise - 1/(h A_cond), likewise for R_cond_wall
+//
+// Spreading lowers the resistance whenever the source is smaller than the
+// plate, so R_evap_spreading is normally negative. The baselines are
+// uncalibrated; the wall/wick multipliers scale only the 1D terms.
+//
+// SpreadingReference::Peak swaps the source-averaged rise for the hottest
+// wall cell, so R_total_corrected and delta_T describe the hot spot (the
+// junction limit) rather than the mean source temperature.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "vc_model.hpp"
+#include "vc_multigrid.hpp"
+
+namespace vc {
+
+// Evaporator wall rise that R_evap_spreading is measured from.
+enum class SpreadingReference : std::uint8_t {
+    SourceAverage,   // Averaged over the heat input
+    Peak,            // Hottest wall cell
+};
+
+struct SpreadingOptions {
+    int nx = 128;                   // Plate cells along vc_length (even, so multigrid can coarsen)
+    int ny = 128;                   // Plate cells along vc_width
+    double cold_plate_length = 0;   // Centered cold-plate footprint [m]; 0 = whole plate
+    double cold_plate_width = 0;
+    double tolerance = 1e-8;
+    SpreadingReference evap_reference = SpreadingReference::SourceAverage;
+};
+
+struct SpreadingResult {
+    double R_evap_spreading = 0;   // [K/W]
+    double R_cond_spreading = 0;   // [K/W]
+    double theta_evap_source = 0;  // Source-averaged evaporator wall rise above vapor per watt [K/W]
+    double theta_evap_peak = 0;    // Peak evaporator wall rise above vapor per watt [K/W]
+    double theta_cond_mean = 0;    // Plate-averaged condenser wall rise above coolant per watt [K/W]
+    int evap_cycles = 0;
+    int cond_cycles = 0;
+    std::vector<double> theta_evap;   // Evaporator wall rise above vapor per watt, row-major nx*ny [K/W]
+    std::vector<double> theta_cond;   // Condenser wall rise above coolant per watt [K/W]
+};
+
+// Fraction of each cell covered by the rectangle [x0, x0 + len] x [y0, y0 + wid].
+inline std::vector<double> rectangleFootprint(int nx, int ny, double plate_length, double plate_width, double x0,
+                                              double y0, double len, double wid) {
+    const double dx = plate_length / nx;
+    const double dy = plate_width / ny;
+    const double x1 = x0 + len;
+    const double y1 = y0 + wid;
+    std::vector<double> cover(static_cast<std::size_t>(nx) * ny);
+    for (int j = 0; j < ny; ++j) {
+        const double fy = std::max(0.0, std::min(y1, (j + 1) * dy) - std::max(y0, j * dy)) / dy;
+        for (int i = 0; i < nx; ++i) {
+            const double fx = std::max(0.0, std::min(x1, (i + 1) * dx) - std::max(x0, i * dx)) / dx;
+            cover[static_cast<std::size_t>(j) * nx + i] = fx * fy;
+        }
+    }
+    return cover;
+}
+
+// Fraction of each cell covered by the centered rectangle len x wid.
+inline std::vector<double> centeredFootprint(int nx, int ny, double plate_length, double plate_width, double len,
+                                             double wid) {
+    return rectangleFootprint(nx, ny, plate_length, plate_width, 0.5 * (plate_length - len),
+                              0.5 * (plate_width - wid), len, wid);
+}
+
+// Evaporator wall for a unit heat load (the problem is linear in Q_in).
+inline void solveEvaporatorSpreading(const DesignInputs<double>& in, const ModelOutputs<double>& out,
+                                     const SpreadingOptions& opt, SpreadingResult& res) {
+    const int nx = opt.nx;
+    const int ny = opt.ny;
+    const std::size_t n = static_cast<std::size_t>(nx) * ny;
+    const double dx = in.vc_length / nx;
+    const double dy = in.vc_width / ny;
+    const double cell_area = dx * dy;
+    const std::vector<double> source = centeredFootprint(nx, ny, in.vc_length, in.vc_width, in.evap_length, in.evap_width);
+    double source_area = 0;
+    for (double s : source) {
+        source_area += s * cell_area;
+    }
+    const double h = 1 / (in.t_evap_wall / (2 * in.k_shell) + out.t_evap_wick / out.k_wick_evap);
+    const std::vector<double> c(n, in.k_shell * in.t_evap_wall);
+    const std::vector<double> a(n, h);
+    std::vector<double> q(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        q[k] = source[k] / source_area;
+    }
+    MultigridSolver mg(nx, ny, dx, dy, c, a);
+    res.evap_cycles = mg.solve(q, res.theta_evap, opt.tolerance);
+    double theta_source = 0;
+    res.theta_evap_peak = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        theta_source += res.theta_evap[k] * source[k] * cell_area;
+        res.theta_evap_peak = std::max(res.theta_evap_peak, res.theta_evap[k]);
+    }
+    res.theta_evap_source = theta_source / source_area;
+    const bool peak = opt.evap_reference == SpreadingReference::Peak;
+    res.R_evap_spreading = (peak ? res.theta_evap_peak : res.theta_evap_source) - 1 / (h * out.A_evap);
+}
+
+// Condenser wall for a unit heat load.
+inline void solveCondenserSpreading(const DesignInputs<double>& in, const ModelOutputs<double>& out,
+                                    const SpreadingOptions& opt, SpreadingResult& res) {
+    const int nx = opt.nx;
+    const int ny = opt.ny;
+    const std::size_t n = static_cast<std::size_t>(nx) * ny;
+    const double dx = in.vc_length / nx;
+    const double dy = in.vc_width / ny;
+    const double plate_area = in.vc_length * in.vc_width;
+    const double cp_len = opt.cold_plate_length > 0 ? opt.cold_plate_length : in.vc_length;
+    const double cp_wid = opt.cold_plate_width > 0 ? opt.cold_plate_width : in.vc_width;
+    const std::vector<double> sink = centeredFootprint(nx, ny, in.vc_length, in.vc_width, cp_len, cp_wid);
+    const double h = 1 / (in.t_cond_wall / (2 * in.k_shell));
+    const std::vector<double> c(n, in.k_shell * in.t_cond_wall);
+    std::vector<double> a(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        a[k] = h * sink[k];
+    }
+    const std::vector<double> q(n, 1 / plate_area);
+    MultigridSolver mg(nx, ny, dx, dy, c, a);
+    res.cond_cycles = mg.solve(q, res.theta_cond, opt.tolerance);
+    res.theta_cond_mean = 0;
+    for (double t : res.theta_cond) {
+        res.theta_cond_mean += t;
+    }
+    res.theta_cond_mean /= static_cast<double>(n);
+    res.R_cond_spreading = res.theta_cond_mean - 1 / (h * out.A_cond);
+}
+
+// Solves both walls for a unit heat load.
+inline SpreadingResult solveWallSpreading(const DesignInputs<double>& in, const ModelOutputs<double>& out,
+                                          const SpreadingOptions& opt = SpreadingOptions{}) {
+    SpreadingResult res;
+    solveEvaporatorSpreading(in, out, opt, res);
+    solveCondenserSpreading(in, out, opt, res);
+    return res;
+}
+
+// evaluateModel with the 2D wall spreading resistances fed into the network.
+inline ModelOutputs<double> evaluateModelWithSpreading(const DesignInputs<double>& in,
+                                                       const FluidProperties& fluid = FluidProperties{},
+                                                       const SpreadingOptions& opt = SpreadingOptions{},
+                                                       SpreadingResult* detail = nullptr) {
+    ModelOutputs<double> out = evaluateModel(in, fluid);
+    SpreadingResult res = solveWallSpreading(in, out, opt);
+    out.R_evap_spreading = res.R_evap_spreading;
+    out.R_cond_spreading = res.R_cond_spreading;
+    sumResistanceNetwork(in, out);
+    if (detail) {
+        *detail = std::move(res);
+    }
+    return out;
+}
+
+}  // namespace vc
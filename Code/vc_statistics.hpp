@@ -0,0 +1,381 @@
+#pragma once
+// Streaming statistics of model outputs for Monte-Carlo tolerance studies.
+//
+// Per tracked output: count, mean and variance by Welford's update (Chan et
+// al. to merge), min / max, and a merging t-digest for quantiles. The digest
+// uses the logistic scale function k(q) = (delta / Z) ln(q / (1 - q)), Z =
+// 4 ln(n / delta) + 24, so centroids shrink toward both tails: the extreme
+// samples stay singletons and q = 0.001 is resolved to a few percent of q,
+// not to a fixed rank step. Memory is O(delta) per output, independent of the
+// number of samples.
+//
+// Floating-point merges are not associative, so per-thread partials merged in
+// arrival order would change with the thread count. monteCarloStatistics()
+// instead accumulates fixed segments of kStatisticsSegment samples and merges
+// them along the binary tree of aligned segment ranges ([0, 1), [0, 2),
+// [4, 8), ...): each worker folds complete subtrees of its own range, and the
+// leftovers are folded in index order at the end. Every merge combines the
+// same two children whatever the partitioning, so results are bit-identical
+// for any number of workers.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_distributions.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_qmc.hpp"
+
+namespace vc {
+
+// --- Welford moments ---
+
+struct RunningMoments {
+    std::uint64_t count = 0;
+    double mean = 0;
+    double m2 = 0;   // Sum of squared deviations from the mean
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double x) {
+        ++count;
+        const double delta = x - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (x - mean);
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+
+    void merge(const RunningMoments& o) {
+        if (o.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = o;
+            return;
+        }
+        const double n_a = static_cast<double>(count);
+        const double n_b = static_cast<double>(o.count);
+        const double n = n_a + n_b;
+        const double delta = o.mean - mean;
+        mean += delta * n_b / n;
+        m2 += o.m2 + delta * delta * n_a * n_b / n;
+        count += o.count;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+
+    // Sample variance (n - 1).
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double stdDev() const { return std::sqrt(variance()); }
+};
+
+// --- t-digest ---
+
+class QuantileSketch {
+public:
+    explicit QuantileSketch(double compression = 500) : compression_(compression) {
+        if (!(compression >= 20)) {
+            throw std::invalid_argument("QuantileSketch: compression must be at least 20");
+        }
+        buffer_.reserve(bufferCapacity());
+    }
+
+    void add(double x) {
+        buffer_.push_back(x);
+        min_ = std::min(min_, x);
+        max_ = std::max(max_, x);
+        if (buffer_.size() >= bufferCapacity()) {
+            flush();
+        }
+    }
+
+    void merge(const QuantileSketch& o) {
+        std::vector<Centroid> items = centroids_;
+        items.insert(items.end(), o.centroids_.begin(), o.centroids_.end());
+        for (double x : buffer_) {
+            items.push_back({x, 1});
+        }
+        for (double x : o.buffer_) {
+            items.push_back({x, 1});
+        }
+        buffer_.clear();
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+        compress(items);
+    }
+
+    double count() const {
+        double w = static_cast<double>(buffer_.size());
+        for (const Centroid& c : centroids_) {
+            w += c.weight;
+        }
+        return w;
+    }
+
+    std::size_t centroidCount() const { return centroids_.size(); }
+
+    // Value at cumulative probability q in [0, 1]; NaN when empty.
+    double quantile(double q) const {
+        if (!buffer_.empty()) {
+            QuantileSketch flushed = *this;
+            flushed.flush();
+            return flushed.quantile(q);
+        }
+        if (centroids_.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        q = std::min(std::max(q, 0.0), 1.0);
+        const double target = q * count();
+        // Centroid i is taken to sit at cumulative weight cum_i + w_i / 2
+        double cum = 0;
+        double prev_mean = min_;
+        double prev_pos = 0;
+        for (const Centroid& c : centroids_) {
+            const double pos = cum + c.weight / 2;
+            if (target < pos) {
+                if (c.weight == 1 && target >= cum) {
+                    return c.mean;
+                }
+                return prev_mean + (c.mean - prev_mean) * (target - prev_pos) / (pos - prev_pos);
+            }
+            cum += c.weight;
+            prev_mean = c.mean;
+            prev_pos = pos;
+        }
+        const double total = cum;
+        return total > prev_pos ? prev_mean + (max_ - prev_mean) * (target - prev_pos) / (total - prev_pos) : max_;
+    }
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    std::size_t bufferCapacity() const { return static_cast<std::size_t>(5 * compression_); }
+
+    void flush() {
+        if (buffer_.empty()) {
+            return;
+        }
+        std::vector<Centroid> items = centroids_;
+        for (double x : buffer_) {
+            items.push_back({x, 1});
+        }
+        buffer_.clear();
+        compress(items);
+    }
+
+    // One greedy pass over `items` in mean order, merging neighbors while the
+    // merged centroid spans at most one unit of k.
+    void compress(std::vector<Centroid>& items) {
+        std::sort(items.begin(), items.end(), [](const Centroid& a, const Centroid& b) {
+            return a.mean < b.mean || (a.mean == b.mean && a.weight < b.weight);
+        });
+        double total = 0;
+        for (const Centroid& c : items) {
+            total += c.weight;
+        }
+        centroids_.clear();
+        if (items.empty()) {
+            return;
+        }
+        const double z = 4 * std::log(std::max(total / compression_, 1.0)) + 24;
+        const double scale = compression_ / z;
+        const auto k = [scale](double q) { return scale * std::log(q / (1 - q)); };
+        const auto q_of_k = [scale](double kv) { return 1 / (1 + std::exp(-kv / scale)); };
+        const auto limit = [&](double done) {
+            const double q0 = done / total;
+            return q0 <= 0 ? 0.0 : q0 >= 1 ? 1.0 : q_of_k(k(q0) + 1);
+        };
+
+        Centroid current = items[0];
+        double done = 0;   // Weight left of `current`
+        double q_limit = limit(done);
+        for (std::size_t i = 1; i < items.size(); ++i) {
+            const Centroid& next = items[i];
+            if ((done + current.weight + next.weight) / total <= q_limit) {
+                current.weight += next.weight;
+                current.mean += (next.mean - current.mean) * next.weight / current.weight;
+            } else {
+                centroids_.push_back(current);
+                done += current.weight;
+                q_limit = limit(done);
+                current = next;
+            }
+        }
+        centroids_.push_back(current);
+    }
+
+    double compression_;
+    std::vector<Centroid> centroids_;   // Sorted by mean
+    std::vector<double> buffer_;        // Unmerged samples
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+};
+
+// --- Per-output aggregator ---
+
+struct OutputStatistics {
+    std::string name;
+    RunningMoments moments;
+    QuantileSketch sketch;
+    std::uint64_t non_finite = 0;   // NaN / inf samples, excluded from the above
+};
+
+class StatisticsAccumulator {
+public:
+    explicit StatisticsAccumulator(const std::vector<std::string>& outputs, double compression = 500) {
+        for (const std::string& name : outputs) {
+            columns_.push_back(outputColumn<double>(name));
+            stats_.push_back({name, RunningMoments{}, QuantileSketch(compression), 0});
+        }
+    }
+
+    // Lanes [begin, end) of a batch, in lane order.
+    void add(const OutputBatch<double>& out, std::size_t begin, std::size_t end) {
+        for (std::size_t o = 0; o < stats_.size(); ++o) {
+            const std::vector<double>& column = out.*columns_[o];
+            OutputStatistics& s = stats_[o];
+            for (std::size_t i = begin; i < end; ++i) {
+                const double x = column[i];
+                if (std::isfinite(x)) {
+                    s.moments.add(x);
+                    s.sketch.add(x);
+                } else {
+                    ++s.non_finite;
+                }
+            }
+        }
+    }
+
+    void add(const OutputBatch<double>& out) { add(out, 0, out.size()); }
+
+    void merge(const StatisticsAccumulator& o) {
+        for (std::size_t i = 0; i < stats_.size(); ++i) {
+            stats_[i].moments.merge(o.stats_[i].moments);
+            stats_[i].sketch.merge(o.stats_[i].sketch);
+            stats_[i].non_finite += o.stats_[i].non_finite;
+        }
+    }
+
+    const std::vector<OutputStatistics>& outputs() const { return stats_; }
+
+    const OutputStatistics& output(const std::string& name) const {
+        for (const OutputStatistics& s : stats_) {
+            if (s.name == name) {
+                return s;
+            }
+        }
+        throw std::invalid_argument("StatisticsAccumulator: output not tracked: " + name);
+    }
+
+private:
+    std::vector<std::vector<double> OutputBatch<double>::*> columns_;
+    std::vector<OutputStatistics> stats_;
+};
+
+// --- Deterministic Monte-Carlo driver ---
+
+constexpr std::size_t kStatisticsSegment = 8192;
+
+namespace detail {
+
+// Partial result over the aligned segment range [index 2^level, (index + 1) 2^level).
+struct StatisticsNode {
+    unsigned level;
+    std::uint64_t index;
+    StatisticsAccumulator acc;
+};
+
+// Appends `node` and merges complete sibling pairs off the top.
+inline void pushStatisticsNode(std::vector<StatisticsNode>& stack, StatisticsNode node) {
+    stack.push_back(std::move(node));
+    while (stack.size() >= 2) {
+        StatisticsNode& right = stack[stack.size() - 1];
+        StatisticsNode& left = stack[stack.size() - 2];
+        if (left.level != right.level || left.index % 2 != 0 || right.index != left.index + 1) {
+            break;
+        }
+        left.acc.merge(right.acc);
+        ++left.level;
+        left.index /= 2;
+        stack.pop_back();
+    }
+}
+
+}  // namespace detail
+
+// Statistics of `outputs` over points first_index .. first_index + count - 1
+// of a quasi-random sequence mapped through `inputs` (see sampleDesignBatch).
+// Samples are generated, evaluated and reduced block by block; no sample or
+// output matrix is kept.
+template <class Sequence>
+StatisticsAccumulator monteCarloStatistics(const Sequence& sequence, std::uint64_t first_index, std::uint64_t count,
+                                           const DesignInputs<double>& nominal,
+                                           const std::vector<UncertainInput>& inputs,
+                                           const std::vector<std::string>& outputs,
+                                           const FluidProperties& fluid = FluidProperties{},
+                                           double compression = 500) {
+    constexpr std::size_t kBlock = 1024;
+    const std::size_t d = inputs.size();
+    checkSequenceRange(sequence, first_index, count, "monteCarloStatistics");
+    const std::size_t segments = static_cast<std::size_t>((count + kStatisticsSegment - 1) / kStatisticsSegment);
+    const StatisticsAccumulator empty(outputs, compression);
+    std::vector<std::vector<detail::StatisticsNode>> stacks(workerCount());
+
+    parallelFor(segments, [&](std::size_t s_begin, std::size_t s_end, unsigned worker) {
+        Sequence seq = sequence;
+        std::vector<double> u(d * kBlock);
+        DesignBatch<double> block_in;
+        OutputBatch<double> block_out;
+        block_in.resize(kBlock, nominal);
+        block_out.resize(kBlock);
+        for (std::size_t s = s_begin; s < s_end; ++s) {
+            const std::uint64_t seg_first = static_cast<std::uint64_t>(s) * kStatisticsSegment;
+            const std::uint64_t seg_end = std::min<std::uint64_t>(count, seg_first + kStatisticsSegment);
+            detail::StatisticsNode leaf{0, s, empty};
+            seq.seek(first_index + seg_first);
+            for (std::uint64_t b0 = seg_first; b0 < seg_end; b0 += kBlock) {
+                const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(kBlock, seg_end - b0));
+                seq.fillBlock(n, u.data(), kBlock);
+                for (std::size_t i = 0; i < d; ++i) {
+                    const InputDistribution& dist = inputs[i].dist;
+                    const double* src = &u[i * kBlock];
+                    double* dst = (block_in.*(inputs[i].column)).data();
+                    for (std::size_t j = 0; j < n; ++j) {
+                        dst[j] = dist.quantile(src[j]);
+                    }
+                }
+                evaluateBatchRange(block_in, block_out, 0, n, fluid);
+                leaf.acc.add(block_out, 0, n);
+            }
+            detail::pushStatisticsNode(stacks[worker], std::move(leaf));
+        }
+    }, 1);
+
+    // Worker ranges are ascending in worker order: continue the same tree
+    // across them, then fold what is left from the left.
+    std::vector<detail::StatisticsNode> stack;
+    for (std::vector<detail::StatisticsNode>& part : stacks) {
+        for (detail::StatisticsNode& node : part) {
+            detail::pushStatisticsNode(stack, std::move(node));
+        }
+    }
+    StatisticsAccumulator result = empty;
+    for (const detail::StatisticsNode& node : stack) {
+        result.merge(node.acc);
+    }
+    return result;
+}
+
+}  // namespace vc
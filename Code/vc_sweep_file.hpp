@@ -0,0 +1,332 @@
+#pragma once
+// Columnar sweep result files.
+//
+// A sweep file holds one row per design: its sweep index, every design input
+// and every model output, all as doubles. Rows are grouped in chunks of
+// chunk_rows (32768 by default); inside a chunk each column is contiguous, so
+// a scan reads only the columns it tests. The footer holds the column names
+// and a zone map per (chunk, column): min, max and the number of NaN rows,
+// which lets a query skip chunks, or whole predicates on a chunk, without
+// touching the data.
+//
+//   header (64 B) | chunk 0: col 0 .. col C-1 | chunk 1 | ... | names (C x 32 B) | zones (chunks x C x 32 B)
+//
+// Chunks are fixed size (the last is NaN padded), so column k of chunk c is at
+// 64 + (c C + k) chunk_rows 8 bytes. Files are written in host byte order and
+// read through a MappedFile; open() rejects the other endianness.
+//
+// SweepFileWriter takes rows in order and keeps one chunk in memory.
+// writeSweep() enumerates a packed catalog straight into a file.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_mapped_file.hpp"
+#include "vc_model.hpp"
+#include "vc_packed.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+constexpr std::uint32_t kSweepChunkRows = 32768;
+
+struct SweepZone {
+    double min;
+    double max;
+    std::uint64_t nan_rows;
+    std::uint64_t reserved;
+};
+static_assert(sizeof(SweepZone) == 32, "SweepZone is a fixed on-disk layout");
+
+namespace detail {
+
+struct SweepFileHeader {
+    char magic[8];                 // "VCSWEEP\0"
+    std::uint32_t version;
+    std::uint32_t byte_order;      // 0x01020304 as written
+    std::uint32_t column_count;
+    std::uint32_t chunk_rows;
+    std::uint64_t row_count;
+    std::uint64_t chunk_count;
+    std::uint64_t footer_offset;
+    std::uint64_t reserved[2];
+};
+static_assert(sizeof(SweepFileHeader) == 64, "header is a fixed on-disk layout");
+
+constexpr std::uint32_t kSweepFileVersion = 1;
+constexpr std::uint32_t kSweepByteOrderMark = 0x01020304;
+constexpr std::size_t kSweepNameBytes = 32;
+
+// "index", the design inputs, then the model outputs.
+inline std::vector<std::string> sweepColumnNames() {
+    std::vector<std::string> names{"index"};
+#define VC_SWEEP_INPUT_NAME(name, value) names.push_back(#name);
+    VC_DESIGN_FIELDS(VC_SWEEP_INPUT_NAME)
+#undef VC_SWEEP_INPUT_NAME
+#define VC_SWEEP_OUTPUT_NAME(name) names.push_back(#name);
+    VC_OUTPUT_FIELDS(VC_SWEEP_OUTPUT_NAME)
+#undef VC_SWEEP_OUTPUT_NAME
+    return names;
+}
+
+}  // namespace detail
+
+class SweepFileWriter {
+public:
+    explicit SweepFileWriter(const std::string& path, std::uint32_t chunk_rows = kSweepChunkRows)
+        : path_(path), names_(detail::sweepColumnNames()), chunk_rows_(chunk_rows),
+          f_(path, std::ios::binary | std::ios::trunc) {
+        if (chunk_rows == 0) {
+            throw std::invalid_argument("SweepFileWriter: chunk_rows must be positive");
+        }
+        if (!f_) {
+            throw std::runtime_error("SweepFileWriter: cannot create " + path);
+        }
+        chunk_.assign(names_.size() * chunk_rows_, std::numeric_limits<double>::quiet_NaN());
+        const detail::SweepFileHeader placeholder{};
+        f_.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+    }
+
+    ~SweepFileWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    SweepFileWriter(const SweepFileWriter&) = delete;
+    SweepFileWriter& operator=(const SweepFileWriter&) = delete;
+
+    std::uint64_t rows() const { return rows_; }
+
+    // Appends lanes [0, size) of a block; lane j gets sweep index first + j.
+    void append(const DesignBatch<double>& in, const OutputBatch<double>& out, std::uint64_t first) {
+        std::size_t done = 0;
+        const std::size_t n = out.size();
+        while (done < n) {
+            const std::size_t take = std::min<std::size_t>(n - done, chunk_rows_ - fill_);
+            double* dst = chunk_.data() + fill_;
+            for (std::size_t j = 0; j < take; ++j) {
+                dst[j] = static_cast<double>(first + done + j);
+            }
+            std::size_t k = 1;
+#define VC_SWEEP_COPY_INPUT(name, value) \
+            std::copy(in.name.begin() + done, in.name.begin() + done + take, chunk_.data() + k++ * chunk_rows_ + fill_);
+            VC_DESIGN_FIELDS(VC_SWEEP_COPY_INPUT)
+#undef VC_SWEEP_COPY_INPUT
+#define VC_SWEEP_COPY_OUTPUT(name) \
+            std::copy(out.name.begin() + done, out.name.begin() + done + take, chunk_.data() + k++ * chunk_rows_ + fill_);
+            VC_OUTPUT_FIELDS(VC_SWEEP_COPY_OUTPUT)
+#undef VC_SWEEP_COPY_OUTPUT
+            fill_ += take;
+            done += take;
+            rows_ += take;
+            if (fill_ == chunk_rows_) {
+                flushChunk();
+            }
+        }
+    }
+
+    // Writes the last chunk, the footer and the final header.
+    void close() {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        if (fill_ > 0) {
+            flushChunk();
+        }
+        detail::SweepFileHeader h{};
+        std::memcpy(h.magic, "VCSWEEP", 8);
+        h.version = detail::kSweepFileVersion;
+        h.byte_order = detail::kSweepByteOrderMark;
+        h.column_count = static_cast<std::uint32_t>(names_.size());
+        h.chunk_rows = chunk_rows_;
+        h.row_count = rows_;
+        h.chunk_count = chunks_;
+        h.footer_offset = static_cast<std::uint64_t>(f_.tellp());
+        for (const std::string& name : names_) {
+            char buf[detail::kSweepNameBytes] = {};
+            std::strncpy(buf, name.c_str(), sizeof(buf) - 1);
+            f_.write(buf, sizeof(buf));
+        }
+        f_.write(reinterpret_cast<const char*>(zones_.data()), static_cast<std::streamsize>(zones_.size() * sizeof(SweepZone)));
+        f_.seekp(0);
+        f_.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        f_.close();
+        if (!f_) {
+            throw std::runtime_error("SweepFileWriter: cannot write " + path_);
+        }
+    }
+
+private:
+    void flushChunk() {
+        for (std::size_t k = 0; k < names_.size(); ++k) {
+            const double* col = chunk_.data() + k * chunk_rows_;
+            SweepZone z{std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0, 0};
+            for (std::size_t i = 0; i < fill_; ++i) {
+                z.min = col[i] < z.min ? col[i] : z.min;   // NaN compares false and is skipped
+                z.max = col[i] > z.max ? col[i] : z.max;
+                z.nan_rows += col[i] != col[i];
+            }
+            zones_.push_back(z);
+        }
+        f_.write(reinterpret_cast<const char*>(chunk_.data()), static_cast<std::streamsize>(chunk_.size() * sizeof(double)));
+        std::fill(chunk_.begin(), chunk_.end(), std::numeric_limits<double>::quiet_NaN());
+        fill_ = 0;
+        ++chunks_;
+    }
+
+    std::string path_;
+    std::vector<std::string> names_;
+    std::uint32_t chunk_rows_;
+    std::ofstream f_;
+    std::vector<double> chunk_;      // column k at k * chunk_rows_
+    std::vector<SweepZone> zones_;   // chunks_ x columns
+    std::size_t fill_ = 0;
+    std::uint64_t rows_ = 0;
+    std::uint64_t chunks_ = 0;
+    bool closed_ = false;
+};
+
+class SweepFile {
+public:
+    SweepFile() = default;
+    explicit SweepFile(const std::string& path) { open(path); }
+
+    void open(const std::string& path) {
+        file_.open(path);
+        detail::SweepFileHeader h{};
+        if (file_.size() >= sizeof(h)) {
+            std::memcpy(&h, file_.data(), sizeof(h));
+        }
+        const auto fail = [&] {
+            file_.close();
+            throw std::runtime_error("SweepFile: " + path + " is not a compatible sweep file");
+        };
+        if (file_.size() < sizeof(h) || std::memcmp(h.magic, "VCSWEEP", 8) != 0 || h.version != detail::kSweepFileVersion ||
+            h.byte_order != detail::kSweepByteOrderMark || h.chunk_rows == 0 ||
+            h.chunk_count != (h.row_count + h.chunk_rows - 1) / h.chunk_rows) {
+            fail();
+        }
+        const std::uint64_t data_bytes = h.chunk_count * h.column_count * h.chunk_rows * sizeof(double);
+        const std::uint64_t footer_bytes =
+            h.column_count * detail::kSweepNameBytes + h.chunk_count * h.column_count * sizeof(SweepZone);
+        if (h.footer_offset != sizeof(h) + data_bytes || file_.size() < h.footer_offset + footer_bytes) {
+            fail();
+        }
+        header_ = h;
+        names_.clear();
+        const char* names = file_.data() + h.footer_offset;
+        for (std::uint32_t k = 0; k < h.column_count; ++k) {
+            const char* p = names + k * detail::kSweepNameBytes;
+            names_.emplace_back(p, std::find(p, p + detail::kSweepNameBytes, '\0'));
+        }
+        zones_ = reinterpret_cast<const SweepZone*>(names + h.column_count * detail::kSweepNameBytes);
+        data_ = reinterpret_cast<const double*>(file_.data() + sizeof(h));
+        input_columns_.clear();
+        output_columns_.clear();
+#define VC_SWEEP_FIND_INPUT(name, value) input_columns_.push_back(columnIndex(#name));
+        VC_DESIGN_FIELDS(VC_SWEEP_FIND_INPUT)
+#undef VC_SWEEP_FIND_INPUT
+#define VC_SWEEP_FIND_OUTPUT(name) output_columns_.push_back(columnIndex(#name));
+        VC_OUTPUT_FIELDS(VC_SWEEP_FIND_OUTPUT)
+#undef VC_SWEEP_FIND_OUTPUT
+    }
+
+    std::uint64_t rows() const { return header_.row_count; }
+    std::size_t columnCount() const { return names_.size(); }
+    std::size_t chunkCount() const { return static_cast<std::size_t>(header_.chunk_count); }
+    std::size_t chunkRows() const { return header_.chunk_rows; }
+    const std::string& columnName(std::size_t k) const { return names_[k]; }
+
+    std::size_t columnIndex(const std::string& name) const {
+        for (std::size_t k = 0; k < names_.size(); ++k) {
+            if (names_[k] == name) {
+                return k;
+            }
+        }
+        throw std::invalid_argument("SweepFile: no column " + name);
+    }
+
+    // Rows of chunk c that hold data (the last chunk may be partial).
+    std::size_t rowsInChunk(std::size_t c) const {
+        return static_cast<std::size_t>(std::min<std::uint64_t>(header_.chunk_rows, rows() - c * header_.chunk_rows));
+    }
+
+    const double* column(std::size_t c, std::size_t k) const {
+        return data_ + (c * names_.size() + k) * header_.chunk_rows;
+    }
+
+    const SweepZone& zone(std::size_t c, std::size_t k) const { return zones_[c * names_.size() + k]; }
+
+    double value(std::uint64_t row, std::size_t k) const {
+        return column(static_cast<std::size_t>(row / header_.chunk_rows), k)[row % header_.chunk_rows];
+    }
+
+    DesignInputs<double> design(std::uint64_t row) const {
+        DesignInputs<double> d;
+        std::size_t i = 0;
+#define VC_SWEEP_READ_INPUT(name, default_value) d.name = value(row, input_columns_[i++]);
+        VC_DESIGN_FIELDS(VC_SWEEP_READ_INPUT)
+#undef VC_SWEEP_READ_INPUT
+        return d;
+    }
+
+    ModelOutputs<double> outputs(std::uint64_t row) const {
+        ModelOutputs<double> o;
+        std::size_t i = 0;
+#define VC_SWEEP_READ_OUTPUT(name) o.name = value(row, output_columns_[i++]);
+        VC_OUTPUT_FIELDS(VC_SWEEP_READ_OUTPUT)
+#undef VC_SWEEP_READ_OUTPUT
+        return o;
+    }
+
+private:
+    MappedFile file_;
+    detail::SweepFileHeader header_{};
+    std::vector<std::string> names_;
+    const SweepZone* zones_ = nullptr;
+    const double* data_ = nullptr;
+    std::vector<std::size_t> input_columns_;
+    std::vector<std::size_t> output_columns_;
+};
+
+// Evaluates catalog entries [begin, end) into a sweep file. Rows are in index
+// order; a slab of one chunk per worker is evaluated in parallel and then
+// appended, so memory stays at a few chunks.
+inline std::uint64_t writeSweep(const DesignCodebook& codebook, std::uint64_t begin, std::uint64_t end,
+                                const std::string& path, const FluidProperties& fluid = FluidProperties{},
+                                std::uint32_t chunk_rows = kSweepChunkRows) {
+    SweepFileWriter writer(path, chunk_rows);
+    const std::uint64_t slab = static_cast<std::uint64_t>(chunk_rows) * workerCount();
+    DesignBatch<double> slab_in;
+    OutputBatch<double> slab_out;
+    for (std::uint64_t s0 = begin; s0 < end; s0 += slab) {
+        const std::uint64_t s1 = std::min(end, s0 + slab);
+        slab_in.resize(static_cast<std::size_t>(s1 - s0));
+        slab_out.resize(static_cast<std::size_t>(s1 - s0));
+        enumerateCatalog(
+            codebook, s0, s1,
+            [&](const DesignBatch<double>& in, const OutputBatch<double>& out, std::uint64_t first, unsigned) {
+                for (std::size_t j = 0; j < out.size(); ++j) {
+                    slab_in.set(static_cast<std::size_t>(first - s0) + j, in.get(j));
+                    slab_out.set(static_cast<std::size_t>(first - s0) + j, out.get(j));
+                }
+            },
+            fluid);
+        writer.append(slab_in, slab_out, s0);
+    }
+    writer.close();
+    return writer.rows();
+}
+
+}  // namespace vc
@@ -0,0 +1,236 @@
+#pragma once
+// Lumped-capacitance transient model for power-step testing.
+//
+// Five thermal masses in series between the heater and the coolant:
+//
+//   heater -> [evap wall] -> [evap wick + liquid] -> [vapor] -> [cond wick + liquid] -> [cond wall] -> coolant
+//
+// Each link is the half-resistances of the two nodes it joins (wall, wick,
+// phase change and spreading terms from the steady model), all scaled by
+// experimental_correction_factor so the steady state reproduces
+// delta_T = Q_in * R_total_corrected. The liquid charge
+// (liquid_charge_volume_mL) is split between the wicks by pore volume.
+//
+// Integration is backward Euler. The 5x5 tridiagonal system is factored once
+// per time step size, then every step is a forward/back substitution run
+// node by node across all lanes (structure of arrays), so thousands of
+// designs or power profiles advance together.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+// Shell material (C11000 copper) and fluid heat capacities
+struct ThermalMassProperties {
+    double rho_shell = 8940;   // [kg/m^3]
+    double c_shell = 385;      // [J/kg-K]
+    double c_l = 4190;         // Liquid water at T_op [J/kg-K]
+    double c_v = 2010;         // Water vapor at T_op [J/kg-K]
+};
+
+class TransientBatch {
+public:
+    static constexpr int kNodes = 5;
+    enum Node { EvapWall = 0, EvapWick = 1, Vapor = 2, CondWick = 3, CondWall = 4 };
+
+    TransientBatch(const DesignBatch<double>& in, const OutputBatch<double>& out,
+                   const FluidProperties& fluid = FluidProperties{},
+                   const ThermalMassProperties& mass = ThermalMassProperties{})
+        : lanes_(in.size()),
+          C_(kNodes * lanes_),
+          G_(kNodes * lanes_),
+          R_heater_(lanes_),
+          T_(kNodes * lanes_, 0.0) {
+        for (std::size_t i = 0; i < lanes_; ++i) {
+            const double area = in.vc_length[i] * in.vc_width[i];
+            const double shell = mass.rho_shell * mass.c_shell;
+            const double pore_evap = area * out.t_evap_wick[i] * out.epsilon_evap[i];
+            const double pore_cond = area * out.t_cond_wick[i] * out.epsilon_cond[i];
+            const double m_liquid = out.liquid_charge_volume_mL[i] * 1e-6 * fluid.rho_l;
+            const double liquid_evap = m_liquid * pore_evap / (pore_evap + pore_cond);
+            const double liquid_cond = m_liquid - liquid_evap;
+
+            // --- Thermal Masses [J/K] ---
+            C_[at(EvapWall, i)] = shell * area * in.t_evap_wall[i];
+            C_[at(EvapWick, i)] = shell * area * out.t_evap_wick[i] * (1 - out.epsilon_evap[i]) + liquid_evap * mass.c_l;
+            C_[at(Vapor, i)] = fluid.rho_v * area * in.t_vapor[i] * mass.c_v;
+            C_[at(CondWick, i)] = shell * area * out.t_cond_wick[i] * (1 - out.epsilon_cond[i]) + liquid_cond * mass.c_l;
+            C_[at(CondWall, i)] = shell * area * in.t_cond_wall[i];
+
+            // --- Link Conductances [W/K]: G[k] joins node k to node k+1, G[4] joins the cond wall to coolant ---
+            const double f = in.experimental_correction_factor[i];
+            const double R_ew = out.R_evap_wall[i] + out.R_evap_spreading[i];
+            const double R_ek = out.R_evap_wick[i];
+            const double R_pc = in.R_phase_change[i];
+            const double R_ck = out.R_cond_wick[i];
+            const double R_cw = out.R_cond_wall[i] + out.R_cond_spreading[i];
+            R_heater_[i] = f * R_ew / 2;
+            G_[at(EvapWall, i)] = 1 / (f * (R_ew / 2 + R_ek / 2));
+            G_[at(EvapWick, i)] = 1 / (f * (R_ek / 2 + R_pc / 2));
+            G_[at(Vapor, i)] = 1 / (f * (R_pc / 2 + R_ck / 2));
+            G_[at(CondWick, i)] = 1 / (f * (R_ck / 2 + R_cw / 2));
+            G_[at(CondWall, i)] = 1 / (f * (R_cw / 2));
+        }
+    }
+
+    std::size_t size() const { return lanes_; }
+    double time() const { return time_; }
+
+    // Node temperature rise above the coolant [K]
+    double nodeRise(int node, std::size_t lane) const { return T_[at(node, lane)]; }
+
+    // Heater surface rise above the coolant for the power last applied [K]
+    double heaterRise(std::size_t lane) const { return T_[at(EvapWall, lane)] + last_Q_[lane] * R_heater_[lane]; }
+
+    // Steady-state heater rise for heat load Q [K]; equals Q * R_total_corrected
+    double steadyRise(std::size_t lane, double Q) const {
+        double R = R_heater_[lane];
+        for (int k = 0; k < kNodes; ++k) {
+            R += 1 / G_[at(k, lane)];
+        }
+        return Q * R;
+    }
+
+    // Starts every lane at the steady state for Q[lane].
+    void setSteadyState(const std::vector<double>& Q) {
+        last_Q_ = Q;
+        for (std::size_t i = 0; i < lanes_; ++i) {
+            double rise = 0;
+            for (int k = kNodes - 1; k >= 0; --k) {
+                rise += Q[i] / G_[at(k, i)];
+                T_[at(k, i)] = rise;
+            }
+        }
+    }
+
+    // One backward-Euler step with heater power Q[lane] held over dt.
+    void step(const std::vector<double>& Q, double dt) {
+        if (dt != factored_dt_) {
+            factor(dt);
+        }
+        last_Q_ = Q;
+        parallelFor(
+            lanes_,
+            [&](std::size_t begin, std::size_t end, unsigned) {
+                // Forward substitution: d'_k = (C_k/dt T_k + s_k + G_{k-1} d'_{k-1}) * inv_pivot_k
+                for (int k = 0; k < kNodes; ++k) {
+                    double* T = &T_[at(k, 0)];
+                    const double* C = &C_[at(k, 0)];
+                    const double* inv = &inv_pivot_[at(k, 0)];
+                    if (k == 0) {
+                        for (std::size_t i = begin; i < end; ++i) {
+                            T[i] = (C[i] / dt * T[i] + Q[i]) * inv[i];
+                        }
+                    } else {
+                        const double* Tp = &T_[at(k - 1, 0)];
+                        const double* Gp = &G_[at(k - 1, 0)];
+                        for (std::size_t i = begin; i < end; ++i) {
+                            T[i] = (C[i] / dt * T[i] + Gp[i] * Tp[i]) * inv[i];
+                        }
+                    }
+                }
+                // Back substitution: T_k = d'_k + c'_k T_{k+1}
+                for (int k = kNodes - 2; k >= 0; --k) {
+                    double* T = &T_[at(k, 0)];
+                    const double* Tn = &T_[at(k + 1, 0)];
+                    const double* cp = &upper_[at(k, 0)];
+                    for (std::size_t i = begin; i < end; ++i) {
+                        T[i] += cp[i] * Tn[i];
+                    }
+                }
+            },
+            1024);
+        time_ += dt;
+    }
+
+private:
+    std::size_t at(int node, std::size_t lane) const { return static_cast<std::size_t>(node) * lanes_ + lane; }
+
+    // Thomas factorization of (C/dt + G) for all lanes:
+    // row k: -G_{k-1} T_{k-1} + (C_k/dt + G_{k-1} + G_k) T_k - G_k T_{k+1}
+    void factor(double dt) {
+        inv_pivot_.resize(kNodes * lanes_);
+        upper_.resize(kNodes * lanes_);
+        for (std::size_t i = 0; i < lanes_; ++i) {
+            double prev_upper = 0;
+            for (int k = 0; k < kNodes; ++k) {
+                const double g_left = k > 0 ? G_[at(k - 1, i)] : 0;
+                const double g_right = G_[at(k, i)];
+                const double pivot = C_[at(k, i)] / dt + g_left + g_right - g_left * prev_upper;
+                inv_pivot_[at(k, i)] = 1 / pivot;
+                // The coolant link of the last node is a sink, not a coupling
+                upper_[at(k, i)] = k + 1 < kNodes ? g_right / pivot : 0;
+                prev_upper = upper_[at(k, i)];
+            }
+        }
+        factored_dt_ = dt;
+    }
+
+    std::size_t lanes_;
+    std::vector<double> C_;
+    std::vector<double> G_;
+    std::vector<double> R_heater_;
+    std::vector<double> T_;
+    std::vector<double> last_Q_ = std::vector<double>(lanes_, 0.0);
+    std::vector<double> inv_pivot_;
+    std::vector<double> upper_;
+    double factored_dt_ = 0;
+    double time_ = 0;
+};
+
+// --- Power-step test simulation ---
+struct StepTestProfile {
+    double Q_start = 0;         // Initial steady heater power [W]
+    double Q_step = 10;         // Increment per step [W] (README procedure)
+    int steps = 15;
+    double dt = 0.5;            // Time step [s]
+    double settle_band = 0.1;   // Settled when within this of the step's steady heater rise [K]
+    double max_hold = 3600;     // Give up on a step after this long [s]
+};
+
+struct StepTestResult {
+    std::vector<double> settle_time;   // [lane * steps + step] time to enter the settle band [s]
+    std::vector<double> total_time;    // [lane] sum of settle times over the ladder [s]
+};
+
+// Runs every lane through the same heater power ladder. Each step is held until
+// every lane has settled (or max_hold), recording per-lane settling times.
+inline StepTestResult simulateStepTest(TransientBatch& batch, const StepTestProfile& profile) {
+    const std::size_t lanes = batch.size();
+    StepTestResult res;
+    res.settle_time.assign(lanes * profile.steps, profile.max_hold);
+    res.total_time.assign(lanes, 0.0);
+    std::vector<double> Q(lanes, profile.Q_start);
+    batch.setSteadyState(Q);
+    for (int s = 0; s < profile.steps; ++s) {
+        const double Q_now = profile.Q_start + (s + 1) * profile.Q_step;
+        std::fill(Q.begin(), Q.end(), Q_now);
+        std::vector<char> settled(lanes, 0);
+        std::size_t remaining = lanes;
+        double t = 0;
+        while (remaining > 0 && t < profile.max_hold) {
+            batch.step(Q, profile.dt);
+            t += profile.dt;
+            for (std::size_t i = 0; i < lanes; ++i) {
+                if (!settled[i] && std::fabs(batch.heaterRise(i) - batch.steadyRise(i, Q_now)) <= profile.settle_band) {
+                    settled[i] = 1;
+                    --remaining;
+                    res.settle_time[i * profile.steps + s] = t;
+                }
+            }
+        }
+        for (std::size_t i = 0; i < lanes; ++i) {
+            res.total_time[i] += res.settle_time[i * profile.steps + s];
+        }
+    }
+    return res;
+}
+
+}  // namespace vc
@@ -0,0 +1,148 @@
+#pragma once
+// Per-lane validity masks for batch evaluation.
+//
+// The model does not reject impossible designs: a coarse mesh of thick wire
+// gives epsilon <= 0, and K / k_wick then go negative, infinite or NaN, and a
+// wick stack taller than the internal gap goes through unnoticed. In a batch
+// we do not want a branch per lane, so each lane gets a bitmask of the checks
+// it fails, computed with comparisons only (0 = valid). Masks can then drive
+// stream compaction of the batch or pruning of an optimizer population.
+//
+// The design inputs carry no enclosure height, so ValidityLimits has no
+// default: the internal gap is given directly, or taken from the stack of a
+// reference design with ValidityLimits::fromDesign.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+enum ValidityFlag : std::uint8_t {
+    kPorosityEvap = 1 << 0,       // epsilon_evap outside (0, 1)
+    kPorosityCond = 1 << 1,       // epsilon_cond outside (0, 1)
+    kStackFit = 1 << 2,           // t_vapor <= 0, or wicks + vapor space exceed the internal gap
+    kNoCapillaryLimit = 1 << 3,   // Q_max <= 0
+    kNonFinite = 1 << 4,          // NaN / inf in Q_max, permeabilities or resistances
+};
+
+struct ValidityLimits {
+    // Internal height between the walls available for t_evap_wick + t_cond_wick + t_vapor [m].
+    double internal_gap;
+
+    explicit ValidityLimits(double gap) : internal_gap(gap) {}
+
+    // The gap a reference design fills: its two screen stacks plus its vapor space.
+    static ValidityLimits fromDesign(const DesignInputs<double>& reference) {
+        return ValidityLimits(2 * reference.d_w_evap * reference.num_layers_evap +
+                              2 * reference.d_w_cond * reference.num_layers_cond + reference.t_vapor);
+    }
+};
+
+namespace detail {
+
+inline std::uint8_t laneValidity(double epsilon_evap, double epsilon_cond, double t_vapor, double stack, double Q_max,
+                                 double K_evap, double K_cond, double R_total_corrected, double internal_gap) {
+    const double inf = std::numeric_limits<double>::infinity();
+    // fabs(x) < inf is false for both NaN and +-inf
+    const bool finite = std::fabs(Q_max) < inf && std::fabs(K_evap) < inf && std::fabs(K_cond) < inf &&
+                        std::fabs(R_total_corrected) < inf;
+    return static_cast<std::uint8_t>((!(epsilon_evap > 0 && epsilon_evap < 1)) * kPorosityEvap |
+                                     (!(epsilon_cond > 0 && epsilon_cond < 1)) * kPorosityCond |
+                                     (!(t_vapor > 0 && stack <= internal_gap)) * kStackFit |
+                                     (!(Q_max > 0)) * kNoCapillaryLimit |
+                                     (!finite) * kNonFinite);
+}
+
+}  // namespace detail
+
+inline std::uint8_t validityMask(const DesignInputs<double>& in, const ModelOutputs<double>& out,
+                                 const ValidityLimits& limits) {
+    return detail::laneValidity(out.epsilon_evap, out.epsilon_cond, in.t_vapor,
+                                out.t_evap_wick + out.t_cond_wick + in.t_vapor, out.Q_max, out.K_evap, out.K_cond,
+                                out.R_total_corrected, limits.internal_gap);
+}
+
+// Masks for lanes [begin, end), reading the columns directly.
+inline void validityMaskRange(const DesignBatch<double>& in, const OutputBatch<double>& out,
+                              std::vector<std::uint8_t>& masks, std::size_t begin, std::size_t end,
+                              const ValidityLimits& limits) {
+    for (std::size_t i = begin; i < end; ++i) {
+        masks[i] = detail::laneValidity(out.epsilon_evap[i], out.epsilon_cond[i], in.t_vapor[i],
+                                        out.t_evap_wick[i] + out.t_cond_wick[i] + in.t_vapor[i], out.Q_max[i],
+                                        out.K_evap[i], out.K_cond[i], out.R_total_corrected[i], limits.internal_gap);
+    }
+}
+
+// evaluateBatch plus the masks, computed in the same pass over each chunk.
+inline void evaluateBatchWithValidity(const DesignBatch<double>& in, OutputBatch<double>& out,
+                                      std::vector<std::uint8_t>& masks, const ValidityLimits& limits,
+                                      const FluidProperties& fluid = FluidProperties{}) {
+    out.resize(in.size());
+    masks.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        evaluateBatchRange(in, out, begin, end, fluid);
+        validityMaskRange(in, out, masks, begin, end, limits);
+    });
+}
+
+// Indices of lanes whose mask has none of the `reject` bits set, in order.
+// Branch-free: every lane is written, the cursor only advances on a keep.
+inline std::size_t validLaneIndices(const std::vector<std::uint8_t>& masks, std::vector<std::uint32_t>& indices,
+                                    std::uint8_t reject = 0xFF) {
+    indices.resize(masks.size());
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        indices[n] = static_cast<std::uint32_t>(i);
+        n += (masks[i] & reject) == 0;
+    }
+    indices.resize(n);
+    return n;
+}
+
+namespace detail {
+
+template <class T>
+void gatherColumn(std::vector<T>& col, const std::vector<std::uint32_t>& indices) {
+    // indices are increasing, so an in-place forward gather is safe
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        col[k] = col[indices[k]];
+    }
+    col.resize(indices.size());
+}
+
+}  // namespace detail
+
+// Keeps only the listed lanes (from validLaneIndices), column by column.
+template <class T>
+void compactBatch(DesignBatch<T>& batch, const std::vector<std::uint32_t>& indices) {
+#define VC_COMPACT_INPUT_COLUMN(name, value) detail::gatherColumn(batch.name, indices);
+    VC_DESIGN_FIELDS(VC_COMPACT_INPUT_COLUMN)
+#undef VC_COMPACT_INPUT_COLUMN
+}
+
+template <class T>
+void compactBatch(OutputBatch<T>& batch, const std::vector<std::uint32_t>& indices) {
+#define VC_COMPACT_OUTPUT_COLUMN(name) detail::gatherColumn(batch.name, indices);
+    VC_OUTPUT_FIELDS(VC_COMPACT_OUTPUT_COLUMN)
+#undef VC_COMPACT_OUTPUT_COLUMN
+}
+
+// Drops rejected lanes from a population and its outputs together; returns the survivors.
+inline std::size_t pruneInvalid(DesignBatch<double>& population, OutputBatch<double>& out,
+                                std::vector<std::uint8_t>& masks, std::uint8_t reject = 0xFF) {
+    std::vector<std::uint32_t> keep;
+    const std::size_t n = validLaneIndices(masks, keep, reject);
+    compactBatch(population, keep);
+    compactBatch(out, keep);
+    detail::gatherColumn(masks, keep);
+    return n;
+}
+
+}  // namespace vc
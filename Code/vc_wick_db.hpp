@@ -0,0 +1,366 @@
+#pragma once
+// Binary wick characterization database, memory-mapped read-only.
+//
+// The file is a small header followed by fixed 160-byte records, one per
+// 16-bit wick ID (record i is wick i; unused IDs are empty records). Each
+// record holds the catalog spec, the analytic values (thickness, porosity,
+// permeability, capillary radius, conductivity) and optional measured or
+// pore-scale overrides, selected per property by a bit mask. A lookup is one
+// index into the mapping, and processes opening the same file share its pages.
+//
+// Two properties depend on design inputs and are finished when the model runs,
+// unless overridden:
+//
+//   permeability   Screen records use Kozeny-Carman with the design's
+//                  kozeny_carman_constant; their analytic K is at the
+//                  default 122, for listing only.
+//   conductivity   Per record, by WickConductivity: the Maxwell screen form
+//                  of vc_model.hpp or Chi's sintered-sphere form, from the
+//                  porosity and k_shell, or the stored analytic value.
+//
+// WickDesignBatch carries the two wick IDs per lane in place of the six
+// screen columns of a DesignBatch.
+//
+// Files are written in host byte order; the header records it, and open()
+// rejects files from a host of the other endianness.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vc_batch.hpp"
+#include "vc_mapped_file.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+#include "vc_pore_scale.hpp"
+#include "vc_wick_types.hpp"
+
+namespace vc {
+
+enum WickProperty : int {
+    kWickThickness = 0,    // [m]
+    kWickPorosity = 1,
+    kWickPermeability = 2, // [m^2]
+    kWickCapillaryRadius = 3,   // [m]
+    kWickConductivity = 4, // [W/m-K]
+    kWickPropertyCount = 5,
+};
+
+enum class WickKind : std::uint8_t { Empty = 0, Screen = 1, Measured = 2, SinteredPowder = 3 };
+
+// How k_wick follows from a record when it is not overridden.
+enum class WickConductivity : std::uint8_t {
+    Screen = 0,           // effectiveWickConductivity(porosity, k_shell, k_l)
+    SinteredPowder = 1,   // sinteredWickConductivity(porosity, k_shell, k_l)
+    Stored = 2,           // analytic[kWickConductivity]
+};
+
+struct WickRecord {
+    std::uint16_t id = 0;
+    WickKind kind = WickKind::Empty;
+    std::uint8_t override_mask = 0;   // Bit p set: measured[p] replaces analytic[p]
+    WickConductivity conductivity_model = WickConductivity::Screen;
+    std::uint8_t reserved0[3] = {};
+    char name[24] = {};
+    double mesh_number_wpi = 0;       // Screen spec (0 for non-screen entries)
+    double d_w = 0;
+    double num_layers = 0;
+    double analytic[kWickPropertyCount] = {};
+    double measured[kWickPropertyCount] = {};
+    double reserved1[3] = {};
+
+    bool overridden(WickProperty p) const { return override_mask >> p & 1; }
+    double value(WickProperty p) const { return overridden(p) ? measured[p] : analytic[p]; }
+
+    void setMeasured(WickProperty p, double v) {
+        measured[p] = v;
+        override_mask = static_cast<std::uint8_t>(override_mask | 1u << p);
+    }
+
+    // K for a design's Kozeny-Carman constant.
+    double permeability(double kozeny_carman_constant) const {
+        if (kind != WickKind::Screen || overridden(kWickPermeability)) {
+            return value(kWickPermeability);
+        }
+        return screenPermeability(d_w, value(kWickPorosity), kozeny_carman_constant);
+    }
+
+    // k_wick for a design's shell conductivity.
+    double conductivity(double k_shell, double k_l) const {
+        if (overridden(kWickConductivity)) {
+            return measured[kWickConductivity];
+        }
+        switch (conductivity_model) {
+            case WickConductivity::Screen:
+                return effectiveWickConductivity(value(kWickPorosity), k_shell, k_l);
+            case WickConductivity::SinteredPowder:
+                return sinteredWickConductivity(value(kWickPorosity), k_shell, k_l);
+            case WickConductivity::Stored:
+                break;
+        }
+        return analytic[kWickConductivity];
+    }
+};
+static_assert(sizeof(WickRecord) == 160, "WickRecord is a fixed on-disk layout");
+static_assert(std::is_trivially_copyable<WickRecord>::value, "WickRecord is copied byte-wise");
+
+namespace detail {
+
+struct WickDatabaseHeader {
+    char magic[8];                // "VCWICKDB"
+    std::uint32_t version;
+    std::uint32_t byte_order;     // 0x01020304 as written
+    std::uint32_t record_size;
+    std::uint32_t count;          // Records, = highest ID + 1
+    std::uint64_t reserved;
+};
+static_assert(sizeof(WickDatabaseHeader) == 32, "header is a fixed on-disk layout");
+
+constexpr std::uint32_t kWickDatabaseVersion = 2;
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+
+}  // namespace detail
+
+// Screen-mesh entry with the correlations of vc_model.hpp.
+inline WickRecord screenWickRecord(std::uint16_t id, const std::string& name, double mesh_number_wpi, double d_w,
+                                   double num_layers) {
+    WickRecord r;
+    r.id = id;
+    r.kind = WickKind::Screen;
+    std::strncpy(r.name, name.c_str(), sizeof(r.name) - 1);
+    r.mesh_number_wpi = mesh_number_wpi;
+    r.d_w = d_w;
+    r.num_layers = num_layers;
+    const double mesh_number = mesh_number_wpi / 0.0254;
+    const double epsilon = screenPorosity(mesh_number, d_w);
+    r.analytic[kWickThickness] = 2 * d_w * num_layers;
+    r.analytic[kWickPorosity] = epsilon;
+    r.analytic[kWickPermeability] = screenPermeability(d_w, epsilon, DesignInputs<double>{}.kozeny_carman_constant);
+    r.analytic[kWickCapillaryRadius] = 1 / (2 * mesh_number);
+    r.conductivity_model = WickConductivity::Screen;
+    return r;
+}
+
+// Sintered-powder entry with the correlations of SinteredPowderWick.
+inline WickRecord sinteredPowderWickRecord(std::uint16_t id, const std::string& name, const SinteredPowderWick& powder) {
+    const WickProperties<double> p =
+        powder.properties(DesignInputs<double>{}, ScreenSpec<double>{}, FluidProperties{}.k_l);
+    WickRecord r;
+    r.id = id;
+    r.kind = WickKind::SinteredPowder;
+    std::strncpy(r.name, name.c_str(), sizeof(r.name) - 1);
+    r.analytic[kWickThickness] = p.thickness;
+    r.analytic[kWickPorosity] = p.porosity;
+    r.analytic[kWickPermeability] = p.permeability;
+    r.analytic[kWickCapillaryRadius] = p.capillary_radius;
+    r.conductivity_model = WickConductivity::SinteredPowder;
+    return r;
+}
+
+// Pore-scale K and rc_eff (vc_pore_scale.hpp) as overrides.
+inline void applyPoreScale(WickRecord& r, const PoreScaleResult& p) {
+    r.setMeasured(kWickPermeability, p.K);
+    r.setMeasured(kWickCapillaryRadius, p.rc_eff);
+}
+
+// Writes records at their IDs; missing IDs become empty records.
+inline void writeWickDatabase(const std::string& path, const std::vector<WickRecord>& records) {
+    std::uint32_t count = 0;
+    for (const WickRecord& r : records) {
+        count = std::max<std::uint32_t>(count, r.id + 1u);
+    }
+    std::vector<WickRecord> table(count);
+    std::vector<char> seen(count, 0);
+    for (const WickRecord& r : records) {
+        if (seen[r.id]) {
+            throw std::invalid_argument("writeWickDatabase: duplicate wick ID " + std::to_string(r.id));
+        }
+        seen[r.id] = 1;
+        table[r.id] = r;
+    }
+    for (std::uint32_t i = 0; i < count; ++i) {
+        table[i].id = static_cast<std::uint16_t>(i);
+    }
+    detail::WickDatabaseHeader h{};
+    std::memcpy(h.magic, "VCWICKDB", 8);
+    h.version = detail::kWickDatabaseVersion;
+    h.byte_order = detail::kByteOrderMark;
+    h.record_size = sizeof(WickRecord);
+    h.count = count;
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(count * sizeof(WickRecord)));
+    if (!f) {
+        throw std::runtime_error("writeWickDatabase: cannot write " + path);
+    }
+}
+
+class WickDatabase {
+public:
+    WickDatabase() = default;
+    explicit WickDatabase(const std::string& path) { open(path); }
+    WickDatabase(WickDatabase&& other) noexcept { *this = std::move(other); }
+    WickDatabase& operator=(WickDatabase&& other) noexcept {
+        if (this != &other) {
+            file_ = std::move(other.file_);
+            records_ = std::exchange(other.records_, nullptr);
+            count_ = std::exchange(other.count_, 0);
+        }
+        return *this;
+    }
+
+    void open(const std::string& path) {
+        close();
+        file_.open(path);
+        detail::WickDatabaseHeader h{};
+        if (file_.size() >= sizeof(h)) {
+            std::memcpy(&h, file_.data(), sizeof(h));
+        }
+        if (file_.size() < sizeof(h) || std::memcmp(h.magic, "VCWICKDB", 8) != 0 ||
+            h.version != detail::kWickDatabaseVersion || h.byte_order != detail::kByteOrderMark ||
+            h.record_size != sizeof(WickRecord) ||
+            file_.size() < sizeof(h) + static_cast<std::size_t>(h.count) * sizeof(WickRecord)) {
+            close();
+            throw std::runtime_error("WickDatabase: " + path + " is not a compatible wick database");
+        }
+        // The header is 32 bytes and mappings are page aligned, so records are 8-byte aligned
+        records_ = reinterpret_cast<const WickRecord*>(file_.data() + sizeof(h));
+        count_ = h.count;
+    }
+
+    void close() {
+        file_.close();
+        records_ = nullptr;
+        count_ = 0;
+    }
+
+    std::size_t size() const { return count_; }
+    bool contains(std::uint16_t id) const { return id < count_ && records_[id].kind != WickKind::Empty; }
+
+    const WickRecord& operator[](std::uint16_t id) const { return records_[id]; }
+
+    const WickRecord& at(std::uint16_t id) const {
+        if (!contains(id)) {
+            throw std::out_of_range("WickDatabase: no wick with ID " + std::to_string(id));
+        }
+        return records_[id];
+    }
+
+    // ID of the first record with this name.
+    std::uint16_t find(const std::string& name) const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (records_[i].kind != WickKind::Empty && std::strncmp(records_[i].name, name.c_str(), sizeof(records_[i].name)) == 0) {
+                return static_cast<std::uint16_t>(i);
+            }
+        }
+        throw std::out_of_range("WickDatabase: no wick named " + name);
+    }
+
+private:
+    MappedFile file_;
+    const WickRecord* records_ = nullptr;
+    std::size_t count_ = 0;
+};
+
+// Model with both wicks taken from database records; the mesh / wire / layer
+// inputs of `in` are ignored.
+inline ModelOutputs<double> evaluateModel(const DesignInputs<double>& in, const WickRecord& evap, const WickRecord& cond,
+                                          const FluidProperties& fluid = FluidProperties{}) {
+    ModelOutputs<double> out;
+    out.t_evap_wick = evap.value(kWickThickness);
+    out.t_cond_wick = cond.value(kWickThickness);
+    out.epsilon_evap = evap.value(kWickPorosity);
+    out.epsilon_cond = cond.value(kWickPorosity);
+    out.rc_eff = evap.value(kWickCapillaryRadius);
+    out.K_evap = evap.permeability(in.kozeny_carman_constant);
+    out.K_cond = cond.permeability(in.kozeny_carman_constant);
+    evaluateCapillaryLimit(in, out, fluid);
+    out.k_wick_evap = evap.conductivity(in.k_shell, fluid.k_l);
+    out.k_wick_cond = cond.conductivity(in.k_shell, fluid.k_l);
+    evaluateResistanceNetwork(in, out);
+    return out;
+}
+
+// Designs whose wicks are database IDs: the chamber and parameter columns of
+// DesignBatch plus two 16-bit IDs per lane, instead of the six screen columns.
+struct WickDesignBatch {
+#define VC_DECLARE_WICK_DESIGN_COLUMN(name, value) std::vector<double> name;
+    VC_CHAMBER_FIELDS(VC_DECLARE_WICK_DESIGN_COLUMN)
+    VC_PARAMETER_FIELDS(VC_DECLARE_WICK_DESIGN_COLUMN)
+#undef VC_DECLARE_WICK_DESIGN_COLUMN
+    std::vector<std::uint16_t> evap_wick;
+    std::vector<std::uint16_t> cond_wick;
+
+    std::size_t size() const { return Q_in.size(); }
+
+    void push_back(const DesignInputs<double>& d, std::uint16_t evap, std::uint16_t cond) {
+#define VC_PUSH_WICK_DESIGN_COLUMN(name, value) name.push_back(d.name);
+        VC_CHAMBER_FIELDS(VC_PUSH_WICK_DESIGN_COLUMN)
+        VC_PARAMETER_FIELDS(VC_PUSH_WICK_DESIGN_COLUMN)
+#undef VC_PUSH_WICK_DESIGN_COLUMN
+        evap_wick.push_back(evap);
+        cond_wick.push_back(cond);
+    }
+
+    // Inputs of lane i; the screen fields keep their defaults (the IDs replace them).
+    DesignInputs<double> get(std::size_t i) const {
+        DesignInputs<double> d;
+#define VC_GET_WICK_DESIGN_COLUMN(name, value) d.name = name[i];
+        VC_CHAMBER_FIELDS(VC_GET_WICK_DESIGN_COLUMN)
+        VC_PARAMETER_FIELDS(VC_GET_WICK_DESIGN_COLUMN)
+#undef VC_GET_WICK_DESIGN_COLUMN
+        return d;
+    }
+};
+
+namespace detail {
+
+// Checks IDs up front so worker threads never throw.
+inline void checkWickIds(const std::vector<std::uint16_t>& evap_wick, const std::vector<std::uint16_t>& cond_wick,
+                         const WickDatabase& db) {
+    for (std::size_t i = 0; i < evap_wick.size(); ++i) {
+        db.at(evap_wick[i]);
+        db.at(cond_wick[i]);
+    }
+}
+
+}  // namespace detail
+
+inline void evaluateBatch(const WickDesignBatch& in, const WickDatabase& db, OutputBatch<double>& out,
+                          const FluidProperties& fluid = FluidProperties{}) {
+    if (in.evap_wick.size() != in.size() || in.cond_wick.size() != in.size()) {
+        throw std::invalid_argument("evaluateBatch: one evaporator and condenser wick ID per lane required");
+    }
+    detail::checkWickIds(in.evap_wick, in.cond_wick, db);
+    out.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t i = begin; i < end; ++i) {
+            out.set(i, evaluateModel(in.get(i), db[in.evap_wick[i]], db[in.cond_wick[i]], fluid));
+        }
+    });
+}
+
+// Batch with a 16-bit evaporator and condenser wick ID per lane.
+inline void evaluateBatch(const DesignBatch<double>& in, const std::vector<std::uint16_t>& evap_wick,
+                          const std::vector<std::uint16_t>& cond_wick, const WickDatabase& db,
+                          OutputBatch<double>& out, const FluidProperties& fluid = FluidProperties{}) {
+    if (evap_wick.size() != in.size() || cond_wick.size() != in.size()) {
+        throw std::invalid_argument("evaluateBatch: one evaporator and condenser wick ID per lane required");
+    }
+    detail::checkWickIds(evap_wick, cond_wick, db);
+    out.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t i = begin; i < end; ++i) {
+            out.set(i, evaluateModel(in.get(i), db[evap_wick[i]], db[cond_wick[i]], fluid));
+        }
+    });
+}
+
+}  // namespace vc
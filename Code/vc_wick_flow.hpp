@@ -0,0 +1,146 @@
+#pragma once
+// 2D Darcy liquid return in the wick plane.
+//
+// Replaces the lumped L_eff / A_wick_evap liquid pressure drop with a
+// pressure field over the whole plate:
+//
+//     -div((K_evap t_evap_wick + K_cond t_cond_wick) / mu_l  grad P) = s(x, y)
+//
+// The two wicks are hydraulically in parallel (joined through the support
+// columns). s is the volumetric condensation rate over the condenser
+// footprint (plate minus heat source, as in A_cond) minus the evaporation rate
+// over the heat-source footprint, so the net source is zero and the plate
+// edges are closed. The liquid pressure drop is max(P) - min(P).
+//
+// P is linear in Q_in, so WickFlowSolver solves once for a 1 W load when it is
+// built and every later heat load is a scale of that field. Other source
+// shapes reuse the same multigrid hierarchy.
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "vc_model.hpp"
+#include "vc_multigrid.hpp"
+#include "vc_spreading.hpp"
+
+namespace vc {
+
+struct WickFlowOptions {
+    int nx = 128;   // Plate cells along vc_length (even, so multigrid can coarsen)
+    int ny = 128;
+    double tolerance = 1e-8;
+};
+
+class WickFlowSolver {
+public:
+    WickFlowSolver(const DesignInputs<double>& in, const ModelOutputs<double>& out,
+                   const FluidProperties& fluid = FluidProperties{}, const WickFlowOptions& opt = WickFlowOptions{})
+        : nx_(opt.nx),
+          ny_(opt.ny),
+          tolerance_(opt.tolerance),
+          rho_l_(fluid.rho_l),
+          h_fg_(fluid.h_fg),
+          mg_(opt.nx, opt.ny, in.vc_length / opt.nx, in.vc_width / opt.ny,
+              std::vector<double>(static_cast<std::size_t>(opt.nx) * opt.ny,
+                                  (out.K_evap * out.t_evap_wick + out.K_cond * out.t_cond_wick) / fluid.mu_l),
+              std::vector<double>(static_cast<std::size_t>(opt.nx) * opt.ny, 0.0)) {
+        const double cell_area = (in.vc_length / nx_) * (in.vc_width / ny_);
+        evap_cover_ = centeredFootprint(nx_, ny_, in.vc_length, in.vc_width, in.evap_length, in.evap_width);
+        double evap_area = 0;
+        double cond_area = 0;
+        for (double c : evap_cover_) {
+            evap_area += c * cell_area;
+            cond_area += (1 - c) * cell_area;
+        }
+        // Unit (1 W) source: volumetric evaporation/condensation rate per area
+        const double vol_rate = 1 / (rho_l_ * h_fg_);
+        std::vector<double> s(evap_cover_.size());
+        for (std::size_t k = 0; k < s.size(); ++k) {
+            s[k] = vol_rate * ((1 - evap_cover_[k]) / cond_area - evap_cover_[k] / evap_area);
+        }
+        cycles_ = mg_.solve(s, unit_pressure_, tolerance_);
+        unit_dP_ = spread(unit_pressure_);
+    }
+
+    int nx() const { return nx_; }
+    int ny() const { return ny_; }
+    int cycles() const { return cycles_; }
+
+    // Liquid pressure drop per watt [Pa/W]
+    double unitPressureDrop() const { return unit_dP_; }
+    double pressureDrop(double Q_in) const { return Q_in * unit_dP_; }
+
+    // Liquid pressure field for a centered heat load Q_in [Pa], relative to the plate mean
+    std::vector<double> pressureField(double Q_in) const {
+        std::vector<double> p(unit_pressure_);
+        for (double& v : p) {
+            v *= Q_in;
+        }
+        return p;
+    }
+
+    // Pressure drop for an arbitrary evaporation map (heat flux per area [W/m^2],
+    // row-major nx*ny); condensation balances it uniformly over the condenser footprint.
+    double pressureDropForHeatMap(const std::vector<double>& q_evap, std::vector<double>* field = nullptr) {
+        double Q = 0;
+        double cond_cells = 0;
+        for (std::size_t k = 0; k < q_evap.size(); ++k) {
+            Q += q_evap[k];
+            cond_cells += 1 - evap_cover_[k];
+        }
+        const double vol_rate = 1 / (rho_l_ * h_fg_);
+        std::vector<double> s(q_evap.size());
+        for (std::size_t k = 0; k < s.size(); ++k) {
+            // Mean flux Q/n spread over condenser cells, so the discrete source sums to zero
+            s[k] = vol_rate * (Q * (1 - evap_cover_[k]) / cond_cells - q_evap[k]);
+        }
+        std::vector<double> p;
+        mg_.solve(s, p, tolerance_);
+        const double dP = spread(p);
+        if (field) {
+            *field = std::move(p);
+        }
+        return dP;
+    }
+
+private:
+    static double spread(const std::vector<double>& p) {
+        const auto mm = std::minmax_element(p.begin(), p.end());
+        return *mm.second - *mm.first;
+    }
+
+    int nx_;
+    int ny_;
+    double tolerance_;
+    double rho_l_;
+    double h_fg_;
+    MultigridSolver mg_;
+    std::vector<double> evap_cover_;
+    std::vector<double> unit_pressure_;
+    double unit_dP_ = 0;
+    int cycles_ = 0;
+};
+
+// Capillary balance with the 2D liquid pressure drop in place of the lumped dP_l.
+inline ModelOutputs<double> applyWickFlow(const DesignInputs<double>& in, ModelOutputs<double> out,
+                                          const WickFlowSolver& wick,
+                                          const FluidProperties& fluid = FluidProperties{}) {
+    DesignInputs<double> unit = in;
+    unit.Q_in = 1;
+    const double vapor_pressure_term = evaluateModel(unit, fluid).dP_v;
+    out.dP_l = wick.pressureDrop(in.Q_in);
+    out.dP_total = out.dP_l + out.dP_v + out.dP_g;
+    out.Q_max = (out.dP_cap - out.dP_g) / (wick.unitPressureDrop() + vapor_pressure_term);
+    return out;
+}
+
+inline ModelOutputs<double> evaluateModelWithWickFlow(const DesignInputs<double>& in,
+                                                      const FluidProperties& fluid = FluidProperties{},
+                                                      const WickFlowOptions& opt = WickFlowOptions{}) {
+    const ModelOutputs<double> out = evaluateModel(in, fluid);
+    const WickFlowSolver wick(in, out, fluid, opt);
+    return applyWickFlow(in, out, wick, fluid);
+}
+
+}  // namespace vc
@@ -0,0 +1,215 @@
+#pragma once
+// Wick structures other than screen mesh, as compile-time policies.
+//
+// A wick policy turns its geometry into the five properties the model needs:
+// thickness, porosity, permeability, capillary radius and effective
+// conductivity. The screen-mesh policy takes its geometry from the design's
+// mesh / wire / layer inputs for that side; the others carry their geometry
+// as members, the same for every lane of a batch.
+//
+//   ScreenMeshWick       The correlations of vc_model.hpp: epsilon = 1 - pi N d / 4,
+//                        Kozeny-Carman K, rc = 1 / (2N), Maxwell k_wick.
+//   SinteredPowderWick   Packed spheres of diameter d_p: Blake-Kozeny
+//                        K = d_p^2 eps^3 / (150 (1 - eps)^2), rc = 0.21 d_p and
+//                        k_s (2 + k_l/k_s - 2 eps (1 - k_l/k_s)) / (2 + k_l/k_s + eps (1 - k_l/k_s))
+//                        (Chi, Heat Pipe Theory and Practice).
+//   AxialGrooveWick      Rectangular grooves of width w, depth delta and fin
+//                        width w_f, running along vc_length (the lumped flow
+//                        direction). eps = w / (w + w_f), rc = w and
+//                        K = 2 eps r_h^2 / (f Re), r_h = 2 w delta / (w + 2 delta),
+//                        with f Re of a closed w x 2 delta duct (Shah & London).
+//                        k_wick is Chi's fin-and-liquid groove conductance.
+//   CompositeWick        A screen (from the design inputs) laid over grooves.
+//                        Liquid flows in both layers in parallel, the screen
+//                        sets the meniscus, and heat crosses the layers in
+//                        series.
+//
+// evaluateModel(in, evap, cond) and evaluateBatch(in, out, evap, cond) are
+// templates on the (evaporator, condenser) policy pair, so each combination
+// compiles to its own loop with no per-lane dispatch. The batch runs the
+// policies on Lanes<kBatchLanes> packs, as evaluateBatchRange does. The
+// WickModel variant picks the pair at run time once per batch.
+//
+// evaluateModel(in, ScreenMeshWick{}, ScreenMeshWick{}) reproduces
+// evaluateModel(in) bit for bit.
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <variant>
+
+#include "vc_batch.hpp"
+#include "vc_model.hpp"
+#include "vc_parallel.hpp"
+
+namespace vc {
+
+template <class T>
+struct WickProperties {
+    T thickness;          // [m]
+    T porosity;
+    T permeability;       // [m^2]
+    T capillary_radius;   // [m]
+    T conductivity;       // [W/m-K]
+};
+
+// Screen spec of one side of a design.
+template <class T>
+struct ScreenSpec {
+    T mesh_number_wpi;
+    T d_w;
+    T num_layers;
+};
+
+template <class T>
+ScreenSpec<T> evaporatorScreen(const DesignInputs<T>& in) {
+    return {in.mesh_number_evap_wpi, in.d_w_evap, in.num_layers_evap};
+}
+
+template <class T>
+ScreenSpec<T> condenserScreen(const DesignInputs<T>& in) {
+    return {in.mesh_number_cond_wpi, in.d_w_cond, in.num_layers_cond};
+}
+
+// Chi's effective conductivity of sintered spheres of porosity epsilon.
+template <class T>
+T sinteredWickConductivity(double epsilon, const T& k_shell, double k_l) {
+    const T ratio = k_l / k_shell;
+    return k_shell * (2 + ratio - 2 * epsilon * (1 - ratio)) / (2 + ratio + epsilon * (1 - ratio));
+}
+
+// Base of every wick policy (selects the policy overloads below).
+struct WickPolicy {};
+
+template <class W>
+constexpr bool isWickPolicy = std::is_base_of<WickPolicy, W>::value;
+
+// --- Policies ---
+
+struct ScreenMeshWick : WickPolicy {
+    template <class T>
+    WickProperties<T> properties(const DesignInputs<T>& in, const ScreenSpec<T>& mesh, double k_l) const {
+        const T mesh_number = mesh.mesh_number_wpi / 0.0254;
+        WickProperties<T> w;
+        w.thickness = 2 * mesh.d_w * mesh.num_layers;
+        w.porosity = screenPorosity(mesh_number, mesh.d_w);
+        w.permeability = screenPermeability(mesh.d_w, w.porosity, in.kozeny_carman_constant);
+        w.capillary_radius = 1 / (2 * mesh_number);
+        w.conductivity = effectiveWickConductivity(w.porosity, in.k_shell, k_l);
+        return w;
+    }
+};
+
+struct SinteredPowderWick : WickPolicy {
+    double particle_diameter = 100e-6;   // [m]
+    double porosity = 0.5;
+    double thickness = 0.5e-3;           // [m]
+
+    template <class T>
+    WickProperties<T> properties(const DesignInputs<T>& in, const ScreenSpec<T>&, double k_l) const {
+        WickProperties<T> w;
+        w.thickness = T(thickness);
+        w.porosity = T(porosity);
+        w.permeability = T(sq(particle_diameter) * cube(porosity) / (150 * sq(1 - porosity)));
+        w.capillary_radius = T(0.21 * particle_diameter);
+        w.conductivity = sinteredWickConductivity(porosity, in.k_shell, k_l);
+        return w;
+    }
+};
+
+struct AxialGrooveWick : WickPolicy {
+    double groove_width = 0.2e-3;   // [m]
+    double groove_depth = 0.3e-3;   // [m]
+    double fin_width = 0.2e-3;      // [m]
+
+    // Fanning f Re of a rectangular duct of aspect ratio a <= 1 (Shah & London).
+    static double frictionFactorRe(double a) {
+        return 24 * (1 + a * (-1.3553 + a * (1.9467 + a * (-1.7012 + a * (0.9564 - a * 0.2537)))));
+    }
+
+    template <class T>
+    WickProperties<T> properties(const DesignInputs<T>& in, const ScreenSpec<T>&, double k_l) const {
+        const double w = groove_width;
+        const double delta = groove_depth;
+        const double w_f = fin_width;
+        // The free surface is a symmetry plane: the groove is half of a w x 2 delta duct
+        const double aspect = std::min(w, 2 * delta) / std::max(w, 2 * delta);
+        const double r_h = 2 * w * delta / (w + 2 * delta);
+        const double epsilon = w / (w + w_f);
+        const T fin = 0.185 * w_f * in.k_shell + delta * k_l;
+        WickProperties<T> p;
+        p.thickness = T(delta);
+        p.porosity = T(epsilon);
+        p.permeability = T(2 * epsilon * sq(r_h) / frictionFactorRe(aspect));
+        p.capillary_radius = T(w);
+        p.conductivity = (w_f * k_l * in.k_shell * delta + w * k_l * fin) / ((w + w_f) * fin);
+        return p;
+    }
+};
+
+struct CompositeWick : WickPolicy {
+    AxialGrooveWick grooves;
+    ScreenMeshWick screen;
+
+    template <class T>
+    WickProperties<T> properties(const DesignInputs<T>& in, const ScreenSpec<T>& mesh, double k_l) const {
+        const WickProperties<T> g = grooves.properties(in, mesh, k_l);
+        const WickProperties<T> s = screen.properties(in, mesh, k_l);
+        WickProperties<T> w;
+        w.thickness = g.thickness + s.thickness;
+        w.porosity = (g.porosity * g.thickness + s.porosity * s.thickness) / w.thickness;
+        w.permeability = (g.permeability * g.thickness + s.permeability * s.thickness) / w.thickness;
+        w.capillary_radius = s.capillary_radius;
+        w.conductivity = w.thickness / (g.thickness / g.conductivity + s.thickness / s.conductivity);
+        return w;
+    }
+};
+
+// --- Model and batch kernel ---
+
+template <class EvapWick, class CondWick, class T,
+          class = std::enable_if_t<isWickPolicy<EvapWick> && isWickPolicy<CondWick>>>
+ModelOutputs<T> evaluateModel(const DesignInputs<T>& in, const EvapWick& evap, const CondWick& cond,
+                              const FluidProperties& fluid = FluidProperties{}) {
+    const WickProperties<T> e = evap.properties(in, evaporatorScreen(in), fluid.k_l);
+    const WickProperties<T> c = cond.properties(in, condenserScreen(in), fluid.k_l);
+    ModelOutputs<T> out;
+    out.t_evap_wick = e.thickness;
+    out.t_cond_wick = c.thickness;
+    out.epsilon_evap = e.porosity;
+    out.epsilon_cond = c.porosity;
+    out.rc_eff = e.capillary_radius;
+    out.K_evap = e.permeability;
+    out.K_cond = c.permeability;
+    evaluateCapillaryLimit(in, out, fluid);
+    out.k_wick_evap = e.conductivity;
+    out.k_wick_cond = c.conductivity;
+    evaluateResistanceNetwork(in, out);
+    return out;
+}
+
+template <class EvapWick, class CondWick, class = std::enable_if_t<isWickPolicy<EvapWick> && isWickPolicy<CondWick>>>
+void evaluateBatch(const DesignBatch<double>& in, OutputBatch<double>& out, const EvapWick& evap, const CondWick& cond,
+                   const FluidProperties& fluid = FluidProperties{}) {
+    out.resize(in.size());
+    parallelFor(in.size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        std::size_t i = begin;
+        for (; i + kBatchLanes <= end; i += kBatchLanes) {
+            const DesignInputs<Lanes<kBatchLanes>> d = detail::loadDesignLanes<kBatchLanes>(in, i);
+            detail::storeOutputLanes(evaluateModel(d, evap, cond, fluid), out, i);
+        }
+        for (; i < end; ++i) {
+            out.set(i, evaluateModel(in.get(i), evap, cond, fluid));
+        }
+    });
+}
+
+// Wick type chosen at run time; dispatched once per batch.
+using WickModel = std::variant<ScreenMeshWick, SinteredPowderWick, AxialGrooveWick, CompositeWick>;
+
+inline void evaluateBatch(const DesignBatch<double>& in, OutputBatch<double>& out, const WickModel& evap,
+                          const WickModel& cond, const FluidProperties& fluid = FluidProperties{}) {
+    std::visit([&](const auto& e, const auto& c) { evaluateBatch(in, out, e, c, fluid); }, evap, cond);
+}
+
+}  // namespace vc